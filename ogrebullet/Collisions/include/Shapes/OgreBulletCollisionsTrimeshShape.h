@@ -47,6 +47,9 @@ namespace OgreBulletCollisions
 		virtual ~TriangleMeshCollisionShape();
 		void AddTriangle(Ogre::Vector3 &vertex1, Ogre::Vector3 &vertex2, Ogre::Vector3 &vertex3);
 		void Finish();
+		bool Finish(const void *bvh_data, unsigned int bvh_size);
+		unsigned int GetSerializedSize() const;
+		bool Serialize(void *buffer, unsigned int size) const;
 
 		bool drawWireFrame(DebugLines *wire, 
 			const Ogre::Vector3 &pos = Ogre::Vector3::ZERO, 
@@ -54,6 +57,7 @@ namespace OgreBulletCollisions
 
     private:
         btTriangleMesh*         mTriMesh;
+        void*                   mBvhData; //aligned copy of a serialized BVH used by the shape, if loaded
     };
 }
 #endif //_OGREBULLETCOLLISIONS_TrimeshShape_H
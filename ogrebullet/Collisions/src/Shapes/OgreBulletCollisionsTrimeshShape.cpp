@@ -49,7 +49,8 @@ namespace OgreBulletCollisions
         unsigned int indexCount,
 		bool use32bitsIndices) :	
         CollisionShape(),
-        mTriMesh(0)
+        mTriMesh(0),
+        mBvhData(0)
     {
 		unsigned int numFaces = indexCount / 3;
 
@@ -98,7 +99,8 @@ namespace OgreBulletCollisions
         unsigned int indexCount, 
 		bool use32bitsIndices) :	
         CollisionShape(),
-        mTriMesh(0)
+        mTriMesh(0),
+        mBvhData(0)
     {
 		mTriMesh = new btTriangleMesh(use32bitsIndices);
 		mTriMesh->preallocateVertices(vertexCount);
@@ -136,6 +138,51 @@ namespace OgreBulletCollisions
 	        mShape = trishape;
 	}
 
+	//finalize collider using a BVH previously saved with Serialize(), instead of building it
+	//returns false if the data can't be used, in which case Finish() should be called instead
+	bool TriangleMeshCollisionShape::Finish(const void *bvh_data, unsigned int bvh_size)
+	{
+		if (!bvh_data || bvh_size == 0 || mShape)
+			return false;
+
+		//the BVH is used in place, so keep an aligned copy for the lifetime of the shape
+		void *buffer = btAlignedAlloc(bvh_size, 16);
+		memcpy(buffer, bvh_data, bvh_size);
+
+		btOptimizedBvh *bvh = btOptimizedBvh::deSerializeInPlace(buffer, bvh_size, false);
+		if (!bvh || bvh->isQuantized() == false)
+		{
+			btAlignedFree(buffer);
+			return false;
+		}
+
+		btBvhTriangleMeshShape *trishape = new btBvhTriangleMeshShape(mTriMesh, true, false);
+		trishape->setOptimizedBvh(bvh);
+		mShape = trishape;
+		mBvhData = buffer;
+		return true;
+	}
+
+	//get the buffer size needed to serialize the finished shape's BVH
+	unsigned int TriangleMeshCollisionShape::GetSerializedSize() const
+	{
+		btBvhTriangleMeshShape *trishape = static_cast<btBvhTriangleMeshShape*>(mShape);
+		if (!trishape || !trishape->getOptimizedBvh())
+			return 0;
+
+		return trishape->getOptimizedBvh()->calculateSerializeBufferSize();
+	}
+
+	//serialize the finished shape's BVH into a 16-byte aligned buffer
+	bool TriangleMeshCollisionShape::Serialize(void *buffer, unsigned int size) const
+	{
+		btBvhTriangleMeshShape *trishape = static_cast<btBvhTriangleMeshShape*>(mShape);
+		if (!trishape || !trishape->getOptimizedBvh() || !buffer)
+			return false;
+
+		return trishape->getOptimizedBvh()->serializeInPlace(buffer, size, false);
+	}
+
 	// -------------------------------------------------------------------------
     TriangleMeshCollisionShape::~TriangleMeshCollisionShape()
     {
@@ -144,6 +191,15 @@ namespace OgreBulletCollisions
             delete mTriMesh;
         }
         mTriMesh = 0;
+
+        //free the shape first, since it uses the loaded BVH
+        if (mBvhData)
+        {
+            delete mShape;
+            mShape = 0;
+            btAlignedFree(mBvhData);
+        }
+        mBvhData = 0;
     }
     // -------------------------------------------------------------------------
 	bool TriangleMeshCollisionShape::drawWireFrame(DebugLines *wire, 
@@ -0,0 +1,543 @@
+/*
+	Skyscraper 2.1 - Headless Simulation Benchmark
+	Copyright (C)2003-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+//sbs-bench: loads a building without a render window, runs people and elevator dispatch
+//for a number of simulated hours on a fixed timestep, and reports the simulation rate
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include "globals.h"
+#include "sbs.h"
+#include "vm.h"
+#include "hal.h"
+#include "enginecontext.h"
+#include "person.h"
+#include "scriptproc.h"
+#include "manager.h"
+#include "controller.h"
+#include "dispatch.h"
+#include "crowd.h"
+#include "floor.h"
+#include "elevator.h"
+#include "elevatorcar.h"
+#include "callstation.h"
+#include "action.h"
+#include "legacyaction.h"
+
+using namespace SBS;
+using namespace Skyscraper;
+
+typedef std::chrono::steady_clock Clock;
+
+static void Usage()
+{
+	printf("Usage: sbs-bench [options] <building file>\n");
+	printf("  --hours <n>     simulated hours to run (default 1)\n");
+	printf("  --people <n>    number of people with random activity (default 50)\n");
+	printf("  --agents <n>    number of crowd agents with random activity (default 0)\n");
+	printf("  --step <secs>   fixed timestep per frame, up to 0.5 (default 0.1)\n");
+	printf("  --dispatch <p>  dispatch policy for all controllers (Nearest or TimeToServe)\n");
+	printf("  --calc <n>      run n passes of the script math benchmark instead of the simulation\n");
+	printf("  --actions <n>   run n passes of the action dispatch benchmark instead of the simulation\n");
+}
+
+static Real Seconds(const Clock::time_point &start)
+{
+	return std::chrono::duration<Real>(Clock::now() - start).count();
+}
+
+static void GetExpressions(std::vector<std::string> *data, std::vector<std::string> &expressions, size_t &math)
+{
+	//collect command parameters from the loaded building script, as passed to ScriptProcessor::Calc
+
+	math = 0;
+
+	for (size_t i = 0; i < data->size(); i++)
+	{
+		std::string line = data->at(i);
+
+		//strip comments
+		size_t marker = line.find("#");
+		if (marker != std::string::npos)
+			line.erase(marker);
+		TrimString(line);
+
+		//skip tags, and lines with variables that are only expanded at runtime
+		if (line == "" || line[0] == '<' || line.find("%") != std::string::npos)
+			continue;
+
+		//get parameters after the equals sign or command name
+		size_t start = line.find("=");
+		if (start == std::string::npos)
+			start = line.find(" ");
+		if (start == std::string::npos)
+			continue;
+
+		std::vector<std::string> params;
+		SplitString(params, line.substr(start + 1), ',');
+
+		for (size_t j = 0; j < params.size(); j++)
+		{
+			std::string &param = params[j];
+			TrimString(param);
+
+			//skip unbalanced parenthesis, which report script errors
+			if (std::count(param.begin(), param.end(), '(') != std::count(param.begin(), param.end(), ')'))
+				continue;
+
+			if (param.find_first_of("+-*/^(", 1) != std::string::npos)
+				math++;
+			expressions.emplace_back(param);
+		}
+	}
+}
+
+static int RunCalcBenchmark(ScriptProcessor *processor, int passes)
+{
+	//compare the expression evaluator in ScriptProcessor::Calc against the string-based calculation
+
+	std::vector<std::string> expressions;
+	size_t math;
+	GetExpressions(processor->GetBuildingData(), expressions, math);
+
+	if (expressions.empty())
+	{
+		printf("No expressions found\n");
+		return 1;
+	}
+
+	printf("\nCalculating %d passes of %d parameters (%d with math operations)...\n", passes, (int)expressions.size(), (int)math);
+
+	//verify results
+	int mismatches = 0;
+	for (size_t i = 0; i < expressions.size(); i++)
+	{
+		std::string result = processor->Calc(expressions[i]);
+		std::string legacy = processor->CalcLegacy(expressions[i]);
+		if (result != legacy)
+		{
+			if (mismatches < 10)
+				printf("  mismatch: '%s' = '%s', legacy '%s'\n", expressions[i].c_str(), result.c_str(), legacy.c_str());
+			mismatches++;
+		}
+	}
+
+	size_t checksum = 0;
+
+	Clock::time_point start = Clock::now();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (size_t i = 0; i < expressions.size(); i++)
+			checksum += processor->Calc(expressions[i]).size();
+	}
+	Real calc_time = Seconds(start);
+
+	start = Clock::now();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (size_t i = 0; i < expressions.size(); i++)
+			checksum += processor->CalcLegacy(expressions[i]).size();
+	}
+	Real legacy_time = Seconds(start);
+
+	Real count = Real(expressions.size()) * passes;
+
+	//report results
+	printf("\nCalc:                %.2f s (%.1f ns per call)\n", (double)calc_time, (double)(calc_time / count * 1e9));
+	printf("CalcLegacy:          %.2f s (%.1f ns per call)\n", (double)legacy_time, (double)(legacy_time / count * 1e9));
+	if (calc_time > 0)
+		printf("Speedup:             %.2fx\n", (double)(legacy_time / calc_time));
+	printf("Mismatches:          %d\n", mismatches);
+	printf("Checksum:            %lu\n", (unsigned long)checksum);
+
+	return (mismatches > 0) ? 1 : 0;
+}
+
+struct BenchAction
+{
+	Action *action;
+	Object *parent;
+};
+
+static void AddBenchAction(::SBS::SBS *Simcore, std::vector<BenchAction> &actions, Object *parent, const std::string &command)
+{
+	//create an action on a single parent object
+
+	std::vector<Object*> parents;
+	parents.emplace_back(parent);
+
+	BenchAction entry;
+	entry.action = new Action(Simcore, "Benchmark " + command, parents, command);
+	entry.parent = parent;
+	actions.emplace_back(entry);
+}
+
+static int RunActionBenchmark(::SBS::SBS *Simcore, int passes)
+{
+	//compare the resolved action dispatch in Action::DoAction against a copy of the string-based dispatch
+
+	//actions run on the building's elevators, elevator cars and call stations, with commands that
+	//leave the simulation unchanged: fan and interlock commands that set the current state, and "off"
+	std::vector<BenchAction> actions;
+
+	for (int i = 1; i <= Simcore->GetElevatorCount(); i++)
+	{
+		Elevator *elevator = Simcore->GetElevator(i);
+		if (!elevator)
+			continue;
+
+		std::string interlocks = (elevator->Interlocks == true) ? "interlockson" : "interlocksoff";
+		AddBenchAction(Simcore, actions, elevator, interlocks);
+		AddBenchAction(Simcore, actions, elevator, "off");
+
+		for (int j = 1; j <= elevator->GetCarCount(); j++)
+		{
+			ElevatorCar *car = elevator->GetCar(j);
+			if (!car)
+				continue;
+
+			std::string fan = (car->Fan == true) ? "fanon" : "fanoff";
+			AddBenchAction(Simcore, actions, car, fan);
+		}
+	}
+
+	for (int i = -Simcore->Basements; i < Simcore->Floors; i++)
+	{
+		Floor *floor = Simcore->GetFloor(i);
+		if (!floor)
+			continue;
+
+		for (int j = 0; j < floor->GetCallStationCount(); j++)
+		{
+			if (floor->CallStationArray[j])
+				AddBenchAction(Simcore, actions, floor->CallStationArray[j], "off");
+		}
+	}
+
+	if (actions.empty())
+	{
+		printf("No elevators or call stations found\n");
+		return 1;
+	}
+
+	printf("\nRunning %d passes of %d actions...\n", passes, (int)actions.size());
+
+	//hold logging equal, since both dispatch paths only report actions in verbose mode
+	bool verbose = Simcore->Verbose;
+	Simcore->Verbose = false;
+
+	bool hold = false;
+
+	//verify results
+	int mismatches = 0;
+	for (size_t i = 0; i < actions.size(); i++)
+	{
+		bool result = actions[i].action->DoAction(Simcore, hold);
+		bool legacy = RunLegacyAction(Simcore, actions[i].action, Simcore, actions[i].parent, hold);
+		if (result != legacy)
+		{
+			if (mismatches < 10)
+				printf("  mismatch: '%s' on '%s' = %d, legacy %d\n", actions[i].action->GetCommandName().c_str(), actions[i].parent->GetName().c_str(), (int)result, (int)legacy);
+			mismatches++;
+		}
+	}
+
+	size_t checksum = 0;
+
+	Clock::time_point start = Clock::now();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (size_t i = 0; i < actions.size(); i++)
+			checksum += actions[i].action->DoAction(Simcore, hold);
+	}
+	Real action_time = Seconds(start);
+
+	start = Clock::now();
+	for (int pass = 0; pass < passes; pass++)
+	{
+		for (size_t i = 0; i < actions.size(); i++)
+			checksum += RunLegacyAction(Simcore, actions[i].action, Simcore, actions[i].parent, hold);
+	}
+	Real legacy_time = Seconds(start);
+
+	Simcore->Verbose = verbose;
+
+	Real count = Real(actions.size()) * passes;
+
+	//report results
+	printf("\nDoAction:            %.2f s (%.1f ns per call)\n", (double)action_time, (double)(action_time / count * 1e9));
+	printf("Legacy dispatch:     %.2f s (%.1f ns per call)\n", (double)legacy_time, (double)(legacy_time / count * 1e9));
+	if (action_time > 0)
+		printf("Speedup:             %.2fx\n", (double)(legacy_time / action_time));
+	printf("Mismatches:          %d\n", mismatches);
+	printf("Checksum:            %lu\n", (unsigned long)checksum);
+
+	for (size_t i = 0; i < actions.size(); i++)
+		delete actions[i].action;
+
+	return (mismatches > 0) ? 1 : 0;
+}
+
+int main (int argc, char* argv[])
+{
+	std::string filename;
+	Real hours = 1;
+	int people = 50;
+	int agents = 0;
+	Real step = 0.1;
+	int calc_passes = 0;
+	int action_passes = 0;
+	std::string policy;
+
+	//parse command line
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--hours" && i + 1 < argc)
+			hours = atof(argv[++i]);
+		else if (arg == "--people" && i + 1 < argc)
+			people = atoi(argv[++i]);
+		else if (arg == "--agents" && i + 1 < argc)
+			agents = atoi(argv[++i]);
+		else if (arg == "--step" && i + 1 < argc)
+			step = atof(argv[++i]);
+		else if (arg == "--dispatch" && i + 1 < argc)
+			policy = argv[++i];
+		else if (arg == "--calc" && i + 1 < argc)
+			calc_passes = atoi(argv[++i]);
+		else if (arg == "--actions" && i + 1 < argc)
+			action_passes = atoi(argv[++i]);
+		else if (arg == "--help" || arg == "-h")
+		{
+			Usage();
+			return 0;
+		}
+		else
+			filename = arg;
+	}
+
+	if (filename == "" || hours <= 0 || people < 0 || agents < 0)
+	{
+		Usage();
+		return 1;
+	}
+
+	//SBS::Loop limits each frame to half a second of simulation
+	if (step <= 0 || step > 0.5)
+	{
+		printf("Error: timestep must be greater than 0 and no more than 0.5 seconds\n");
+		return 1;
+	}
+
+	//set locale to default for conversion functions
+	setlocale(LC_ALL, "C");
+
+	//create VM instance, without a render window or GUI
+	VM *vm = new VM();
+	vm->Headless = true;
+
+	HAL *hal = vm->GetHAL();
+	hal->LoadConfiguration(vm->data_path, false);
+
+	if (!hal->Initialize(vm->data_path))
+	{
+		printf("Error initializing HAL\n");
+		delete vm;
+		return 1;
+	}
+
+	if (!hal->LoadSystem(vm->data_path, 0))
+	{
+		printf("Error loading system\n");
+		delete vm;
+		return 1;
+	}
+
+	vm->ShowPlatform();
+
+	//load building
+	Clock::time_point load_start = Clock::now();
+	if (!vm->Load(false, true, filename))
+	{
+		printf("Error loading building '%s'\n", filename.c_str());
+		delete vm;
+		return 1;
+	}
+
+	EngineContext *engine = 0;
+	while (!engine)
+	{
+		std::vector<EngineContext*> newengines;
+		VMStatus status = vm->Run(newengines);
+
+		if (status == VMSTATUS_LOAD)
+		{
+			for (size_t i = 0; i < newengines.size(); i++)
+			{
+				if (vm->StartEngine(newengines[i]) == true && !engine)
+					engine = newengines[i];
+			}
+		}
+
+		if (status == VMSTATUS_UNLOAD || status == VMSTATUS_FATAL || vm->GetEngineCount() == 0)
+		{
+			printf("Error loading building '%s'\n", filename.c_str());
+			delete vm;
+			return 1;
+		}
+	}
+	Real load_time = Seconds(load_start);
+
+	//run script math benchmark if requested
+	if (calc_passes > 0)
+	{
+		int result = RunCalcBenchmark(engine->GetScriptProcessor(), calc_passes);
+		delete vm;
+		return result;
+	}
+
+	::SBS::SBS *Simcore = engine->GetSystem();
+
+	//run action dispatch benchmark if requested
+	if (action_passes > 0)
+	{
+		int result = RunActionBenchmark(Simcore, action_passes);
+		delete vm;
+		return result;
+	}
+
+	//switch to the fixed timestep
+	Simcore->FixedStep = step;
+
+	//set dispatch policies, and start dispatch statistics
+	ControllerManager *controllers = Simcore->GetControllerManager();
+	for (int i = 0; i < controllers->GetCount(); i++)
+	{
+		DispatchController *controller = controllers->GetIndex(i);
+
+		if (policy != "" && controller->SetPolicy(policy) == false)
+		{
+			printf("Error: invalid dispatch policy '%s'\n", policy.c_str());
+			delete vm;
+			return 1;
+		}
+		controller->ResetStatistics();
+	}
+
+	//create people, and start their random activity
+	for (int i = 0; i < people; i++)
+	{
+		Person *person = Simcore->CreatePerson("Bench " + ToString(i + 1), Simcore->Lobby, false);
+		if (person)
+			person->EnableRandomActivity(true);
+	}
+
+	//create crowd agents
+	Crowd *crowd = Simcore->GetCrowd();
+	crowd->AddAgents(agents, Simcore->Lobby, false);
+	crowd->ResetStatistics();
+
+	printf("\nRunning %g simulated hours with %d people and %d agents on %d floors (%g second timestep)...\n", (double)hours, people, agents, Simcore->GetTotalFloors(), (double)step);
+
+	//run simulation
+	unsigned long start_time = Simcore->GetRunTime();
+	unsigned long end_time = start_time + (unsigned long)(hours * 3600000);
+	unsigned long frames = 0;
+	int last_hour = 0;
+	Clock::time_point run_start = Clock::now();
+
+	while (Simcore->GetRunTime() < end_time)
+	{
+		std::vector<EngineContext*> newengines;
+		VMStatus status = vm->Run(newengines);
+
+		if (status == VMSTATUS_UNLOAD || status == VMSTATUS_FATAL || vm->IsValidSystem(Simcore) == false)
+		{
+			printf("Simulation stopped unexpectedly\n");
+			delete vm;
+			return 1;
+		}
+		frames++;
+
+		//report progress every simulated hour
+		int hour = (int)((Simcore->GetRunTime() - start_time) / 3600000);
+		if (hour > last_hour)
+		{
+			last_hour = hour;
+			printf("  hour %d: %.1f wall seconds\n", hour, (double)Seconds(run_start));
+		}
+	}
+
+	Real wall_time = Seconds(run_start);
+	Real sim_time = Real(Simcore->GetRunTime() - start_time) / 1000.0;
+
+	//report results
+	printf("\nBuilding:            %s\n", filename.c_str());
+	printf("Load time:           %.2f s\n", (double)load_time);
+	printf("Frames:              %lu\n", frames);
+	printf("Simulated time:      %.1f s\n", (double)sim_time);
+	printf("Wall time:           %.2f s\n", (double)wall_time);
+	if (wall_time > 0)
+	{
+		printf("Sim seconds/second:  %.1f\n", (double)(sim_time / wall_time));
+		printf("Frames/second:       %.1f\n", (double)(frames / wall_time));
+	}
+
+	//report dispatch statistics
+	for (int i = 0; i < controllers->GetCount(); i++)
+	{
+		DispatchController *controller = controllers->GetIndex(i);
+		DispatchController::Statistics stats;
+		controller->GetStatistics(stats);
+
+		Real average = (stats.passengers > 0) ? stats.total_wait / stats.passengers : 0;
+		Real per_hour = (stats.elapsed > 0) ? stats.passengers / stats.elapsed * 3600 : 0;
+
+		printf("\nDispatch controller %d (%s):\n", controller->Number, controller->GetPolicy()->GetName().c_str());
+		printf("  Routes served:     %d\n", stats.routes);
+		printf("  Passengers:        %d (%.1f per hour)\n", stats.passengers, (double)per_hour);
+		printf("  Average wait:      %.1f s\n", (double)average);
+		printf("  Longest wait:      %.1f s\n", (double)stats.max_wait);
+	}
+
+	//report crowd statistics
+	if (agents > 0)
+	{
+		Crowd::Statistics stats;
+		crowd->GetStatistics(stats);
+
+		Real average = (stats.trips > 0) ? stats.total_time / stats.trips : 0;
+
+		printf("\nCrowd:\n");
+		printf("  Agents:            %d (%d on a trip)\n", stats.agents, stats.active);
+		printf("  Trips completed:   %d\n", stats.trips);
+		printf("  Trips abandoned:   %d\n", stats.failed);
+		printf("  Average trip:      %.1f s\n", (double)average);
+		printf("  Longest trip:      %.1f s\n", (double)stats.max_time);
+	}
+
+	delete vm;
+	return 0;
+}
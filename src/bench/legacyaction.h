@@ -0,0 +1,33 @@
+/*
+	Skyscraper 2.1 - Legacy Action Dispatch
+	Copyright (C)2003-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef LEGACYACTION_H
+#define LEGACYACTION_H
+
+namespace Skyscraper {
+
+//string-based action dispatch, used by sbs-bench to compare against Action::DoAction
+bool RunLegacyAction(::SBS::SBS *sbs, ::SBS::Action *action, ::SBS::Object *caller, ::SBS::Object *parent, bool &hold);
+
+}
+
+#endif
@@ -389,6 +389,7 @@ bool Skyscraper::Loop()
 {
 	//Main simulator loop
 
+	ProfileTrace::End_Frame();
 	ProfileManager::Reset();
 	ProfileManager::Increment_Frame_Counter();
 
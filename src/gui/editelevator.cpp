@@ -1955,7 +1955,7 @@ void editelevator::On_bDoorSensor_Click(wxCommandEvent& event)
 void editelevator::On_bSetType_Click(wxCommandEvent& event)
 {
 	if (elevator)
-		elevator->Type = txtType->GetValue();
+		elevator->SetType(txtType->GetValue().ToStdString());
 }
 
 void editelevator::On_bSetUpSpeed_Click(wxCommandEvent& event)
@@ -83,6 +83,10 @@ void GUI::Unload()
 
 void GUI::ShowError(const std::string &message)
 {
+	//errors are only logged in headless mode
+	if (vm->Headless == true)
+		return;
+
 	//show error dialog
 	wxMessageDialog dialog(0, message, _("Skyscraper"), wxOK | wxICON_ERROR);
 	dialog.ShowModal();
@@ -90,6 +94,9 @@ void GUI::ShowError(const std::string &message)
 
 void GUI::ShowMessage(const std::string &message)
 {
+	if (vm->Headless == true)
+		return;
+
 	//show message dialog
 	wxMessageDialog dialog(0, message, _("Skyscraper"), wxOK | wxICON_INFORMATION);
 	dialog.ShowModal();
@@ -309,6 +316,9 @@ void GUI::RefreshConsole()
 
 void GUI::RaiseWindow()
 {
+	if (!vm->GetParent())
+		return;
+
 	vm->GetParent()->Raise();
     vm->GetParent()->SetFocus();
 }
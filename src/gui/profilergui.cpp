@@ -100,6 +100,8 @@ void Profiler::Loop()
 		if (chkCapture->GetValue() == true)
 		{
 			SBS::ProfileManager::dumpAll(output);
+			output.append("\n");
+			SBS::ProfileTrace::Get_Summary(output);
 			txtMain->SetValue(output);
 		}
 	}
@@ -21,6 +21,7 @@
 	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <algorithm>
 #include "globals.h"
 #include "sbs.h"
 #include "elevator.h"
@@ -30,6 +31,7 @@
 #include "profiler.h"
 #include "utility.h"
 #include "controller.h"
+#include "dispatch.h"
 
 namespace SBS {
 
@@ -46,9 +48,12 @@ DispatchController::DispatchController(Object *parent, int number) : Object(pare
 	MaxPassengers = 5;
 	Hybrid = false;
 	Reprocess = false;
+	ReassignInterval = 100;
 	bottom_floor = 0;
 	top_floor = 0;
 	recheck = 0;
+	policy = new NearestPolicy(this);
+	ResetStatistics();
 
 	EnableLoop(true);
 
@@ -57,6 +62,10 @@ DispatchController::DispatchController(Object *parent, int number) : Object(pare
 
 DispatchController::~DispatchController()
 {
+	if (policy)
+		delete policy;
+	policy = 0;
+
 	//unregister from parent
 	if (sbs->FastDelete == false && parent_deleting == false)
 		sbs->RemoveController(this);
@@ -70,6 +79,14 @@ bool DispatchController::Loop()
 	if (sbs->GetPower() == false)
 		return true;
 
+	//re-cost pending standard routes every ReassignInterval steps
+	recheck++;
+	if (ReassignInterval > 0 && recheck >= ReassignInterval)
+	{
+		recheck = 0;
+		ReassignRoutes();
+	}
+
 	//process pending requests
 	ProcessRoutes();
 
@@ -144,6 +161,7 @@ void DispatchController::CheckArrivals()
 							//remove route from table
 							if (result == true)
 							{
+								RecordArrival(Routes[j]);
 								RemoveRoute(Routes[j]);
 								j--;
 							}
@@ -166,6 +184,7 @@ void DispatchController::CheckArrivals()
 							}
 
 							//remove route from table
+							RecordArrival(Routes[j]);
 							RemoveRoute(Routes[j]);
 							j--;
 						}
@@ -297,6 +316,7 @@ bool DispatchController::RequestRoute(CallStation *station, int starting_floor,
 	route.assigned_elevator = 0;
 	route.direction = 0;
 	route.destination = true;
+	route.time = sbs->GetRunTime();
 	Report("Adding destination route " + ToString((int)Routes.size()) + " from floor " + ToString(starting_floor) + " to floor " + ToString(destination_floor));
 	Routes.emplace_back(route);
 
@@ -386,6 +406,7 @@ bool DispatchController::CallElevator(CallStation *station, bool direction)
 	route.assigned_elevator = 0;
 	route.direction = dir;
 	route.destination = false;
+	route.time = sbs->GetRunTime();
 	Report("Adding standard route " + ToString((int)Routes.size()) + " to floor " + ToString(floor));
 	Routes.emplace_back(route);
 
@@ -420,53 +441,7 @@ void DispatchController::ProcessRoutes()
 				}
 			}
 			else
-			{
-				//if destination dispatch is off, check to see if there's a closer elevator
-				if (Routes[i].destination == false)
-				{
-					recheck++;
-					if (recheck == 100) //don't recheck elevator every frame
-					{
-						recheck = 0;
-						int closest = -1;
-						bool busy = false;
-						closest = FindClosestElevator(busy, false, Routes[i].starting_floor, 0, Routes[i].direction);
-
-						if (closest >= 0)
-						{
-							//if a closer elevator has been found than the elevator actively serving the call,
-							//reprocess the call
-							if (Elevators[closest].number != Routes[i].assigned_elevator && busy == false)
-							{
-								//make sure elevator is idle before continuing
-								Elevator *newelevator = sbs->GetElevator(Elevators[closest].number);
-								if (newelevator->IsIdle() == true)
-								{
-									Elevator *elevator = sbs->GetElevator(Routes[i].assigned_elevator);
-									if (elevator)
-										elevator->CancelHallCall(Routes[i].starting_floor, Routes[i].direction);
-
-									Report("Switching to closer elevator " + ToString(newelevator->Number));
-
-									//unassign elevator
-									Routes[i].assigned_elevator = 0;
-
-									//reset processed state
-									Routes[i].processed = false;
-								}
-							}
-							else
-								continue; //skip route if elevator is still closest
-						}
-						else
-							continue; //skip if a closer elevator is not found
-					}
-					else
-						continue; //skip route if not checking
-				}
-				else
-					continue; //skip route if elevator is still available
-			}
+				continue; //skip route if elevator is still available
 		}
 
 		int starting_floor = Routes[i].starting_floor;
@@ -587,6 +562,107 @@ void DispatchController::ProcessRoutes()
 	}
 }
 
+void DispatchController::ReassignRoutes()
+{
+	//re-cost all pending standard routes through the dispatch policy as a batch, and move routes
+	//to idle elevators that the policy rates lower than the assigned elevator
+	//each idle elevator takes at most one route per batch, and the largest savings are assigned first
+	//destination dispatch routes are not reassigned, since the passenger has already been shown an elevator
+
+	SBS_PROFILE("DispatchController::ReassignRoutes");
+
+	//only run if power is enabled
+	if (sbs->GetPower() == false)
+		return;
+
+	struct Candidate
+	{
+		size_t route;
+		size_t elevator; //index in the elevator table
+		Real saving; //cost reduction from switching elevators
+	};
+
+	std::vector<Candidate> candidates;
+
+	for (size_t i = 0; i < Routes.size(); i++)
+	{
+		Route &route = Routes[i];
+
+		if (route.processed == false || route.destination == true || route.assigned_elevator == 0)
+			continue;
+
+		Elevator *current = sbs->GetElevator(route.assigned_elevator);
+		if (!current)
+			continue;
+
+		ElevatorCar *current_car = current->GetCarForFloor(route.starting_floor);
+		if (!current_car)
+			continue;
+
+		Real cost = policy->GetCost(current, current_car, route.starting_floor, route.destination_floor, route.direction);
+
+		for (size_t j = 0; j < Elevators.size(); j++)
+		{
+			if (Elevators[j].number == route.assigned_elevator)
+				continue;
+
+			Elevator *elevator = sbs->GetElevator(Elevators[j].number);
+			if (!elevator || elevator->IsIdle() == false)
+				continue;
+
+			ElevatorCar *car = elevator->GetCarForFloor(route.starting_floor);
+			if (!car)
+				continue;
+
+			if (elevator->AvailableForCall(false, route.starting_floor, route.direction, false) != STATUS_AVAILABLE)
+				continue;
+
+			Real new_cost = policy->GetCost(elevator, car, route.starting_floor, route.destination_floor, route.direction);
+			if (new_cost < cost)
+			{
+				Candidate candidate;
+				candidate.route = i;
+				candidate.elevator = j;
+				candidate.saving = cost - new_cost;
+				candidates.emplace_back(candidate);
+			}
+		}
+	}
+
+	if (candidates.empty() == true)
+		return;
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) { return a.saving > b.saving; });
+
+	std::vector<bool> route_used (Routes.size(), false);
+	std::vector<bool> elevator_used (Elevators.size(), false);
+
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		const Candidate &candidate = candidates[i];
+		if (route_used[candidate.route] == true || elevator_used[candidate.elevator] == true)
+			continue;
+
+		route_used[candidate.route] = true;
+		elevator_used[candidate.elevator] = true;
+
+		Route &route = Routes[candidate.route];
+		int number = Elevators[candidate.elevator].number;
+
+		//cancel the call on the previously assigned elevator
+		Elevator *elevator = sbs->GetElevator(route.assigned_elevator);
+		if (elevator)
+			elevator->CancelHallCall(route.starting_floor, route.direction);
+
+		Report("Switching route " + ToString((int)candidate.route) + " from elevator " + ToString(route.assigned_elevator) + " to elevator " + ToString(number));
+
+		//assign the new elevator; the route is dispatched by ProcessRoutes
+		AssignElevator(number, route.destination_floor, route.direction);
+		route.assigned_elevator = number;
+		route.processed = false;
+	}
+}
+
 bool DispatchController::AddElevator(int elevator)
 {
 	//add an elevator to this controller
@@ -712,7 +788,7 @@ int DispatchController::FindClosestElevator(bool &busy, bool destination, int st
 		return -1;
 
 	//initialize values
-	int closest = 0;
+	Real closest = 0;
 	int closest_busy = -1;
 	int closest_notbusy = -1;
 	bool check = false;
@@ -767,8 +843,11 @@ int DispatchController::FindClosestElevator(bool &busy, bool destination, int st
 					}
 				}
 
+				//get cost of serving the call from the dispatch policy
+				Real cost = policy->GetCost(elevator, car, starting_floor, destination_floor, direction);
+
 				//if elevator is closer than the previously checked one or we're starting the checks
-				if (abs(car->GetFloor() - starting_floor) < closest || check == false || closest_busy >= 0)
+				if (cost < closest || check == false || closest_busy >= 0)
 				{
 					//see if elevator is available for the call
 					ElevatorStatus result = elevator->AvailableForCall(destination, starting_floor, direction, true);
@@ -798,7 +877,7 @@ int DispatchController::FindClosestElevator(bool &busy, bool destination, int st
 						{
 							if (sbs->Verbose && count > 1)
 								Report("Marking - closest so far as busy");
-							closest = abs(car->GetFloor() - starting_floor);
+							closest = cost;
 							closest_busy = i;
 						}
 						else
@@ -806,7 +885,7 @@ int DispatchController::FindClosestElevator(bool &busy, bool destination, int st
 							//mark as closest elevator
 							if (sbs->Verbose && count > 1)
 								Report("Marking - closest so far");
-							closest = abs(car->GetFloor() - starting_floor);
+							closest = cost;
 							closest_notbusy = i;
 						}
 						check = true;
@@ -1476,6 +1555,7 @@ bool DispatchController::GetRoute(int number, DispatchController::Route &route)
 	route.requests = 0;
 	route.starting_floor = 0;
 	route.station = 0;
+	route.time = 0;
 
 	if (number < 0 || number >= Routes.size())
 		return false;
@@ -1484,4 +1564,52 @@ bool DispatchController::GetRoute(int number, DispatchController::Route &route)
 	return true;
 }
 
+bool DispatchController::SetPolicy(const std::string &name)
+{
+	//set the elevator selection policy by name
+
+	DispatchPolicy *newpolicy = DispatchPolicy::Create(this, name);
+
+	if (!newpolicy)
+		return ReportError("Invalid dispatch policy '" + name + "'");
+
+	if (policy)
+		delete policy;
+	policy = newpolicy;
+
+	Report("Using dispatch policy " + policy->GetName());
+	return true;
+}
+
+void DispatchController::RecordArrival(const Route &route)
+{
+	//add a served route to the wait time statistics
+
+	Real wait = Real(sbs->GetRunTime() - route.time) / 1000;
+
+	stats.routes++;
+	stats.passengers += route.requests;
+	stats.total_wait += wait * route.requests;
+	if (wait > stats.max_wait)
+		stats.max_wait = wait;
+}
+
+void DispatchController::GetStatistics(Statistics &result)
+{
+	//get wait time and throughput statistics
+
+	result = stats;
+	result.elapsed = Real(sbs->GetRunTime() - stats_start) / 1000;
+}
+
+void DispatchController::ResetStatistics()
+{
+	stats.routes = 0;
+	stats.passengers = 0;
+	stats.total_wait = 0;
+	stats.max_wait = 0;
+	stats.elapsed = 0;
+	stats_start = sbs->GetRunTime();
+}
+
 }
@@ -37,6 +37,7 @@ public:
 	int Range; //elevator selection range
 	int MaxPassengers; //maximum passengers per route
 	bool Reprocess; //if true, reprocess routes instead of dropping them when an elevator becomes unavailable
+	int ReassignInterval; //number of steps between batch reassignments of pending standard routes
 
 	struct Route
 	{
@@ -48,6 +49,16 @@ public:
 		int assigned_elevator;
 		CallStation* station;
 		bool destination; //true if a destination dispatch route
+		unsigned long time; //time the route was requested
+	};
+
+	struct Statistics
+	{
+		int routes; //routes served
+		int passengers; //passenger requests served
+		Real total_wait; //total passenger wait time, in seconds
+		Real max_wait; //longest route wait time, in seconds
+		Real elapsed; //time since statistics were reset, in seconds
 	};
 
 	//functions
@@ -87,6 +98,10 @@ public:
 	int GetRouteCount();
 	bool GetRoute(int number, Route &route);
 	bool RemoveElevatorIndex(int index);
+	bool SetPolicy(const std::string &name);
+	DispatchPolicy* GetPolicy() { return policy; }
+	void GetStatistics(Statistics &result);
+	void ResetStatistics();
 
 private:
 
@@ -94,9 +109,11 @@ private:
 	void DispatchElevator(bool destination, int number, int destination_floor, int direction, bool call);
 	void RemoveRoute(const Route &route);
 	void ProcessRoutes();
+	void ReassignRoutes();
 	void GetFloorRange();
 	bool ElevatorUnavailable(int elevator);
 	void CheckArrivals();
+	void RecordArrival(const Route &route);
 
 	int bottom_floor;
 	int top_floor;
@@ -127,6 +144,11 @@ private:
 	std::vector<CallStation*> CallStations; //call station registrations
 
 	int recheck;
+
+	DispatchPolicy *policy; //elevator selection policy
+
+	Statistics stats;
+	unsigned long stats_start; //time statistics were reset
 };
 
 }
@@ -0,0 +1,482 @@
+/*
+	Scalable Building Simulator - Crowd Simulation
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cmath>
+#include "globals.h"
+#include "sbs.h"
+#include "floor.h"
+#include "elevator.h"
+#include "elevatorcar.h"
+#include "callstation.h"
+#include "control.h"
+#include "route.h"
+#include "random.h"
+#include "profiler.h"
+#include "crowd.h"
+
+namespace SBS {
+
+Crowd::Crowd(Object *parent) : Object(parent)
+{
+	//set up SBS object
+	SetValues("Crowd", "Crowd", true, false);
+
+	RandomProbability = sbs->GetConfigInt("Skyscraper.SBS.Person.RandomProbability", 20);
+	RandomFrequency = sbs->GetConfigFloat("Skyscraper.SBS.Person.RandomFrequency", 5);
+	step_interval = (unsigned long)sbs->GetConfigInt("Skyscraper.SBS.Crowd.StepInterval", 100);
+	last_step = 0;
+
+	//initialize random number generators; a nonzero seed makes crowd runs repeatable
+	unsigned int seed = (unsigned int)sbs->GetConfigInt("Skyscraper.SBS.Crowd.Seed", 0);
+	if (seed == 0)
+		seed = (unsigned int)time(0);
+	rnd_time = new RandomGen(seed);
+	rnd_dest = new RandomGen(seed + 1);
+
+	ResetStatistics();
+
+	EnableLoop(true);
+}
+
+Crowd::~Crowd()
+{
+	//delete random number generators
+	if (rnd_time)
+		delete rnd_time;
+	rnd_time = 0;
+
+	if (rnd_dest)
+		delete rnd_dest;
+	rnd_dest = 0;
+}
+
+int Crowd::AddAgents(int count, int floor_number, bool service_access)
+{
+	//add agents to the crowd, idle on the given floor
+	//returns the number of agents added
+
+	if (count <= 0)
+		return 0;
+
+	if (!sbs->GetFloor(floor_number))
+	{
+		ReportError("Invalid floor " + ToString(floor_number));
+		return 0;
+	}
+
+	size_t first = floor.size();
+	size_t total = first + count;
+
+	floor.resize(total, floor_number);
+	dest_floor.resize(total, floor_number);
+	flags.resize(total, service_access == true ? ServiceAccess : 0);
+	call_made.resize(total, 0);
+	leg.resize(total, 0);
+	leg_count.resize(total, 0);
+	station.resize(total, 0);
+	trip_start.resize(total, 0);
+	active_slot.resize(total, -1);
+	leg_car.resize(total * MaxLegs, 0);
+	leg_floor.resize(total * MaxLegs, 0);
+
+	//schedule first departures
+	unsigned long now = sbs->GetRunTime();
+	for (size_t i = first; i < total; i++)
+		Schedule((uint32_t)i, now);
+
+	Report("Added " + ToString(count) + " agents on floor " + ToString(floor_number));
+	return count;
+}
+
+void Crowd::Clear()
+{
+	//remove all agents
+
+	floor.clear();
+	dest_floor.clear();
+	flags.clear();
+	call_made.clear();
+	leg.clear();
+	leg_count.clear();
+	station.clear();
+	trip_start.clear();
+	active_slot.clear();
+	leg_car.clear();
+	leg_floor.clear();
+	active.clear();
+	departures = std::priority_queue<Departure, std::vector<Departure>, std::greater<Departure> >();
+}
+
+bool Crowd::Loop()
+{
+	//this function runs for each simulation step, and updates the crowd every step_interval milliseconds
+
+	if (floor.empty() == true)
+		return true;
+
+	unsigned long now = sbs->GetRunTime();
+	if (last_step > 0 && now - last_step < step_interval)
+		return true;
+	last_step = now;
+
+	Step(now);
+
+	return true;
+}
+
+void Crowd::Step(unsigned long now)
+{
+	SBS_PROFILE("Crowd::Step");
+
+	//start trips for agents that are due to depart
+	int started = 0;
+	while (departures.empty() == false && departures.top().time <= now && started < MaxRoutes)
+	{
+		uint32_t agent = departures.top().agent;
+		departures.pop();
+		Depart(agent, now);
+		started++;
+	}
+
+	//process agents on a trip
+	//agents finishing a trip are removed from the active list, so step backwards
+	for (size_t i = active.size(); i > 0; i--)
+	{
+		if (i - 1 < active.size())
+			StepAgent(active[i - 1], now);
+	}
+}
+
+void Crowd::Depart(uint32_t agent, unsigned long now)
+{
+	//start a trip to a random floor
+
+	int floors = sbs->GetTotalFloors();
+	if (floors <= 1)
+		return;
+
+	int dest = (int)rnd_dest->Get(floors - 1) - sbs->Basements;
+
+	//if the destination is the current floor, wait for the next departure
+	if (dest == floor[agent] || !sbs->GetFloor(dest))
+	{
+		Schedule(agent, now);
+		return;
+	}
+
+	dest_floor[agent] = dest;
+	trip_start[agent] = now;
+
+	//add to active list
+	active_slot[agent] = (int)active.size();
+	active.emplace_back(agent);
+
+	if (StartRoute(agent) == false)
+		Finish(agent, false, now);
+}
+
+bool Crowd::StartRoute(uint32_t agent)
+{
+	//get route from the current floor to the destination, as a list of elevators
+
+	std::vector<ElevatorRoute> elevators = sbs->GetRouteToFloor(floor[agent], dest_floor[agent], (flags[agent] & ServiceAccess) != 0);
+
+	if (elevators.empty() == true)
+		return false;
+
+	size_t count = std::min(elevators.size(), (size_t)MaxLegs);
+	size_t base = (size_t)agent * MaxLegs;
+	for (size_t i = 0; i < count; i++)
+	{
+		leg_car[base + i] = elevators[i].car;
+		leg_floor[base + i] = elevators[i].floor_selection;
+	}
+	leg[agent] = 0;
+	leg_count[agent] = (uint8_t)count;
+
+	StartLeg(agent);
+	return true;
+}
+
+void Crowd::StartLeg(uint32_t agent)
+{
+	//reset call state for the current route leg
+
+	flags[agent] &= ServiceAccess;
+	call_made[agent] = 0;
+	station[agent] = 0;
+}
+
+void Crowd::StepAgent(uint32_t agent, unsigned long now)
+{
+	//process an agent's route, in the same way as Person::ProcessRoute
+
+	size_t index = ((size_t)agent * MaxLegs) + leg[agent];
+	ElevatorCar *car = leg_car[index];
+	int floor_selection = leg_floor[index];
+	int current_floor = floor[agent];
+
+	if (!car)
+	{
+		Finish(agent, false, now);
+		return;
+	}
+
+	Elevator *elevator = car->GetElevator();
+
+	if (elevator->GetDestinationDispatch() == true)
+		flags[agent] |= Destination;
+	else
+		flags[agent] &= ~Destination;
+	bool destination = (flags[agent] & Destination) != 0;
+
+	//if a call has not been made, press first elevator's associated call button
+	if (call_made[agent] == 0)
+	{
+		Floor *floor_obj = sbs->GetFloor(current_floor);
+		CallStation *callstation = 0;
+		if (floor_obj)
+			callstation = floor_obj->GetCallStationForElevator(elevator->Number);
+		station[agent] = callstation;
+
+		bool result = false;
+
+		if (callstation && destination == false)
+			result = callstation->Press(floor_selection > current_floor);
+
+		if (callstation && destination == true)
+		{
+			result = callstation->SelectFloor(floor_selection);
+			flags[agent] |= FloorSelected;
+		}
+
+		call_made[agent] = (floor_selection > current_floor) ? 1 : -1;
+
+		//abandon trip if call can't be made
+		if (result == false)
+			Finish(agent, false, now);
+		return;
+	}
+
+	//if a call has been made, wait for an elevator to arrive
+	//then press floor button for standard elevators, or ride elevator for destination dispatch
+	if ((flags[agent] & FloorSelected) == 0 || (destination == true && (flags[agent] & InElevator) == 0))
+	{
+		CallStation *callstation = station[agent];
+
+		if (!callstation)
+			return;
+
+		bool direction = (floor_selection > current_floor);
+		int number = 0;
+		if (destination == false)
+			number = callstation->GetElevatorArrivedStandard(current_floor, direction);
+		else
+			number = callstation->GetElevatorArrived(current_floor, floor_selection);
+
+		if (number > 0)
+		{
+			Elevator *arrived = sbs->GetElevator(number);
+			if (!arrived)
+				return;
+
+			ElevatorCar *arrived_car = arrived->GetCarForFloor(current_floor);
+			if (!arrived_car)
+				return;
+
+			//use arrived elevator for this leg, and board it
+			leg_car[index] = arrived_car;
+			flags[agent] |= InElevator;
+
+			//wait for elevator doors to open before pressing button
+			if (destination == false && arrived_car->AreDoorsOpen() == true)
+			{
+				Control *control = arrived_car->GetFloorButton(floor_selection);
+
+				if (control && control->IsLocked() == false)
+				{
+					//press floor button
+					control->Press();
+					flags[agent] |= FloorSelected;
+					return;
+				}
+
+				//abandon trip if floor button is locked, or does not exist
+				Finish(agent, false, now);
+			}
+		}
+		else
+		{
+			//if call has become invalid, abandon trip
+			if ((direction == true && callstation->GetUpStatus() == false) ||
+					(direction == false && callstation->GetDownStatus() == false))
+				Finish(agent, false, now);
+		}
+		return;
+	}
+
+	//wait for the elevator to arrive at the selected floor
+	if (elevator->OnFloor == true && car->GetFloor() == floor_selection && car->AreDoorsOpen() == true)
+	{
+		floor[agent] = floor_selection;
+
+		//if fire phase 1 is enabled, stop the trip
+		if (elevator->FireServicePhase1 == 1)
+		{
+			Finish(agent, false, now);
+			return;
+		}
+
+		if (floor_selection == dest_floor[agent])
+		{
+			Finish(agent, true, now);
+			return;
+		}
+
+		//start the next leg, or find a new route if the stored legs are used up
+		leg[agent]++;
+		if (leg[agent] < leg_count[agent])
+			StartLeg(agent);
+		else if (StartRoute(agent) == false)
+			Finish(agent, false, now);
+	}
+	else if (elevator->InServiceMode() == true)
+	{
+		if (elevator->FireServicePhase1 == 1)
+		{
+			//if fire phase 1 mode is enabled, change floor selection to recall floor
+			//in order to exit the elevator at the recall floor
+			if (floor_selection != elevator->GetActiveRecallFloor())
+			{
+				leg_floor[index] = elevator->GetActiveRecallFloor();
+				call_made[agent] = 2;
+			}
+		}
+		else
+		{
+			//otherwise exit at current floor and try another elevator
+			floor[agent] = car->GetFloor();
+			flags[agent] &= ~FloorSelected;
+			call_made[agent] = 0;
+		}
+	}
+	else if (elevator->IsMoving == true)
+		floor[agent] = car->GetFloor();
+}
+
+void Crowd::Finish(uint32_t agent, bool success, unsigned long now)
+{
+	//end an agent's trip, and schedule its next departure
+
+	if (success == true)
+	{
+		Real trip_time = Real(now - trip_start[agent]) / 1000.0;
+		trips++;
+		total_time += trip_time;
+		if (trip_time > max_time)
+			max_time = trip_time;
+	}
+	else
+		failed++;
+
+	leg_count[agent] = 0;
+	StartLeg(agent);
+
+	//remove from active list, by moving the last active agent into its place
+	int slot = active_slot[agent];
+	if (slot >= 0)
+	{
+		uint32_t last = active.back();
+		active[slot] = last;
+		active_slot[last] = slot;
+		active.pop_back();
+		active_slot[agent] = -1;
+	}
+
+	Schedule(agent, now);
+}
+
+void Crowd::Schedule(uint32_t agent, unsigned long now)
+{
+	//schedule an agent's next departure
+	//each RandomFrequency seconds, an idle agent departs with a probability of 1 in RandomProbability,
+	//so the number of checks until a departure is drawn directly
+
+	Real checks = 1;
+	if (RandomProbability > 1)
+	{
+		Real chance = 1.0 / RandomProbability;
+		Real value = 1.0 - rnd_time->Get(); //in (0, 1]
+		checks += std::floor(std::log(value) / std::log(1.0 - chance));
+	}
+
+	Departure departure;
+	departure.time = now + (unsigned long)(checks * RandomFrequency * 1000);
+	departure.agent = agent;
+	departures.push(departure);
+}
+
+size_t Crowd::GetMemoryUsage()
+{
+	//return memory used by agent records
+
+	size_t size = (floor.capacity() + dest_floor.capacity() + leg_floor.capacity() + active_slot.capacity()) * sizeof(int);
+	size += (flags.capacity() + call_made.capacity() + leg.capacity() + leg_count.capacity()) * sizeof(uint8_t);
+	size += (station.capacity() * sizeof(CallStation*)) + (leg_car.capacity() * sizeof(ElevatorCar*));
+	size += trip_start.capacity() * sizeof(unsigned long);
+	size += active.capacity() * sizeof(uint32_t);
+	size += departures.size() * sizeof(Departure);
+	return size;
+}
+
+void Crowd::GetStatistics(Statistics &result)
+{
+	result.agents = GetAgentCount();
+	result.active = GetActiveCount();
+	result.trips = trips;
+	result.failed = failed;
+	result.total_time = total_time;
+	result.max_time = max_time;
+}
+
+void Crowd::ResetStatistics()
+{
+	trips = 0;
+	failed = 0;
+	total_time = 0;
+	max_time = 0;
+}
+
+void Crowd::Report(const std::string &message)
+{
+	//general reporting function
+	Object::Report("Crowd: " + message);
+}
+
+bool Crowd::ReportError(const std::string &message)
+{
+	//general reporting function
+	return Object::ReportError("Crowd: " + message);
+}
+
+}
@@ -0,0 +1,129 @@
+/*
+	Scalable Building Simulator - Crowd Simulation
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_CROWD_H
+#define _SBS_CROWD_H
+
+#include <queue>
+
+namespace SBS {
+
+//crowd simulation, for random activity with large numbers of passengers
+//agents are stored as records in contiguous arrays, and are stepped in one batched update,
+//making elevator calls through call stations and floor buttons like Person objects do
+class SBSIMPEXP Crowd : public Object
+{
+public:
+
+	struct Statistics
+	{
+		int agents; //number of agents
+		int active; //agents on a trip
+		int trips; //completed trips
+		int failed; //trips abandoned, when no call could be made
+		Real total_time; //total time of completed trips, in seconds
+		Real max_time; //longest trip, in seconds
+	};
+
+	//functions
+	explicit Crowd(Object *parent);
+	~Crowd();
+	int AddAgents(int count, int floor, bool service_access = false);
+	void Clear();
+	bool Loop();
+	int GetAgentCount() { return (int)floor.size(); }
+	int GetActiveCount() { return (int)active.size(); }
+	size_t GetMemoryUsage();
+	void GetStatistics(Statistics &result);
+	void ResetStatistics();
+	void Report(const std::string &message);
+	bool ReportError(const std::string &message);
+
+private:
+
+	void Step(unsigned long now);
+	void StepAgent(uint32_t agent, unsigned long now);
+	void Depart(uint32_t agent, unsigned long now);
+	bool StartRoute(uint32_t agent);
+	void StartLeg(uint32_t agent);
+	void Finish(uint32_t agent, bool success, unsigned long now);
+	void Schedule(uint32_t agent, unsigned long now);
+
+	static const int MaxLegs = 4; //elevator legs stored per agent; longer routes are rerouted at the last leg
+	static const int MaxRoutes = 256; //maximum trips started per step
+
+	//agent flags
+	static const uint8_t ServiceAccess = 1;
+	static const uint8_t FloorSelected = 2;
+	static const uint8_t Destination = 4;
+	static const uint8_t InElevator = 8;
+
+	//agent records
+	std::vector<int> floor; //current floor
+	std::vector<int> dest_floor; //trip destination floor
+	std::vector<uint8_t> flags;
+	std::vector<int8_t> call_made; //0 if no call, 1 for up, -1 for down, 2 for recall
+	std::vector<uint8_t> leg; //current route leg
+	std::vector<uint8_t> leg_count; //number of route legs
+	std::vector<CallStation*> station; //call station used for the current leg
+	std::vector<unsigned long> trip_start; //time the trip started
+	std::vector<int> active_slot; //position in the active list, or -1 if idle
+
+	//route legs, MaxLegs per agent
+	std::vector<ElevatorCar*> leg_car;
+	std::vector<int> leg_floor; //floor selection of each leg
+
+	//agents on a trip
+	std::vector<uint32_t> active;
+
+	//idle agents, ordered by their next departure time
+	struct Departure
+	{
+		unsigned long time;
+		uint32_t agent;
+
+		bool operator>(const Departure &other) const
+		{
+			if (time != other.time)
+				return time > other.time;
+			return agent > other.agent;
+		}
+	};
+	std::priority_queue<Departure, std::vector<Departure>, std::greater<Departure> > departures;
+
+	RandomGen *rnd_time, *rnd_dest;
+	int RandomProbability; //probability ratio of random activity, starting with 1 - higher is less frequent
+	Real RandomFrequency; //speed in seconds to make each random action
+	unsigned long step_interval; //milliseconds between crowd updates
+	unsigned long last_step;
+
+	//statistics
+	int trips;
+	int failed;
+	Real total_time;
+	Real max_time;
+};
+
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+	Scalable Building Simulator - Dispatch Policies
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <algorithm>
+#include "globals.h"
+#include "sbs.h"
+#include "elevator.h"
+#include "elevatorcar.h"
+#include "elevatordoor.h"
+#include "floor.h"
+#include "elevroute.h"
+#include "controller.h"
+#include "dispatch.h"
+
+namespace SBS {
+
+DispatchPolicy::DispatchPolicy(DispatchController *parent) : ObjectBase(parent)
+{
+	controller = parent;
+}
+
+DispatchPolicy* DispatchPolicy::Create(DispatchController *parent, const std::string &name)
+{
+	//create a dispatch policy by name
+	//returns 0 if the name is not valid
+
+	std::string policy = SetCaseCopy(name, false);
+
+	if (policy == "nearest")
+		return new NearestPolicy(parent);
+	if (policy == "timetoserve")
+		return new TimeToServePolicy(parent);
+
+	return 0;
+}
+
+Real NearestPolicy::GetCost(Elevator *elevator, ElevatorCar *car, int starting_floor, int destination_floor, int direction)
+{
+	return (Real)abs(car->GetFloor() - starting_floor);
+}
+
+Real TimeToServePolicy::GetCost(Elevator *elevator, ElevatorCar *car, int starting_floor, int destination_floor, int direction)
+{
+	//estimate the time in seconds for the car to arrive at the starting floor
+
+	RouteController *routes = elevator->GetRouteController();
+	int floor = car->GetFloor();
+	int active = elevator->ActiveDirection;
+	Real stop_time = GetStopTime(elevator, car);
+	Real time = 0;
+
+	//doors need to close before the car can leave
+	if (elevator->AreDoorsOpen() == true)
+		time += DoorTime;
+
+	//get the floor where the car will reverse direction
+	int turn = floor;
+	if (active != 0)
+		routes->GetQueueEnd(active, turn);
+
+	bool ahead = (active == 1 && starting_floor >= floor) || (active == -1 && starting_floor <= floor);
+
+	if (active == 0 || (ahead == true && (direction == active || starting_floor == turn)))
+	{
+		//idle, or the call is along the current direction of travel
+		time += GetTravelTime(elevator, floor, starting_floor);
+
+		if (active != 0)
+		{
+			if (active == 1)
+				time += stop_time * routes->GetQueueCount(1, floor, starting_floor - 1);
+			else
+				time += stop_time * routes->GetQueueCount(-1, starting_floor + 1, floor);
+		}
+	}
+	else
+	{
+		//the car finishes its current run first, and then travels to the call
+		time += GetTravelTime(elevator, floor, turn) + GetTravelTime(elevator, turn, starting_floor);
+		time += stop_time * routes->GetQueueCount(active, std::min(floor, turn), std::max(floor, turn));
+		time += stop_time * routes->GetQueueCount(-active, std::min(turn, starting_floor) + 1, std::max(turn, starting_floor) - 1);
+	}
+
+	return time;
+}
+
+Real TimeToServePolicy::GetTravelTime(Elevator *elevator, int start_floor, int end_floor)
+{
+	//estimate the travel time between two floors, with a trapezoidal speed profile
+
+	if (start_floor == end_floor)
+		return 0;
+
+	Floor *start = sbs->GetFloor(start_floor);
+	Floor *end = sbs->GetFloor(end_floor);
+	if (!start || !end)
+		return 0;
+
+	Real distance = std::abs(end->GetBase() - start->GetBase());
+	Real speed = (end_floor > start_floor) ? elevator->UpSpeed : elevator->DownSpeed;
+
+	if (speed <= 0)
+		return 0;
+
+	//acceleration rates in units per second squared
+	Real accel = speed * elevator->Acceleration;
+	Real decel = speed * elevator->Deceleration;
+
+	if (accel <= 0 || decel <= 0)
+		return distance / speed;
+
+	//distance needed to reach full speed and stop again
+	Real ramp = (speed * speed / (2 * accel)) + (speed * speed / (2 * decel));
+
+	if (distance >= ramp)
+		return (speed / accel) + (speed / decel) + ((distance - ramp) / speed);
+
+	//full speed is not reached
+	return std::sqrt(2 * distance * ((1 / accel) + (1 / decel)));
+}
+
+Real TimeToServePolicy::GetStopTime(Elevator *elevator, ElevatorCar *car)
+{
+	//estimate the time spent at each intermediate stop
+
+	Real time = elevator->ArrivalDelay + elevator->DepartureDelay + (DoorTime * 2);
+
+	ElevatorDoor *door = car->GetDoor(1);
+	if (door)
+		time += Real(door->DoorTimer) / 1000;
+
+	return time;
+}
+
+}
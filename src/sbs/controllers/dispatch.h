@@ -0,0 +1,77 @@
+/*
+	Scalable Building Simulator - Dispatch Policies
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_DISPATCH_H
+#define _SBS_DISPATCH_H
+
+namespace SBS {
+
+//dispatch policy, used by a dispatch controller to rank elevator cars for a call
+class SBSIMPEXP DispatchPolicy : public ObjectBase
+{
+public:
+
+	explicit DispatchPolicy(DispatchController *parent);
+	virtual ~DispatchPolicy() {}
+	static DispatchPolicy* Create(DispatchController *parent, const std::string &name);
+	virtual std::string GetName() = 0;
+
+	//return the cost of serving a call at the starting floor with the specified car; lower is better
+	virtual Real GetCost(Elevator *elevator, ElevatorCar *car, int starting_floor, int destination_floor, int direction) = 0;
+
+protected:
+
+	DispatchController *controller;
+};
+
+//original policy; ranks cars by floor distance to the call
+class SBSIMPEXP NearestPolicy : public DispatchPolicy
+{
+public:
+
+	explicit NearestPolicy(DispatchController *parent) : DispatchPolicy(parent) {}
+	std::string GetName() override { return "Nearest"; }
+	Real GetCost(Elevator *elevator, ElevatorCar *car, int starting_floor, int destination_floor, int direction) override;
+};
+
+//ranks cars by estimated time to reach the call, based on the car's route queues,
+//speed, acceleration and deceleration, and stop times for queued calls
+class SBSIMPEXP TimeToServePolicy : public DispatchPolicy
+{
+public:
+
+	explicit TimeToServePolicy(DispatchController *parent) : DispatchPolicy(parent) {}
+	std::string GetName() override { return "TimeToServe"; }
+	Real GetCost(Elevator *elevator, ElevatorCar *car, int starting_floor, int destination_floor, int direction) override;
+
+private:
+
+	Real GetTravelTime(Elevator *elevator, int start_floor, int end_floor);
+	Real GetStopTime(Elevator *elevator, ElevatorCar *car);
+
+	static constexpr Real DoorTime = 2.5; //estimated door opening or closing time, in seconds
+};
+
+}
+
+#endif
@@ -775,6 +775,55 @@ bool RouteController::IsQueued(int floor, int queue)
 	return false;
 }
 
+int RouteController::GetQueueCount(int queue, int floor_min, int floor_max)
+{
+	//return the number of queued floors between floor_min and floor_max (inclusive)
+	//if queue is 0, check both queues; otherwise up queue with 1, and down queue with -1
+
+	int count = 0;
+
+	if (queue == 0 || queue == 1)
+	{
+		for (size_t i = 0; i < UpQueue.size(); i++)
+		{
+			if (UpQueue[i].floor >= floor_min && UpQueue[i].floor <= floor_max)
+				count++;
+		}
+	}
+
+	if (queue == 0 || queue == -1)
+	{
+		for (size_t i = 0; i < DownQueue.size(); i++)
+		{
+			if (DownQueue[i].floor >= floor_min && DownQueue[i].floor <= floor_max)
+				count++;
+		}
+	}
+
+	return count;
+}
+
+bool RouteController::GetQueueEnd(int queue, int &floor)
+{
+	//get the last floor the elevator will stop at while processing the specified queue;
+	//the highest floor for the up queue (1), and the lowest for the down queue (-1)
+	//returns false if the queue is empty
+
+	std::vector<QueueEntry> &list = (queue == 1) ? UpQueue : DownQueue;
+
+	if (list.empty() == true)
+		return false;
+
+	floor = list[0].floor;
+	for (size_t i = 1; i < list.size(); i++)
+	{
+		if ((queue == 1 && list[i].floor > floor) || (queue == -1 && list[i].floor < floor))
+			floor = list[i].floor;
+	}
+
+	return true;
+}
+
 int RouteController::GetActiveCallFloor()
 {
 	return ActiveCall.floor;
@@ -53,6 +53,8 @@ public:
 	void DeleteActiveRoute();
 	bool IsQueueActive();
 	bool IsQueued(int floor, int queue = 0);
+	int GetQueueCount(int queue, int floor_min, int floor_max);
+	bool GetQueueEnd(int queue, int &floor);
 	int GetActiveCallFloor();
 	int GetActiveCallDirection();
 	int GetActiveCallType();
@@ -35,6 +35,7 @@
 #include "profiler.h"
 #include "utility.h"
 #include "teleporter.h"
+#include "camera.h"
 #include "manager.h"
 
 namespace SBS {
@@ -54,6 +55,12 @@ FloorManager::FloorManager(Object* parent) : Manager(parent)
 	floors = new DynamicMesh(this, GetSceneNode(), "Floor Container");
 	interfloors = new DynamicMesh(this, GetSceneNode(), "Interfloor Container");
 	columnframes = new DynamicMesh(this, GetSceneNode(), "Columnframe Container");
+	page_range = sbs->GetConfigInt("Skyscraper.SBS.FloorPageRange", 10);
+	page_budget = 4;
+	page_index = 0;
+	page_floor = 0;
+	page_destination = 0;
+	page_complete = false;
 	EnableLoop(true);
 }
 
@@ -271,9 +278,107 @@ bool FloorManager::Loop()
 {
 	SBS_PROFILE("FloorManager::Loop");
 
+	Page();
+
 	return LoopChildren();
 }
 
+void FloorManager::Page()
+{
+	//keep floor geometry resident only near the camera
+
+	//floors within the page range of the camera's floor, or of the occupied elevator's destination,
+	//are restored ahead of being shown, and disabled floors outside of that are evicted, a few per frame
+	//floors that are shown, including those shown from the current shaft or stairwell, are never evicted,
+	//and a floor that gets enabled while evicted is restored immediately by its meshes
+
+	if (page_range <= 0 || sbs->IsRunning == false || Array.empty() == true)
+		return;
+
+	SBS_PROFILE("FloorManager::Page");
+
+	int floor = sbs->camera->CurrentFloor;
+	int destination = floor;
+
+	if (sbs->InElevator == true)
+	{
+		Elevator *elevator = sbs->GetElevator(sbs->ElevatorNumber);
+		if (elevator && elevator->IsMoving == true)
+			destination = elevator->GotoFloor;
+	}
+
+	int budget = page_budget;
+
+	//restore floors in range, nearest first
+	if (floor != page_floor || destination != page_destination || page_complete == false)
+	{
+		for (int i = 0; i <= page_range && budget > 0; i++)
+		{
+			budget -= RestoreFloor(floor + i);
+			if (i > 0)
+				budget -= RestoreFloor(floor - i);
+
+			if (destination != floor)
+			{
+				budget -= RestoreFloor(destination + i);
+				if (i > 0)
+					budget -= RestoreFloor(destination - i);
+			}
+		}
+
+		page_floor = floor;
+		page_destination = destination;
+		page_complete = (budget > 0);
+	}
+
+	//evict floors out of range, checking part of the floor array each frame
+	size_t checks = std::min(Array.size(), (size_t)32);
+
+	for (size_t i = 0; i < checks && budget > 0; i++)
+	{
+		if (page_index >= Array.size())
+			page_index = 0;
+
+		Map &entry = Array[page_index];
+		page_index++;
+
+		if (std::abs(entry.number - floor) <= page_range || std::abs(entry.number - destination) <= page_range)
+			continue;
+
+		if (entry.object && entry.object->Evict() == true)
+			budget--;
+	}
+}
+
+int FloorManager::RestoreFloor(int number)
+{
+	//restore an evicted floor, and return the number of floors restored
+
+	if (number < -sbs->Basements || number >= sbs->Floors)
+		return 0;
+
+	Floor *floor = Get(number);
+
+	if (!floor || floor->IsEvicted() == false)
+		return 0;
+
+	floor->Restore();
+	return 1;
+}
+
+int FloorManager::GetEvictedCount()
+{
+	//return the number of floors with evicted geometry
+
+	int count = 0;
+	for (size_t i = 0; i < Array.size(); i++)
+	{
+		if (Array[i].object && Array[i].object->IsEvicted() == true)
+			count++;
+	}
+	return count;
+}
+
 ElevatorManager::ElevatorManager(Object* parent) : Manager(parent)
 {
 	//set up SBS object
@@ -52,6 +52,7 @@ public:
 	DynamicMesh* GetIFloorDynMesh() { return interfloors; }
 	DynamicMesh* GetColumnDynMesh() { return columnframes; }
 	bool Loop() override;
+	int GetEvictedCount();
 
 private:
 	struct Map
@@ -60,6 +61,9 @@ private:
 		Floor* object; //floor object reference
 	};
 
+	void Page();
+	int RestoreFloor(int number);
+
 	std::vector<Map> Array; //floor object array
 
 	//dynamic mesh objects
@@ -70,6 +74,14 @@ private:
 	//function caching
 	Floor* get_result;
 	int get_number;
+
+	//geometry paging
+	int page_range; //floors kept resident above and below the camera, or 0 to disable paging
+	int page_budget; //maximum floors restored or evicted per frame
+	size_t page_index; //eviction sweep position in the floor array
+	int page_floor; //camera floor of the last completed restore pass
+	int page_destination; //elevator destination floor of the last completed restore pass
+	bool page_complete; //true if the last restore pass finished within the budget
 };
 
 class SBSIMPEXP ElevatorManager : public Manager
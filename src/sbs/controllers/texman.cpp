@@ -21,6 +21,7 @@
 	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <algorithm>
 #include <OgreRoot.h>
 #include <OgreImage.h>
 #include <OgreTextureManager.h>
@@ -38,6 +39,7 @@
 #include "texture.h"
 #include "teximage.h"
 #include "timer.h"
+#include "threadpool.h"
 #include "texman.h"
 
 namespace SBS {
@@ -108,6 +110,14 @@ TextureManager::TextureManager(Object *parent) : Object(parent)
 	//set default texture map values
 	ResetTextureMapping(true);
 
+	//set up background texture decoding for building loads,
+	//if Ogre is built to prepare resources on other threads
+	texture_pool = 0;
+	texture_threads = 1;
+#if OGRE_THREAD_SUPPORT
+	texture_threads = sbs->GetConfigInt("Skyscraper.SBS.TextureThreads", 0);
+#endif
+
 	//load default textures
 	Report("Loading default textures...");
 	sbs->SetLighting();
@@ -120,6 +130,11 @@ TextureManager::TextureManager(Object *parent) : Object(parent)
 
 TextureManager::~TextureManager()
 {
+	//stop background texture decoding
+	if (texture_pool)
+		delete texture_pool;
+	texture_pool = 0;
+
 	//delete slideshow objects
 	for (size_t i = 0; i < slideshows.size(); i++)
 	{
@@ -127,6 +142,13 @@ TextureManager::~TextureManager()
 			delete slideshows[i];
 	}
 
+	//delete atlas information
+	for (size_t i = 0; i < atlases.size(); i++)
+	{
+		if (atlases[i])
+			delete atlases[i];
+	}
+
 	//delete materials
 	UnloadMaterials();
 
@@ -243,9 +265,10 @@ bool TextureManager::LoadTexture(const std::string &filename, const std::string
 	if (MaterialExists(name))
 		return ReportError("Texture " + name + " already exists");
 
-	//load texture
+	//load texture, decoding it in the background if loading a building
 	bool has_alpha = false;
-	Ogre::TexturePtr mTex = LoadTexture(filename2, mipmaps, has_alpha, use_alpha_color, alpha_color);
+	size_t first_image = pending_images.size();
+	Ogre::TexturePtr mTex = LoadTexture(filename2, mipmaps, has_alpha, use_alpha_color, alpha_color, true);
 
 	if (!mTex)
 		return false;
@@ -263,8 +286,9 @@ bool TextureManager::LoadTexture(const std::string &filename, const std::string
 
 	//add texture multipliers
 	RegisterTexture(name, "", filename, widthmult, heightmult, enable_force, force_mode, mTex->getSize(), mMat->getSize());
+	AddPendingMaterial(name, mMat, first_image);
 
-	if (sbs->Verbose)
+	if (sbs->Verbose && mTex->isLoaded() == true)
 		Report("Loaded texture '" + filename2 + "' as '" + matname + "', size " + ToString((int)mTex->getSize()));
 	else
 		Report("Loaded texture '" + filename2 + "' as '" + matname + "'");
@@ -298,14 +322,15 @@ bool TextureManager::CreateSlideshow(const std::string &name, bool start, std::v
 	}
 
 	bool has_alpha = false;
+	size_t first_image = pending_images.size();
 
 	size_t size = 0;
 	for (size_t i = 0; i < filenames2.size(); i++)
 	{
 		bool has_alpha2 = false;
 
-		//load texture
-		Ogre::TexturePtr mTex = LoadTexture(filenames2[i], mipmaps, has_alpha2, use_alpha_color, alpha_color);
+		//load texture, decoding it in the background if loading a building
+		Ogre::TexturePtr mTex = LoadTexture(filenames2[i], mipmaps, has_alpha2, use_alpha_color, alpha_color, true);
 
 		if (!mTex)
 			return false;
@@ -316,7 +341,7 @@ bool TextureManager::CreateSlideshow(const std::string &name, bool start, std::v
 
 		size += mTex->getSize();
 
-		if (sbs->Verbose)
+		if (sbs->Verbose && mTex->isLoaded() == true)
 			Report("Loaded texture " + filenames2[i] + ", size " + ToString((int)mTex->getSize()));
 	}
 
@@ -348,6 +373,7 @@ bool TextureManager::CreateSlideshow(const std::string &name, bool start, std::v
 
 	//add texture multipliers
 	RegisterTexture(name, "", "", widthmult, heightmult, enable_force, force_mode, size, mMat->getSize());
+	AddPendingMaterial(name, mMat, first_image);
 
 	if (sbs->Verbose)
 		Report("Loaded animated texture " + matname);
@@ -373,14 +399,15 @@ bool TextureManager::LoadAnimatedTexture(std::vector<std::string> filenames, con
 	}
 
 	bool has_alpha = false;
+	size_t first_image = pending_images.size();
 
 	size_t size = 0;
 	for (size_t i = 0; i < filenames2.size(); i++)
 	{
 		bool has_alpha2 = false;
 
-		//load texture
-		Ogre::TexturePtr mTex = LoadTexture(filenames2[i], mipmaps, has_alpha2, use_alpha_color, alpha_color);
+		//load texture, decoding it in the background if loading a building
+		Ogre::TexturePtr mTex = LoadTexture(filenames2[i], mipmaps, has_alpha2, use_alpha_color, alpha_color, true);
 
 		if (!mTex)
 			return false;
@@ -391,7 +418,7 @@ bool TextureManager::LoadAnimatedTexture(std::vector<std::string> filenames, con
 
 		size += mTex->getSize();
 
-		if (sbs->Verbose)
+		if (sbs->Verbose && mTex->isLoaded() == true)
 			Report("Loaded texture " + filenames2[i] + ", size " + ToString((int)mTex->getSize()));
 	}
 
@@ -416,6 +443,7 @@ bool TextureManager::LoadAnimatedTexture(std::vector<std::string> filenames, con
 
 	//add texture multipliers
 	RegisterTexture(name, "", "", widthmult, heightmult, enable_force, force_mode, size, mMat->getSize());
+	AddPendingMaterial(name, mMat, first_image);
 
 	if (sbs->Verbose)
 		Report("Loaded animated texture " + matname);
@@ -547,6 +575,8 @@ bool TextureManager::UnloadTexture(const std::string &name, const std::string &g
 {
 	//unloads a texture
 
+	FinishTextures();
+
 	Ogre::ResourcePtr wrapper = GetTextureByName(name, group);
 	if (!wrapper)
 		return false;
@@ -577,6 +607,9 @@ bool TextureManager::LoadTextureCropped(const std::string &filename, const std::
 {
 	//loads only a portion of the specified texture
 
+	//the source texture's size and contents are read here, so finish any background loads first
+	FinishTextures();
+
 	Ogre::ColourValue alpha_color = Ogre::ColourValue::Black;
 	int mipmaps = -1;
 	bool use_alpha_color = false;
@@ -867,6 +900,9 @@ bool TextureManager::AddTextToTexture(const std::string &origname, const std::st
 	//h_align is either "left", "right" or "center" - default is center
 	//v_align is either "top", "bottom", or "center" - default is center
 
+	//the source texture must be uploaded
+	FinishTextures();
+
 	//if either x1 or y1 are -1, the value of 0 is used.
 	//If either x2 or y2 are -1, the width or height of the texture is used.
 
@@ -1024,6 +1060,9 @@ bool TextureManager::AddTextureOverlay(const std::string &orig_texture, const st
 	//draws the specified texture on top of another texture
 	//orig_texture is the original texture to use; overlay_texture is the texture to draw on top of it
 
+	//the source textures must be uploaded
+	FinishTextures();
+
 	std::string Name = name;
 	std::string Origname = orig_texture;
 	std::string Overlay = overlay_texture;
@@ -2268,6 +2307,8 @@ void TextureManager::SaveTexture(Ogre::TexturePtr texture, const std::string & f
 {
 	//save a raw texture to a file
 
+	FinishTextures();
+
 	Ogre::Image image;
 	texture->convertToImage(image, true);
 	image.save(filename);
@@ -2302,12 +2343,22 @@ void TextureManager::DecrementMaterialCount()
 	materialcount--;
 }
 
-Ogre::TexturePtr TextureManager::LoadTexture(const std::string &filename, int mipmaps, bool &has_alpha, bool use_alpha_color, Ogre::ColourValue alpha_color)
+Ogre::TexturePtr TextureManager::LoadTexture(const std::string &filename, int mipmaps, bool &has_alpha, bool use_alpha_color, Ogre::ColourValue alpha_color, bool background)
 {
 	//create new texture image object
 	TextureImage *teximage = new TextureImage(this, filename);
 
-	Ogre::TexturePtr texptr = teximage->LoadTexture(mipmaps, has_alpha, use_alpha_color, alpha_color);
+	//if requested, decode the image on a worker thread while a building is loading
+	//the worker threads are started for the load, and stopped when the building is prepared
+	ThreadPool *pool = 0;
+	if (background == true && sbs->IsRunning == false && texture_threads != 1)
+	{
+		if (!texture_pool)
+			texture_pool = new ThreadPool(texture_threads - 1);
+		pool = texture_pool;
+	}
+
+	Ogre::TexturePtr texptr = teximage->LoadTexture(mipmaps, has_alpha, use_alpha_color, alpha_color, pool);
 	if (!texptr)
 	{
 		delete teximage;
@@ -2315,9 +2366,131 @@ Ogre::TexturePtr TextureManager::LoadTexture(const std::string &filename, int mi
 	}
 
 	texture_images.emplace_back(teximage);
+	if (teximage->IsPending() == true)
+		pending_images.emplace_back(teximage);
 	return texptr;
 }
 
+void TextureManager::AddPendingMaterial(const std::string &name, Ogre::MaterialPtr material, size_t first_image)
+{
+	//track a material whose texture images are still being decoded,
+	//so that its alpha settings and texture size can be set when they're uploaded
+
+	if (first_image >= pending_images.size())
+		return;
+
+	PendingMaterial pending;
+	pending.name = name;
+	pending.material = material;
+	pending.first_image = first_image;
+	pending.last_image = pending_images.size();
+	pending_materials.emplace_back(pending);
+}
+
+void TextureManager::ReleaseTexturePool()
+{
+	//finish background texture decoding, and stop the worker threads until the next load
+
+	FinishTextures();
+
+	if (texture_pool)
+		delete texture_pool;
+	texture_pool = 0;
+}
+
+void TextureManager::FinishTextures()
+{
+	//wait for background texture images to be decoded, then upload them on this thread
+	//this runs before meshes are prepared, and before a texture's contents are used
+
+	if (pending_images.empty() == true)
+		return;
+
+	SBS_PROFILE("TextureManager::FinishTextures");
+
+	if (texture_pool)
+		texture_pool->Wait();
+
+	std::vector<bool> alpha (pending_images.size(), false);
+	std::vector<bool> failed (pending_images.size(), false);
+	std::vector<size_t> sizes (pending_images.size(), 0);
+
+	//upload textures
+	for (size_t i = 0; i < pending_images.size(); i++)
+	{
+		bool has_alpha = false;
+		size_t size = 0;
+
+		if (pending_images[i]->Finish(has_alpha, size) == false)
+			failed[i] = true;
+		alpha[i] = has_alpha;
+		sizes[i] = size;
+	}
+
+	//finish materials
+	for (size_t i = 0; i < pending_materials.size(); i++)
+	{
+		PendingMaterial &pending = pending_materials[i];
+
+		bool has_alpha = false, has_failed = false;
+		size_t size = 0;
+
+		for (size_t j = pending.first_image; j < pending.last_image; j++)
+		{
+			if (alpha[j] == true)
+				has_alpha = true;
+			if (failed[j] == true)
+				has_failed = true;
+			size += sizes[j];
+		}
+
+		Ogre::Pass *pass = pending.material->getTechnique(0)->getPass(0);
+
+		if (has_failed == true)
+			pass->removeAllTextureUnitStates();
+		else if (has_alpha == true)
+			pass->setAlphaRejectSettings(Ogre::CMPF_GREATER_EQUAL, 128);
+
+		//update registered texture size
+		for (size_t j = 0; j < textures.size(); j++)
+		{
+			if (textures[j] && textures[j]->GetName() == pending.name)
+			{
+				textures[j]->tex_size += size;
+				break;
+			}
+		}
+
+		//update slideshow alpha setting, used when switching images
+		for (size_t j = 0; j < slideshows.size(); j++)
+		{
+			if (slideshows[j] && slideshows[j]->name == pending.name && has_alpha == true)
+				slideshows[j]->has_alpha = true;
+		}
+	}
+
+	if (sbs->Verbose)
+		Report("Uploaded " + ToString((int)pending_images.size()) + " textures");
+
+	pending_images.clear();
+	pending_materials.clear();
+}
+
+bool TextureManager::IsTexturePending(Ogre::TexturePtr texture)
+{
+	//returns true if the texture is still waiting to be decoded or uploaded
+
+	if (!texture)
+		return false;
+
+	for (size_t i = 0; i < pending_images.size(); i++)
+	{
+		if (pending_images[i]->IsPending() == true && pending_images[i]->GetTexture() == texture)
+			return true;
+	}
+	return false;
+}
+
 Ogre::MaterialPtr TextureManager::CreateMaterial(const std::string &name, const std::string &path)
 {
 	//unload material if already loaded
@@ -2436,6 +2609,8 @@ void TextureManager::CopyTexture(Ogre::TexturePtr source, Ogre::TexturePtr desti
 {
 	//copy a source texture onto a destination texture using the full sizes
 
+	FinishTextures();
+
 	Ogre::Box srcbox (0, 0, 0, source->getWidth(), source->getHeight(), source->getDepth());
 	Ogre::Box dstbox (0, 0, 0, destination->getWidth(), destination->getHeight(), destination->getDepth());
 
@@ -2541,6 +2716,9 @@ void TextureManager::SetCulling(const std::string &material_name, int mode)
 
 size_t TextureManager::GetMemoryUsage()
 {
+	//texture sizes are known once uploaded
+	FinishTextures();
+
 	size_t result = 0;
 
 	for (size_t i = 0; i < textures.size(); i++)
@@ -2719,4 +2897,184 @@ bool TextureManager::ComputeTextureSpace(Matrix3 &m, Vector3 &v, const Vector3 &
 	return true;
 }
 
+TextureAtlas* TextureManager::CreateAtlas(const std::string &name, const std::vector<std::string> &textures)
+{
+	//packs the specified textures into a new texture and material, in a grid of equally-sized cells
+	//textures that aren't loaded are skipped
+	//returns 0 if no textures were packed
+
+	FinishTextures();
+
+	if (MaterialExists(name))
+	{
+		ReportError("CreateAtlas: texture " + name + " already exists");
+		return 0;
+	}
+
+	//get source textures
+	std::vector<std::string> names;
+	std::vector<Ogre::TexturePtr> sources;
+	int max_width = 0, max_height = 0;
+	bool has_alpha = false;
+
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		//skip duplicates
+		if (std::find(names.begin(), names.end(), textures[i]) != names.end())
+			continue;
+
+		bool result;
+		std::string material = GetTextureMaterial(textures[i], result, false);
+		if (!result)
+			continue;
+
+		Ogre::MaterialPtr mMat = GetMaterialByName(material);
+		if (!mMat)
+			continue;
+
+		Ogre::TexturePtr source = GetTextureByName(GetTextureName(mMat));
+		if (!source)
+			continue;
+
+		names.emplace_back(textures[i]);
+		sources.emplace_back(source);
+		max_width = std::max(max_width, (int)source->getWidth());
+		max_height = std::max(max_height, (int)source->getHeight());
+		if (source->hasAlpha() == true)
+			has_alpha = true;
+	}
+
+	if (sources.empty() == true)
+		return 0;
+
+	//get grid size, and reduce cell size if needed to stay within the maximum texture size
+	int columns = (int)std::ceil(std::sqrt((Real)sources.size()));
+	int rows = ((int)sources.size() + columns - 1) / columns;
+	int cell_width = std::min(max_width, MaxAtlasSize / columns);
+	int cell_height = std::min(max_height, MaxAtlasSize / rows);
+
+	if (cell_width < 1 || cell_height < 1)
+	{
+		ReportError("CreateAtlas: too many textures for atlas " + name);
+		return 0;
+	}
+
+	//determine pixel format
+	Ogre::PixelFormat format = Ogre::PF_X8R8G8B8;
+	if (has_alpha == true)
+		format = Ogre::PF_A8R8G8B8;
+
+	//create new empty texture, without mipmaps to prevent bleeding between cells
+	std::string texturename = ToString(sbs->InstanceNumber) + ":" + name;
+	Ogre::TexturePtr atlas_texture;
+	try
+	{
+		atlas_texture = Ogre::TextureManager::getSingleton().createManual(texturename, "General", Ogre::TEX_TYPE_2D, (Ogre::uint)(columns * cell_width), (Ogre::uint)(rows * cell_height), 0, format, Ogre::TU_DEFAULT);
+		manual_textures.emplace_back(atlas_texture);
+		IncrementTextureCount();
+	}
+	catch (Ogre::Exception &e)
+	{
+		ReportError("Error creating atlas texture " + texturename + "\n" + e.getDescription());
+		return 0;
+	}
+
+	TextureAtlas *atlas = new TextureAtlas;
+	atlas->name = name;
+	atlas->texture = texturename;
+	atlas->columns = columns;
+	atlas->rows = rows;
+	atlas->cell_width = cell_width;
+	atlas->cell_height = cell_height;
+	atlas->has_alpha = has_alpha;
+
+	//copy source textures into cells
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		int x = ((int)i % columns) * cell_width;
+		int y = ((int)i / columns) * cell_height;
+
+		Ogre::Box source (0, 0, sources[i]->getWidth(), sources[i]->getHeight());
+		Ogre::Box cell (x, y, x + cell_width, y + cell_height);
+		CopyTexture(sources[i], atlas_texture, source, cell);
+
+		atlas->cells[names[i]] = (int)i;
+	}
+
+	//create a new material
+	Ogre::MaterialPtr mMat = CreateMaterial(name, "General");
+	BindTextureToMaterial(mMat, texturename, has_alpha);
+	RegisterTexture(name, "", "", 1, 1, false, false, atlas_texture->getSize(), mMat->getSize());
+
+	atlases.emplace_back(atlas);
+
+	if (sbs->Verbose)
+		Report("CreateAtlas: created atlas '" + name + "' with " + ToString((int)sources.size()) + " textures");
+
+	return atlas;
+}
+
+TextureAtlas* TextureManager::GetAtlas(const std::string &name)
+{
+	//get a texture atlas by name
+
+	for (size_t i = 0; i < atlases.size(); i++)
+	{
+		if (atlases[i]->name == name)
+			return atlases[i];
+	}
+	return 0;
+}
+
+bool TextureManager::CreateAtlasMaterial(TextureAtlas *atlas, const std::string &name)
+{
+	//create a material that shows a single cell of an atlas, selected with SetAtlasCell()
+
+	if (!atlas)
+		return false;
+
+	Ogre::MaterialPtr mMat = CreateMaterial(name, "General");
+	if (!mMat)
+		return false;
+
+	Ogre::TextureUnitState *state = BindTextureToMaterial(mMat, atlas->texture, atlas->has_alpha);
+	if (state)
+		state->setTextureAddressingMode(Ogre::TextureUnitState::TAM_CLAMP);
+
+	RegisterTexture(name, "", "", 1, 1, false, false, 0, mMat->getSize());
+	return true;
+}
+
+bool TextureManager::SetAtlasCell(Ogre::MaterialPtr material, TextureAtlas *atlas, const std::string &texture)
+{
+	//show the specified texture's atlas cell on a material created with CreateAtlasMaterial(),
+	//by changing the material's texture transform
+	//returns false if the texture is not in the atlas
+
+	if (!material || !atlas)
+		return false;
+
+	std::unordered_map<std::string, int>::const_iterator it = atlas->cells.find(texture);
+	if (it == atlas->cells.end())
+		return false;
+
+	Ogre::TextureUnitState *state = GetTextureUnitState(material);
+	if (!state)
+		return false;
+
+	int cell = it->second;
+	Real width = Real(atlas->columns * atlas->cell_width);
+	Real height = Real(atlas->rows * atlas->cell_height);
+
+	//map texture coordinates to the cell, inset by half a texel to prevent filtering from neighboring cells
+	Ogre::Matrix4 xform = Ogre::Matrix4::IDENTITY;
+	xform[0][0] = (atlas->cell_width - 1) / width;
+	xform[1][1] = (atlas->cell_height - 1) / height;
+	xform[0][3] = ((cell % atlas->columns) * atlas->cell_width + 0.5) / width;
+	xform[1][3] = ((cell / atlas->columns) * atlas->cell_height + 0.5) / height;
+	state->setTextureTransform(xform);
+
+	return true;
+}
+
 }
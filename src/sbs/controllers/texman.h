@@ -27,9 +27,23 @@
 #include <OgreOverlayPrerequisites.h>
 #include <OgreColourValue.h>
 #include <OgreFont.h>
+#include <unordered_map>
 
 namespace SBS {
 
+//a set of textures packed into a single texture, in a grid of equally-sized cells
+struct SBSIMPEXP TextureAtlas
+{
+	std::string name; //atlas name
+	std::string texture; //atlas texture name
+	std::unordered_map<std::string, int> cells; //cell index of each packed texture
+	int columns;
+	int rows;
+	int cell_width; //cell size in pixels
+	int cell_height;
+	bool has_alpha;
+};
+
 class SBSIMPEXP TextureManager : public Object
 {
 public:
@@ -94,6 +108,7 @@ public:
 	void FreeTextureBoxes();
 	void SetPlanarRotate(bool value);
 	bool GetPlanarRotate();
+	int GetDefaultMapper() { return DefaultMapper; }
 	bool ComputeTextureMap(Matrix3 &t_matrix, Vector3 &t_vector, PolyArray &vertices, const Vector3 &p1, const Vector3 &p2, const Vector3 &p3, Real tw, Real th);
 	void EnableLighting(const std::string &material_name, bool value);
 	void EnableShadows(const std::string &material_name, bool value);
@@ -111,6 +126,14 @@ public:
 	void StopSlideshow(const std::string &name);
 	void StartAllSlideshows();
 	void StopAllSlideshows();
+	TextureAtlas* CreateAtlas(const std::string &name, const std::vector<std::string> &textures);
+	TextureAtlas* GetAtlas(const std::string &name);
+	bool CreateAtlasMaterial(TextureAtlas *atlas, const std::string &name);
+	bool SetAtlasCell(Ogre::MaterialPtr material, TextureAtlas *atlas, const std::string &texture);
+	void FinishTextures();
+	void ReleaseTexturePool();
+	int GetPendingTextureCount() { return (int)pending_images.size(); }
+	bool IsTexturePending(Ogre::TexturePtr texture);
 
 
 	//override textures
@@ -145,7 +168,8 @@ private:
 
 	void BackupMapping();
 	bool WriteToTexture(const std::string &str, Ogre::TexturePtr destTexture, int destLeft, int destTop, int destRight, int destBottom, Ogre::FontPtr font, const Ogre::ColourValue &color, char justify = 'l', char vert_justify = 't', bool wordwrap = true);
-	Ogre::TexturePtr LoadTexture(const std::string &filename, int mipmaps, bool &has_alpha, bool use_alpha_color = false, Ogre::ColourValue alpha_color = Ogre::ColourValue::Black);
+	Ogre::TexturePtr LoadTexture(const std::string &filename, int mipmaps, bool &has_alpha, bool use_alpha_color = false, Ogre::ColourValue alpha_color = Ogre::ColourValue::Black, bool background = false);
+	void AddPendingMaterial(const std::string &name, Ogre::MaterialPtr material, size_t first_image);
 	void UnloadMaterials();
 	bool ComputeTextureSpace(Matrix3 &m, Vector3 &v, const Vector3 &origin, const Vector3 &u_point, Real u_length, const Vector3 &v_point, Real v_length);
 	void Report(const std::string &message);
@@ -183,6 +207,23 @@ private:
 		bool has_alpha;
 	};
 	std::vector<Slideshow*> slideshows;
+
+	//texture atlases
+	std::vector<TextureAtlas*> atlases;
+	static const int MaxAtlasSize = 4096;
+
+	//background texture loading
+	ThreadPool *texture_pool; //decodes texture images while a building loads; created on first use, and released by ReleaseTexturePool()
+	int texture_threads; //decoding thread setting, or 1 if disabled
+	std::vector<TextureImage*> pending_images; //images waiting to be uploaded
+	struct PendingMaterial
+	{
+		std::string name; //registered texture name
+		Ogre::MaterialPtr material;
+		size_t first_image; //range of the material's images in pending_images
+		size_t last_image;
+	};
+	std::vector<PendingMaterial> pending_materials; //materials waiting for their images
 };
 
 }
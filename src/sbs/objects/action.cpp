@@ -60,6 +60,7 @@ Action::Action(Object *parent, const std::string &name, std::vector<Object*> &ac
 		TrimString(command_parameters[i]);
 	}
 	parent_objects = action_parents;
+	Resolve();
 }
 
 Action::Action(Object *parent, const std::string &name, std::vector<Object*> &action_parents, const std::string &command) : ObjectBase(parent)
@@ -72,6 +73,7 @@ Action::Action(Object *parent, const std::string &name, std::vector<Object*> &ac
 	SetCase(command_name, false);
 
 	parent_objects = action_parents;
+	Resolve();
 }
 
 Action::~Action()
@@ -97,14 +99,230 @@ bool Action::DoAction(Object *caller, bool &hold)
 		if (!parent_objects[i])
 			continue;
 
-		bool result2 = Run(caller, parent_objects[i], hold);
+		bool result2 = Run(caller, parent_objects[i], parent_types[i], hold);
 		if (result2 == true)
 			result = true;
 	}
 	return result;
 }
 
-bool Action::Run(Object *caller, Object *parent, bool &hold)
+void Action::Resolve()
+{
+	//resolve the command name into a command type and its values, so that running
+	//the action doesn't need to compare strings
+
+	command = cmdNone;
+	door_command = doorNone;
+	command_number = 0;
+	door_number = 0;
+	command_input = "";
+
+	parent_types.resize(parent_objects.size());
+	for (size_t i = 0; i < parent_objects.size(); i++)
+		parent_types[i] = GetTargetType(parent_objects[i]);
+
+	//numeric commands are floor selections
+	if (IsNumeric(command_name) == true)
+	{
+		command = cmdFloor;
+		command_number = ToInt(command_name);
+		return;
+	}
+
+	//elevator door commands, matched by prefix in this order, with an optional door number
+	static const struct
+	{
+		const char *prefix;
+		DoorCommand type;
+	} door_commands[] =
+	{
+		{"openintmanual", doorOpenIntManual},
+		{"closeintmanual", doorCloseIntManual},
+		{"openextmanual", doorOpenExtManual},
+		{"closeextmanual", doorCloseExtManual},
+		{"openmanual", doorOpenManual},
+		{"closemanual", doorCloseManual},
+		{"openint", doorOpenInt},
+		{"closeint", doorCloseInt},
+		{"openext", doorOpenExt},
+		{"closeext", doorCloseExt},
+		{"open", doorOpen},
+		{"close", doorClose},
+		{"stopdoors", doorStop},
+		{"hold", doorHold},
+		{"sensoron", doorSensorOn},
+		{"sensoroff", doorSensorOff},
+		{"sensorreset", doorSensorReset},
+		{"sensor", doorSensor},
+		{"reset", doorReset}
+	};
+
+	for (size_t i = 0; i < sizeof(door_commands) / sizeof(door_commands[0]); i++)
+	{
+		std::string prefix = door_commands[i].prefix;
+		if (StartsWith(command_name, prefix) == true)
+		{
+			door_command = door_commands[i].type;
+			if (command_name.length() > prefix.length())
+				door_number = ToInt(command_name.substr(prefix.length()));
+			break;
+		}
+	}
+
+	//other commands
+	static const struct
+	{
+		const char *name;
+		Command type;
+	} commands[] =
+	{
+		{"off", cmdOff},
+		{"on", cmdOn},
+		{"cancel", cmdCancel},
+		{"run", cmdRun},
+		{"stop", cmdStop},
+		{"estop", cmdEStop},
+		{"alarm", cmdAlarm},
+		{"fire2off", cmdFire2Off},
+		{"fire2on", cmdFire2On},
+		{"fire2hold", cmdFire2Hold},
+		{"uppeakon", cmdUpPeakOn},
+		{"uppeakoff", cmdUpPeakOff},
+		{"downpeakon", cmdDownPeakOn},
+		{"downpeakoff", cmdDownPeakOff},
+		{"peakoff", cmdPeakOff},
+		{"indon", cmdIndOn},
+		{"indoff", cmdIndOff},
+		{"inson", cmdInsOn},
+		{"insoff", cmdInsOff},
+		{"acpon", cmdAcpOn},
+		{"acpoff", cmdAcpOff},
+		{"fanon", cmdFanOn},
+		{"fanoff", cmdFanOff},
+		{"musicon", cmdMusicOn},
+		{"musicoff", cmdMusicOff},
+		{"upon", cmdUpOn},
+		{"upoff", cmdUpOff},
+		{"downon", cmdDownOn},
+		{"downoff", cmdDownOff},
+		{"insupon", cmdInsUpOn},
+		{"insupoff", cmdInsUpOff},
+		{"insdownon", cmdInsDownOn},
+		{"insdownoff", cmdInsDownOff},
+		{"goon", cmdGoOn},
+		{"gooff", cmdGoOff},
+		{"return", cmdReturn},
+		{"up", cmdUp},
+		{"down", cmdDown},
+		{"interlockson", cmdInterlocksOn},
+		{"interlocksoff", cmdInterlocksOff},
+		{"fire1off", cmdFire1Off},
+		{"fire1on", cmdFire1On},
+		{"fire1bypass", cmdFire1Bypass},
+		{"openshaftdoor", cmdOpenShaftDoor},
+		{"closeshaftdoor", cmdCloseShaftDoor},
+		{"openshaftdoormanual", cmdOpenShaftDoorManual},
+		{"closeshaftdoormanual", cmdCloseShaftDoorManual},
+		{"accessdown", cmdAccessDown},
+		{"accessup", cmdAccessUp},
+		{"accessoff", cmdAccessOff},
+		{"inputminus", cmdInput},
+		{"inputstar", cmdInput},
+		{"inputbackspace", cmdInput},
+		{"inputenter", cmdInputEnter},
+		{"inputclear", cmdInputClear},
+		{"fireoff", cmdFireOff},
+		{"fireon", cmdFireOn},
+		{"firebypass", cmdFireBypass},
+		{"pressup", cmdPressUp},
+		{"pressdown", cmdPressDown},
+		{"forward", cmdForward},
+		{"reverse", cmdReverse},
+		{"enable", cmdEnable},
+		{"disable", cmdDisable},
+		{"open", cmdOpen},
+		{"close", cmdClose},
+		{"autoclose", cmdAutoClose},
+		{"startslideshow", cmdStartSlideshow},
+		{"stopslideshow", cmdStopSlideshow},
+		{"settexture", cmdSetTexture},
+		{"changetexture", cmdChangeTexture},
+		{"playsound", cmdPlaySound},
+		{"stopsound", cmdStopSound},
+		{"teleport", cmdTeleport},
+		{"gotofloor", cmdGotoFloor}
+	};
+
+	for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+	{
+		if (command_name == commands[i].name)
+		{
+			command = commands[i].type;
+			break;
+		}
+	}
+
+	//keypad input values
+	if (command_name == "inputminus")
+		command_input = "-";
+	else if (command_name == "inputstar")
+		command_input = "*";
+	else if (command_name == "inputbackspace")
+		command_input = "<";
+	else if (command_name.length() == 6 && StartsWith(command_name, "input") == true)
+	{
+		char key = command_name[5];
+		if ((key >= '0' && key <= '9') || (key >= 'a' && key <= 'z'))
+		{
+			command = cmdInput;
+			command_input = std::string(1, (char)toupper(key));
+		}
+	}
+}
+
+Action::TargetType Action::GetTargetType(Object *parent)
+{
+	//get the type of a parent object, for dispatching commands
+
+	if (!parent)
+		return targetOther;
+
+	std::string type = parent->GetType();
+
+	if (type == "SBS")
+		return targetSBS;
+	if (type == "Mesh")
+		return targetMesh;
+	if (dynamic_cast<Elevator*>(parent))
+		return targetElevator;
+	if (dynamic_cast<ElevatorCar*>(parent))
+		return targetElevatorCar;
+	if (dynamic_cast<Floor*>(parent))
+		return targetFloor;
+	if (dynamic_cast<Shaft*>(parent))
+		return targetShaft;
+	if (dynamic_cast<Stairwell*>(parent))
+		return targetStairwell;
+	if (dynamic_cast<CallStation*>(parent))
+		return targetCallStation;
+	if (dynamic_cast<Escalator*>(parent))
+		return targetEscalator;
+	if (dynamic_cast<MovingWalkway*>(parent))
+		return targetWalkway;
+	if (dynamic_cast<CameraTexture*>(parent))
+		return targetCameraTexture;
+	if (dynamic_cast<Light*>(parent))
+		return targetLight;
+	if (dynamic_cast<Door*>(parent))
+		return targetDoor;
+	if (dynamic_cast<RevolvingDoor*>(parent))
+		return targetRevolvingDoor;
+	if (dynamic_cast<TextureManager*>(parent))
+		return targetTextureManager;
+	return targetOther;
+}
+
+bool Action::Run(Object *caller, Object *parent, TargetType type, bool &hold)
 {
 	//Supported action names:
 
@@ -249,721 +467,122 @@ bool Action::Run(Object *caller, Object *parent, bool &hold)
 
 	SBS_PROFILE("Action::Run");
 
-	Elevator *elevator = dynamic_cast<Elevator*>(parent);
-	ElevatorCar *car = dynamic_cast<ElevatorCar*>(parent);
-	Floor *floor = dynamic_cast<Floor*>(parent);
-	Shaft *shaft = dynamic_cast<Shaft*>(parent);
-	Stairwell *stairs = dynamic_cast<Stairwell*>(parent);
-	CallStation *callstation = dynamic_cast<CallStation*>(parent);
-	Escalator *escalator = dynamic_cast<Escalator*>(parent);
-	MovingWalkway *walkway = dynamic_cast<MovingWalkway*>(parent);
-	CameraTexture *camtex = dynamic_cast<CameraTexture*>(parent);
-	Light *light = dynamic_cast<Light*>(parent);
-	Door *door = dynamic_cast<Door*>(parent);
-	RevolvingDoor *revdoor = dynamic_cast<RevolvingDoor*>(parent);
-	TextureManager *texman = dynamic_cast<TextureManager*>(parent);
-
-	std::string caller_name = caller->GetName();
-	std::string caller_type = caller->GetType();
-
-	std::string parent_name = parent->GetName();
-	std::string parent_type = parent->GetType();
-
 	hold = false;
 
 	//report the action used
-	Report("Action '" + GetName() + "': object '" + parent_name + "' using command '" + command_name + "'");
+	if (sbs->Verbose)
+		Report("Action '" + GetName() + "': object '" + parent->GetName() + "' using command '" + command_name + "'");
 
-	//if parent is an elevator object, also use default (first) car as car object
-	if (elevator)
-		car = elevator->GetCar(1);
-	//if parent is an elevator car, get parent elevator object
-	else if (car)
-		elevator = car->GetElevator();
+	bool result = false;
+	Elevator *elevator = 0;
+	ElevatorCar *car = 0;
 
-	//elevator-specific commands
-	if (elevator && car)
+	//object-specific commands
+	switch (type)
 	{
-		//numeric commands for elevator floor selections
-		if (IsNumeric(command_name) == true)
-		{
-			int floor = ToInt(command_name);
-			return elevator->SelectFloor(floor);
-		}
-
-		//get first call station on recall floor
-		CallStation *station = elevator->GetPrimaryCallStation();
-
-		//if called from a control and mouse button is held down, notify elevator
-		if (caller_type == "Control" && sbs->camera->MouseDown() == true)
-			car->ControlPressActive = true;
-
-		if (command_name == "off")
-			return true;
-
-		//if (!(elevator->FireServicePhase1 == 1 && elevator->FireServicePhase2 == 0))
-		//{
-			if (StartsWith(command_name, "openintmanual", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 13)
-					number = ToInt(command_name.substr(13, command_name.length() - 13));
-				return car->OpenDoors(number, 2, 0, true);
-			}
-			if (StartsWith(command_name, "closeintmanual", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 14)
-					number = ToInt(command_name.substr(14, command_name.length() - 14));
-				car->CloseDoors(number, 2, 0, true);
-				return true;
-			}
-			if (StartsWith(command_name, "openextmanual", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 13)
-					number = ToInt(command_name.substr(13, command_name.length() - 13));
-				return car->OpenDoors(number, 3, 0, true);
-			}
-			if (StartsWith(command_name, "closeextmanual", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 14)
-					number = ToInt(command_name.substr(14, command_name.length() - 14));
-				car->CloseDoors(number, 3, 0, true);
-				return true;
-			}
-			if (StartsWith(command_name, "openmanual", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 10)
-					number = ToInt(command_name.substr(10, command_name.length() - 10));
-				return car->OpenDoors(number, 1, 0, true);
-			}
-			if (StartsWith(command_name, "closemanual", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 11)
-					number = ToInt(command_name.substr(11, command_name.length() - 11));
-				car->CloseDoors(number, 1, 0, true);
-				return true;
-			}
-			if (StartsWith(command_name, "openint", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 7)
-					number = ToInt(command_name.substr(7, command_name.length() - 7));
-				return car->OpenDoors(number, 2, 0, false);
-			}
-			if (StartsWith(command_name, "closeint", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 8)
-					number = ToInt(command_name.substr(8, command_name.length() - 8));
-				car->CloseDoors(number, 2, 0, false);
-				return true;
-			}
-			if (StartsWith(command_name, "openext", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 7)
-					number = ToInt(command_name.substr(7, command_name.length() - 7));
-				return car->OpenDoors(number, 3, car->GetFloor(), false);
-			}
-			if (StartsWith(command_name, "closeext", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 8)
-					number = ToInt(command_name.substr(8, command_name.length() - 8));
-				car->CloseDoors(number, 3, car->GetFloor(), false);
-				return true;
-			}
-			if (StartsWith(command_name, "open", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 4)
-					number = ToInt(command_name.substr(4, command_name.length() - 4));
-				return car->OpenDoors(number);
-			}
-			if (StartsWith(command_name, "close", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 5)
-					number = ToInt(command_name.substr(5, command_name.length() - 5));
-				car->CloseDoors(number);
-				return true;
-			}
-			if (StartsWith(command_name, "stopdoors", false) == true && elevator->Direction == 0)
-			{
-				int number = 0;
-				if (command_name.length() > 9)
-					number = ToInt(command_name.substr(9, command_name.length() - 9));
-				car->StopDoors(number);
-				return true;
-			}
-		//}
-		if (command_name == "cancel")
-		{
-			if (elevator->FireServicePhase2 == 1)
-				return elevator->CallCancelAll();
-			else if (elevator->IndependentService == true)
-				return elevator->CallCancelAll();
-			else
-				return elevator->CallCancel();
-		}
-		if (command_name == "run")
-		{
-			elevator->SetRunState(true);
-			return true;
-		}
-		if (command_name == "stop")
-		{
-			elevator->SetRunState(false);
-			return true;
-		}
-		if (command_name == "estop")
-			return elevator->Stop(true);
-		if (command_name == "alarm")
-		{
-			car->Alarm();
-			return true;
-		}
-		if (command_name == "fire2off")
-			return elevator->EnableFireService2(0, car->Number);
-		if (command_name == "fire2on")
-			return elevator->EnableFireService2(1, car->Number);
-		if (command_name == "fire2hold")
-			return elevator->EnableFireService2(2, car->Number);
-		if (command_name == "uppeakon")
-			return elevator->EnableUpPeak(true);
-		if (command_name == "uppeakoff")
-			return elevator->EnableUpPeak(false);
-		if (command_name == "downpeakon")
-			return elevator->EnableDownPeak(true);
-		if (command_name == "downpeakoff")
-			return elevator->EnableDownPeak(false);
-		if (command_name == "peakoff")
-		{
-			elevator->EnableDownPeak(false);
-			elevator->EnableUpPeak(false);
-			return true;
-		}
-		if (command_name == "indon")
-			return elevator->EnableIndependentService(true, car->Number);
-		if (command_name == "indoff")
-			return elevator->EnableIndependentService(false, car->Number);
-		if (command_name == "inson")
-			return elevator->EnableInspectionService(true);
-		if (command_name == "insoff")
-			return elevator->EnableInspectionService(false);
-		if (command_name == "acpon")
-			return elevator->EnableACP(true);
-		if (command_name == "acpoff")
-			return elevator->EnableACP(false);
-		if (command_name == "fanon")
-		{
-			car->Fan = true;
-			return true;
-		}
-		if (command_name == "fanoff")
-		{
-			car->Fan = false;
-			return true;
-		}
-		if (command_name == "musicon")
-		{
-			car->MusicOn = true;
-			return true;
-		}
-		if (command_name == "musicoff")
-		{
-			car->MusicOn = false;
-			return true;
-		}
-		if (command_name == "upon")
-		{
-			if (elevator->InspectionService == true)
-				return elevator->SetUpButton(true);
-			else
-				return elevator->Up(true);
-		}
-		if (command_name == "upoff")
-		{
-			if (elevator->InspectionService == true)
-				return elevator->SetUpButton(false);
-			else
-				return elevator->Up(false);
-		}
-		if (command_name == "downon")
-		{
-			if (elevator->InspectionService == true)
-				return elevator->SetDownButton(true);
-			else
-				return elevator->Down(true);
-		}
-		if (command_name == "downoff")
-		{
-			if (elevator->InspectionService == true)
-				return elevator->SetDownButton(false);
-			else
-				return elevator->Down(false);
-		}
-		if (elevator->InspectionService == true)
-		{
-			if (command_name == "insupon")
-				return elevator->SetUpButton(true);
-			if (command_name == "insupoff")
-				return elevator->SetUpButton(false);
-			if (command_name == "insdownon")
-				return elevator->SetDownButton(true);
-			if (command_name == "insdownoff")
-				return elevator->SetDownButton(false);
-		}
-		if (command_name == "goon")
-			return elevator->SetGoButton(true);
-		if (command_name == "gooff")
-			return elevator->SetGoButton(false);
-		if (command_name == "return")
-			return elevator->ReturnToNearestFloor();
-		if (command_name == "up")
-			return elevator->Up();
-		if (command_name == "down")
-			return elevator->Down();
-		if (command_name == "interlockson")
-		{
-			elevator->Interlocks = true;
-			return true;
-		}
-		if (command_name == "interlocksoff")
-		{
-			elevator->Interlocks = false;
-			return true;
-		}
-
-		if (station)
-		{
-			if (command_name == "fire1off")
-				return station->FireService(0);
-			if (command_name == "fire1on")
-				return station->FireService(1);
-			if (command_name == "fire1bypass")
-				return station->FireService(2);
-		}
-
-		if (StartsWith(command_name, "hold", false) == true && elevator->Direction == 0)
-		{
-			int number = 0;
-			if (command_name.length() > 4)
-				number = ToInt(command_name.substr(4, command_name.length() - 4));
-			car->HoldDoors(number);
-			return true;
-		}
-		if (StartsWith(command_name, "sensoron", false) == true)
-		{
-			int number = 0;
-			if (command_name.length() > 8)
-				number = ToInt(command_name.substr(8, command_name.length() - 8));
-			car->EnableSensor(true, number);
-			return true;
-		}
-		if (StartsWith(command_name, "sensoroff", false) == true)
-		{
-			int number = 0;
-			if (command_name.length() > 9)
-				number = ToInt(command_name.substr(9, command_name.length() - 9));
-			car->EnableSensor(false, number);
-			return true;
-		}
-		if (StartsWith(command_name, "sensorreset", false) == true && elevator->Direction == 0)
-		{
-			int number = 0;
-			if (command_name.length() > 11)
-				number = ToInt(command_name.substr(11, command_name.length() - 11));
-			car->ResetDoors(number, true);
-			return true;
-		}
-		if (StartsWith(command_name, "sensor", false) == true && elevator->Direction == 0)
-		{
-			int number = 0;
-			if (command_name.length() > 6)
-				number = ToInt(command_name.substr(6, command_name.length() - 6));
-			car->OpenDoors(number);
-			car->HoldDoors(number, true);
-			return true;
-		}
-		if (StartsWith(command_name, "reset", false) == true && elevator->Direction == 0)
-		{
-			int number = 0;
-			if (command_name.length() > 5)
-				number = ToInt(command_name.substr(5, command_name.length() - 5));
-			car->ResetDoors(number);
-			return true;
-		}
-		if (command_name == "openshaftdoor")
-		{
-			if ((int)command_parameters.size() == 2)
-			{
-				int param1 = 0, param2 = 0;
-				if (IsNumeric(command_parameters[0], param1) && IsNumeric(command_parameters[1], param2))
-					return car->OpenDoors(param1, 3, param2, false);
-			}
-			return false;
-		}
-		if (command_name == "closeshaftdoor")
-		{
-			if ((int)command_parameters.size() == 2)
-			{
-				int param1 = 0, param2 = 0;
-				if (IsNumeric(command_parameters[0], param1) && IsNumeric(command_parameters[1], param2))
-				{
-					car->CloseDoors(param1, 3, param2, false);
-					return true;
-				}
-			}
-			return false;
-		}
-		if (command_name == "openshaftdoormanual")
-		{
-			if ((int)command_parameters.size() == 2)
-			{
-				int param1 = 0, param2 = 0;
-				if (IsNumeric(command_parameters[0], param1) && IsNumeric(command_parameters[1], param2))
-					return car->OpenDoors(param1, 3, param2, true);
-			}
-			return false;
-		}
-		if (command_name == "closeshaftdoormanual")
-		{
-			if ((int)command_parameters.size() == 2)
-			{
-				int param1 = 0, param2 = 0;
-				if (IsNumeric(command_parameters[0], param1) && IsNumeric(command_parameters[1], param2))
-				{
-					car->CloseDoors(param1, 3, param2, true);
-					return true;
-				}
-			}
-			return false;
-		}
-		if (command_name == "accessdown")
-		{
-			if ((int)command_parameters.size() == 1)
-			{
-				int param = 0;
-				if (IsNumeric(command_parameters[0], param))
-				{
-					hold = elevator->HoistwayAccessHold;
-					return elevator->SetHoistwayAccess(param, -1);
-				}
-			}
-			return false;
-		}
-		if (command_name == "accessup")
-		{
-			if ((int)command_parameters.size() == 1)
-			{
-				int param = 0;
-				if (IsNumeric(command_parameters[0], param))
-				{
-					hold = elevator->HoistwayAccessHold;
-					return elevator->SetHoistwayAccess(param, 1);
-				}
-			}
-			return false;
-		}
-		if (command_name == "accessoff")
-		{
-			if ((int)command_parameters.size() == 1)
-			{
-				int param = 0;
-				if (IsNumeric(command_parameters[0], param))
-					return elevator->SetHoistwayAccess(param, 0);
-			}
-			return false;
-		}
-
-		if (command_name == "input1")
-			return car->Input("1");
-		if (command_name == "input2")
-			return car->Input("2");
-		if (command_name == "input3")
-			return car->Input("3");
-		if (command_name == "input4")
-			return car->Input("4");
-		if (command_name == "input5")
-			return car->Input("5");
-		if (command_name == "input6")
-			return car->Input("6");
-		if (command_name == "input7")
-			return car->Input("7");
-		if (command_name == "input8")
-			return car->Input("8");
-		if (command_name == "input9")
-			return car->Input("9");
-		if (command_name == "input0")
-			return car->Input("0");
-		if (command_name == "inputminus")
-			return car->Input("-");
-		if (command_name == "inputstar")
-			return car->Input("*");
-		if (command_name == "inputbackspace")
-			return car->Input("<");
-		if (command_name == "inputenter")
-			return car->KeypadEnter();
-		if (command_name == "inputclear")
-			return car->KeypadClear();
-		if (command_name == "inputa")
-			return car->Input("A");
-		if (command_name == "inputb")
-			return car->Input("B");
-		if (command_name == "inputc")
-			return car->Input("C");
-		if (command_name == "inputd")
-			return car->Input("D");
-		if (command_name == "inpute")
-			return car->Input("E");
-		if (command_name == "inputf")
-			return car->Input("F");
-		if (command_name == "inputg")
-			return car->Input("G");
-		if (command_name == "inputh")
-			return car->Input("H");
-		if (command_name == "inputi")
-			return car->Input("I");
-		if (command_name == "inputj")
-			return car->Input("J");
-		if (command_name == "inputk")
-			return car->Input("K");
-		if (command_name == "inputl")
-			return car->Input("L");
-		if (command_name == "inputm")
-			return car->Input("M");
-		if (command_name == "inputn")
-			return car->Input("N");
-		if (command_name == "inputo")
-			return car->Input("O");
-		if (command_name == "inputp")
-			return car->Input("P");
-		if (command_name == "inputq")
-			return car->Input("Q");
-		if (command_name == "inputr")
-			return car->Input("R");
-		if (command_name == "inputs")
-			return car->Input("S");
-		if (command_name == "inputt")
-			return car->Input("T");
-		if (command_name == "inputu")
-			return car->Input("U");
-		if (command_name == "inputv")
-			return car->Input("V");
-		if (command_name == "inputw")
-			return car->Input("W");
-		if (command_name == "inputx")
-			return car->Input("X");
-		if (command_name == "inputy")
-			return car->Input("Y");
-		if (command_name == "inputz")
-			return car->Input("Z");
-	}
+	case targetElevator:
+		//if parent is an elevator object, also use default (first) car as car object
+		elevator = static_cast<Elevator*>(parent);
+		car = elevator->GetCar(1);
+		if (car && RunElevator(caller, elevator, car, hold, result) == true)
+			return result;
+		break;
 
-	//if parent is a call station, get parent floor object
-	if (callstation)
-		floor = sbs->GetFloor(callstation->GetFloor());
+	case targetElevatorCar:
+		//if parent is an elevator car, get parent elevator object
+		car = static_cast<ElevatorCar*>(parent);
+		elevator = car->GetElevator();
+		if (elevator && RunElevator(caller, elevator, car, hold, result) == true)
+			return result;
+		break;
 
-	//callstation-specific commands
-	if (floor && callstation)
+	case targetCallStation:
 	{
-		if (command_name == "off")
-			return false;
-		//numeric commands for station floor selections
-		if (IsNumeric(command_name) == true)
-		{
-			int floor = ToInt(command_name);
-			return callstation->SelectFloor(floor);
-		}
-		if (command_name == "fireoff")
-			return callstation->FireService(0);
-		if (command_name == "fireon")
-			return callstation->FireService(1);
-		if (command_name == "firebypass")
-			return callstation->FireService(2);
-		if (command_name == "input1")
-			return callstation->Input("1");
-		if (command_name == "input2")
-			return callstation->Input("2");
-		if (command_name == "input3")
-			return callstation->Input("3");
-		if (command_name == "input4")
-			return callstation->Input("4");
-		if (command_name == "input5")
-			return callstation->Input("5");
-		if (command_name == "input6")
-			return callstation->Input("6");
-		if (command_name == "input7")
-			return callstation->Input("7");
-		if (command_name == "input8")
-			return callstation->Input("8");
-		if (command_name == "input9")
-			return callstation->Input("9");
-		if (command_name == "input0")
-			return callstation->Input("0");
-		if (command_name == "inputminus")
-			return callstation->Input("-");
-		if (command_name == "inputstar")
-			return callstation->Input("*");
-		if (command_name == "inputbackspace")
-			return callstation->Input("<");
-		if (command_name == "inputenter")
-			return callstation->KeypadEnter();
-		if (command_name == "inputclear")
-			return callstation->KeypadClear();
-		if (command_name == "up")
-			return callstation->Call(true);
-		if (command_name == "down")
-			return callstation->Call(false);
-		if (command_name == "pressup")
-			return callstation->Press(true);
-		if (command_name == "pressdown")
-			return callstation->Press(false);
-		if (command_name == "inputa")
-			return callstation->Input("A");
-		if (command_name == "inputb")
-			return callstation->Input("B");
-		if (command_name == "inputc")
-			return callstation->Input("C");
-		if (command_name == "inputd")
-			return callstation->Input("D");
-		if (command_name == "inpute")
-			return callstation->Input("E");
-		if (command_name == "inputf")
-			return callstation->Input("F");
-		if (command_name == "inputg")
-			return callstation->Input("G");
-		if (command_name == "inputh")
-			return callstation->Input("H");
-		if (command_name == "inputi")
-			return callstation->Input("I");
-		if (command_name == "inputj")
-			return callstation->Input("J");
-		if (command_name == "inputk")
-			return callstation->Input("K");
-		if (command_name == "inputl")
-			return callstation->Input("L");
-		if (command_name == "inputm")
-			return callstation->Input("M");
-		if (command_name == "inputn")
-			return callstation->Input("N");
-		if (command_name == "inputo")
-			return callstation->Input("O");
-		if (command_name == "inputp")
-			return callstation->Input("P");
-		if (command_name == "inputq")
-			return callstation->Input("Q");
-		if (command_name == "inputr")
-			return callstation->Input("R");
-		if (command_name == "inputs")
-			return callstation->Input("S");
-		if (command_name == "inputt")
-			return callstation->Input("T");
-		if (command_name == "inputu")
-			return callstation->Input("U");
-		if (command_name == "inputv")
-			return callstation->Input("V");
-		if (command_name == "inputw")
-			return callstation->Input("W");
-		if (command_name == "inputx")
-			return callstation->Input("X");
-		if (command_name == "inputy")
-			return callstation->Input("Y");
-		if (command_name == "inputz")
-			return callstation->Input("Z");
+		CallStation *callstation = static_cast<CallStation*>(parent);
+		if (sbs->GetFloor(callstation->GetFloor()) && RunCallStation(callstation, result) == true)
+			return result;
+		break;
 	}
 
-	//escalator-specific commands
-	if (escalator)
+	case targetEscalator:
 	{
-		if (command_name == "forward")
+		Escalator *escalator = static_cast<Escalator*>(parent);
+		if (command == cmdForward)
 		{
 			escalator->SetRun(1);
 			return true;
 		}
-		if (command_name == "reverse")
+		if (command == cmdReverse)
 		{
 			escalator->SetRun(-1);
 			return true;
 		}
-		if (command_name == "stop")
+		if (command == cmdStop)
 		{
 			escalator->SetRun(0);
 			return true;
 		}
+		break;
 	}
 
-	//moving walkway-specific commands
-	if (walkway)
+	case targetWalkway:
 	{
-		if (command_name == "forward")
+		MovingWalkway *walkway = static_cast<MovingWalkway*>(parent);
+		if (command == cmdForward)
 		{
 			walkway->SetRun(1);
 			return true;
 		}
-		if (command_name == "reverse")
+		if (command == cmdReverse)
 		{
 			walkway->SetRun(-1);
 			return true;
 		}
-		if (command_name == "stop")
+		if (command == cmdStop)
 		{
 			walkway->SetRun(0);
 			return true;
 		}
+		break;
 	}
 
-	//cameratexture-specific commands
-	if (camtex)
+	case targetCameraTexture:
 	{
-		if (command_name == "enable")
+		CameraTexture *camtex = static_cast<CameraTexture*>(parent);
+		if (command == cmdEnable || command == cmdDisable)
 		{
-			camtex->Enabled(true);
-			return true;
-		}
-		if (command_name == "disable")
-		{
-			camtex->Enabled(false);
+			camtex->Enabled(command == cmdEnable);
 			return true;
 		}
+		break;
 	}
 
-	//light-specific commands
-	if (light)
+	case targetLight:
 	{
-		if (command_name == "on")
+		Light *light = static_cast<Light*>(parent);
+		if (command == cmdOn || command == cmdOff)
 		{
-			light->Enabled(true);
-			return true;
-		}
-		if (command_name == "off")
-		{
-			light->Enabled(false);
+			light->Enabled(command == cmdOn);
 			return true;
 		}
+		break;
 	}
 
-	//door-specific commands
-	if (door)
+	case targetDoor:
 	{
-		if (command_name == "open")
+		Door *door = static_cast<Door*>(parent);
+		if (command == cmdOpen)
 		{
 			Vector3 pos = door->GetPosition();
 			door->Open(pos);
 			return true;
 		}
-		if (command_name == "close")
+		if (command == cmdClose)
 		{
 			door->Close();
 			return true;
 		}
-		if (command_name == "autoclose")
+		if (command == cmdAutoClose)
 		{
 			if ((int)command_parameters.size() == 1)
 			{
@@ -973,173 +592,122 @@ bool Action::Run(Object *caller, Object *parent, bool &hold)
 			}
 			return true;
 		}
+		break;
+	}
+
+	case targetRevolvingDoor:
+	{
+		RevolvingDoor *revdoor = static_cast<RevolvingDoor*>(parent);
+		if (command == cmdOn || command == cmdOff)
+		{
+			revdoor->Run(command == cmdOn);
+			return true;
+		}
+		break;
 	}
 
-	//revolvingdoor-specific commands
-	if (revdoor)
+	case targetTextureManager:
 	{
-		if (command_name == "on")
+		TextureManager *texman = static_cast<TextureManager*>(parent);
+		if (command == cmdStartSlideshow)
 		{
-			revdoor->Run(true);
+			if ((int)command_parameters.size() != 1)
+				return false;
+			texman->StartSlideshow(command_parameters[0]);
 			return true;
 		}
-		if (command_name == "off")
+		if (command == cmdStopSlideshow)
 		{
-			revdoor->Run(false);
+			if ((int)command_parameters.size() != 1)
+				return false;
+			texman->StopSlideshow(command_parameters[0]);
 			return true;
 		}
+		if (command == cmdSetTexture)
+		{
+			if ((int)command_parameters.size() != 2)
+				return false;
+			texman->SetTexture(command_parameters[0], command_parameters[1]);
+			return true;
+		}
+		break;
 	}
 
-	//texture manager commands
-	if (texman)
+	default:
+		break;
+	}
+
+	//general commands
+	switch (command)
+	{
+	case cmdChangeTexture:
 	{
-		if (command_name == "startslideshow")
+		if ((int)command_parameters.size() != 2)
+			return false;
+
+		const std::string &oldtexture = command_parameters[0];
+		const std::string &newtexture = command_parameters[1];
+
+		if (type == targetMesh)
 		{
-			if ((int)command_parameters.size() == 1)
-			{
-				texman->StartSlideshow(command_parameters[0]);
-				return true;
-			}
+			std::string parent_name = parent->GetName();
+			if (parent_name == "External" && sbs->External)
+				return sbs->External->ReplaceTexture(oldtexture, newtexture);
+			if (parent_name == "Landscape")
+				return sbs->Landscape->ReplaceTexture(oldtexture, newtexture);
+			if (parent_name == "Buildings")
+				return sbs->Buildings->ReplaceTexture(oldtexture, newtexture);
 			return false;
 		}
-		if (command_name == "stopslideshow")
+		if (type == targetFloor)
 		{
-			if ((int)command_parameters.size() == 1)
-			{
-				texman->StopSlideshow(command_parameters[0]);
-				return true;
-			}
-			return false;
+			static_cast<Floor*>(parent)->ReplaceTexture(oldtexture, newtexture);
+			return true;
 		}
-		if (command_name == "settexture")
+		if (type == targetElevator || type == targetElevatorCar)
 		{
-			if ((int)command_parameters.size() == 2)
-			{
-				texman->SetTexture(command_parameters[0], command_parameters[1]);
-				return true;
-			}
+			if (elevator && car)
+				return car->ReplaceTexture(oldtexture, newtexture);
 			return false;
 		}
-	}
-
-	if (command_name == "changetexture")
-	{
-		if ((int)command_parameters.size() == 2)
+		if (type == targetShaft)
 		{
-			if (parent_type == "Mesh")
-			{
-				if (parent_name == "External" && sbs->External)
-					return sbs->External->ReplaceTexture(command_parameters[0], command_parameters[1]);
-				if (parent_name == "Landscape")
-					return sbs->Landscape->ReplaceTexture(command_parameters[0], command_parameters[1]);
-				if (parent_name == "Buildings")
-					return sbs->Buildings->ReplaceTexture(command_parameters[0], command_parameters[1]);
-				return false;
-			}
-			if (parent_type == "Floor")
-			{
-				if (floor)
-				{
-					floor->ReplaceTexture(command_parameters[0], command_parameters[1]);
-					return true;
-				}
-				return false;
-			}
-			if (parent_type == "Elevator" || parent_type == "ElevatorCar")
-			{
-				if (elevator && car)
-					return car->ReplaceTexture(command_parameters[0], command_parameters[1]);
-				return false;
-			}
-			if (parent_type == "Shaft")
-			{
-				if (shaft)
-				{
-					shaft->ReplaceTexture(command_parameters[0], command_parameters[1]);
-					return true;
-				}
-				return false;
-			}
-			if (parent_type == "Stairwell")
-			{
-				if (stairs)
-				{
-					stairs->ReplaceTexture(command_parameters[0], command_parameters[1]);
-					return true;
-				}
-				return false;
-			}
+			static_cast<Shaft*>(parent)->ReplaceTexture(oldtexture, newtexture);
+			return true;
 		}
-		return false;
-	}
-
-	if (command_name == "playsound")
-	{
-		if ((int)command_parameters.size() == 2)
+		if (type == targetStairwell)
 		{
-			std::vector<Sound*> soundlist;
-
-			if (parent_type == "SBS")
-				soundlist = sbs->GetSound(command_parameters[0]);
-			else if (parent_type == "Floor")
-			{
-				if (floor)
-					soundlist = floor->GetSound(command_parameters[0]);
-				else
-					return false;
-			}
-			else if (parent_type == "Elevator" || parent_type == "ElevatorCar")
-			{
-				if (elevator && car)
-					soundlist = car->GetSound(command_parameters[0]);
-				else
-					return false;
-			}
-
-			if ((int)soundlist.size() > 0)
-			{
-				for (size_t i = 0; i < soundlist.size(); i++)
-				{
-					if (soundlist[i])
-					{
-						soundlist[i]->SetLoopState(ToBool(command_parameters[1]));
-						bool result = soundlist[i]->Play();
-
-						if ((int)soundlist.size() == 1)
-							return result;
-					}
-				}
-				return true;
-			}
+			static_cast<Stairwell*>(parent)->ReplaceTexture(oldtexture, newtexture);
+			return true;
 		}
 		return false;
 	}
 
-	if (command_name == "stopsound")
+	case cmdPlaySound:
+	case cmdStopSound:
 	{
-		if ((int)command_parameters.size() == 1)
-		{
-			std::vector<Sound*> soundlist;
+		size_t params = (command == cmdPlaySound) ? 2 : 1;
+		if (command_parameters.size() != params)
+			return false;
 
-			if (parent_type == "SBS")
-				soundlist = sbs->GetSound(command_parameters[0]);
-			else if (parent_type == "Floor")
-			{
-				if (floor)
-					soundlist = floor->GetSound(command_parameters[0]);
-				else
-					return false;
-			}
-			else if (parent_type == "Elevator" || parent_type == "ElevatorCar")
-			{
-				if (elevator && car)
-					soundlist = car->GetSound(command_parameters[0]);
-				else
-					return false;
-			}
+		std::vector<Sound*> soundlist;
+
+		if (type == targetSBS)
+			soundlist = sbs->GetSound(command_parameters[0]);
+		else if (type == targetFloor)
+			soundlist = static_cast<Floor*>(parent)->GetSound(command_parameters[0]);
+		else if (type == targetElevator || type == targetElevatorCar)
+		{
+			if (elevator && car)
+				soundlist = car->GetSound(command_parameters[0]);
 			else
 				return false;
+		}
+		else if (command == cmdStopSound)
+			return false;
 
+		if (command == cmdStopSound)
+		{
 			for (size_t i = 0; i < soundlist.size(); i++)
 			{
 				if (soundlist[i])
@@ -1147,27 +715,359 @@ bool Action::Run(Object *caller, Object *parent, bool &hold)
 			}
 			return true;
 		}
-		return false;
+
+		if (soundlist.empty() == true)
+			return false;
+
+		bool loop = ToBool(command_parameters[1]);
+		for (size_t i = 0; i < soundlist.size(); i++)
+		{
+			if (soundlist[i])
+			{
+				soundlist[i]->SetLoopState(loop);
+				bool played = soundlist[i]->Play();
+
+				if ((int)soundlist.size() == 1)
+					return played;
+			}
+		}
+		return true;
+	}
+
+	case cmdTeleport:
+		if ((int)command_parameters.size() != 3)
+			return false;
+		sbs->camera->Teleport(ToFloat(command_parameters[0]), ToFloat(command_parameters[1]), ToFloat(command_parameters[2]));
+		return true;
+
+	case cmdGotoFloor:
+		if ((int)command_parameters.size() != 1)
+			return false;
+		sbs->camera->GotoFloor(ToInt(command_parameters[0]));
+		return true;
+
+	default:
+		break;
+	}
+
+	return false;
+}
+
+bool Action::RunElevator(Object *caller, Elevator *elevator, ElevatorCar *car, bool &hold, bool &result)
+{
+	//run elevator and elevator car commands
+	//returns true if the command was handled, with its status in "result"
+
+	result = false;
+
+	//numeric commands for elevator floor selections
+	if (command == cmdFloor)
+	{
+		result = elevator->SelectFloor(command_number);
+		return true;
 	}
 
-	if (command_name == "teleport")
+	//if called from a control and mouse button is held down, notify elevator
+	if (caller->GetType() == "Control" && sbs->camera->MouseDown() == true)
+		car->ControlPressActive = true;
+
+	if (command == cmdOff)
 	{
-		if ((int)command_parameters.size() == 3)
+		result = true;
+		return true;
+	}
+
+	//door commands run when the elevator is stopped, except for turning sensors on and off
+	if (door_command != doorNone && (elevator->Direction == 0 || door_command == doorSensorOn || door_command == doorSensorOff))
+	{
+		result = true;
+
+		switch (door_command)
 		{
-			sbs->camera->Teleport(ToFloat(command_parameters[0]), ToFloat(command_parameters[1]), ToFloat(command_parameters[2]));
-			return true;
+		case doorOpenIntManual:
+			result = car->OpenDoors(door_number, 2, 0, true);
+			break;
+		case doorCloseIntManual:
+			car->CloseDoors(door_number, 2, 0, true);
+			break;
+		case doorOpenExtManual:
+			result = car->OpenDoors(door_number, 3, 0, true);
+			break;
+		case doorCloseExtManual:
+			car->CloseDoors(door_number, 3, 0, true);
+			break;
+		case doorOpenManual:
+			result = car->OpenDoors(door_number, 1, 0, true);
+			break;
+		case doorCloseManual:
+			car->CloseDoors(door_number, 1, 0, true);
+			break;
+		case doorOpenInt:
+			result = car->OpenDoors(door_number, 2, 0, false);
+			break;
+		case doorCloseInt:
+			car->CloseDoors(door_number, 2, 0, false);
+			break;
+		case doorOpenExt:
+			result = car->OpenDoors(door_number, 3, car->GetFloor(), false);
+			break;
+		case doorCloseExt:
+			car->CloseDoors(door_number, 3, car->GetFloor(), false);
+			break;
+		case doorOpen:
+			result = car->OpenDoors(door_number);
+			break;
+		case doorClose:
+			car->CloseDoors(door_number);
+			break;
+		case doorStop:
+			car->StopDoors(door_number);
+			break;
+		case doorHold:
+			car->HoldDoors(door_number);
+			break;
+		case doorSensorOn:
+			car->EnableSensor(true, door_number);
+			break;
+		case doorSensorOff:
+			car->EnableSensor(false, door_number);
+			break;
+		case doorSensorReset:
+			car->ResetDoors(door_number, true);
+			break;
+		case doorSensor:
+			car->OpenDoors(door_number);
+			car->HoldDoors(door_number, true);
+			break;
+		case doorReset:
+			car->ResetDoors(door_number);
+			break;
+		default:
+			break;
 		}
-		return false;
+		return true;
 	}
 
-	if (command_name == "gotofloor")
+	switch (command)
+	{
+	case cmdCancel:
+		if (elevator->FireServicePhase2 == 1 || elevator->IndependentService == true)
+			result = elevator->CallCancelAll();
+		else
+			result = elevator->CallCancel();
+		return true;
+	case cmdRun:
+	case cmdStop:
+		elevator->SetRunState(command == cmdRun);
+		result = true;
+		return true;
+	case cmdEStop:
+		result = elevator->Stop(true);
+		return true;
+	case cmdAlarm:
+		car->Alarm();
+		result = true;
+		return true;
+	case cmdFire2Off:
+		result = elevator->EnableFireService2(0, car->Number);
+		return true;
+	case cmdFire2On:
+		result = elevator->EnableFireService2(1, car->Number);
+		return true;
+	case cmdFire2Hold:
+		result = elevator->EnableFireService2(2, car->Number);
+		return true;
+	case cmdUpPeakOn:
+	case cmdUpPeakOff:
+		result = elevator->EnableUpPeak(command == cmdUpPeakOn);
+		return true;
+	case cmdDownPeakOn:
+	case cmdDownPeakOff:
+		result = elevator->EnableDownPeak(command == cmdDownPeakOn);
+		return true;
+	case cmdPeakOff:
+		elevator->EnableDownPeak(false);
+		elevator->EnableUpPeak(false);
+		result = true;
+		return true;
+	case cmdIndOn:
+	case cmdIndOff:
+		result = elevator->EnableIndependentService(command == cmdIndOn, car->Number);
+		return true;
+	case cmdInsOn:
+	case cmdInsOff:
+		result = elevator->EnableInspectionService(command == cmdInsOn);
+		return true;
+	case cmdAcpOn:
+	case cmdAcpOff:
+		result = elevator->EnableACP(command == cmdAcpOn);
+		return true;
+	case cmdFanOn:
+	case cmdFanOff:
+		car->Fan = (command == cmdFanOn);
+		result = true;
+		return true;
+	case cmdMusicOn:
+	case cmdMusicOff:
+		car->MusicOn = (command == cmdMusicOn);
+		result = true;
+		return true;
+	case cmdUpOn:
+	case cmdUpOff:
+		if (elevator->InspectionService == true)
+			result = elevator->SetUpButton(command == cmdUpOn);
+		else
+			result = elevator->Up(command == cmdUpOn);
+		return true;
+	case cmdDownOn:
+	case cmdDownOff:
+		if (elevator->InspectionService == true)
+			result = elevator->SetDownButton(command == cmdDownOn);
+		else
+			result = elevator->Down(command == cmdDownOn);
+		return true;
+	case cmdInsUpOn:
+	case cmdInsUpOff:
+		if (elevator->InspectionService == false)
+			return false;
+		result = elevator->SetUpButton(command == cmdInsUpOn);
+		return true;
+	case cmdInsDownOn:
+	case cmdInsDownOff:
+		if (elevator->InspectionService == false)
+			return false;
+		result = elevator->SetDownButton(command == cmdInsDownOn);
+		return true;
+	case cmdGoOn:
+	case cmdGoOff:
+		result = elevator->SetGoButton(command == cmdGoOn);
+		return true;
+	case cmdReturn:
+		result = elevator->ReturnToNearestFloor();
+		return true;
+	case cmdUp:
+		result = elevator->Up();
+		return true;
+	case cmdDown:
+		result = elevator->Down();
+		return true;
+	case cmdInterlocksOn:
+	case cmdInterlocksOff:
+		elevator->Interlocks = (command == cmdInterlocksOn);
+		result = true;
+		return true;
+	case cmdFire1Off:
+	case cmdFire1On:
+	case cmdFire1Bypass:
+	{
+		//use first call station on recall floor
+		CallStation *station = elevator->GetPrimaryCallStation();
+		if (!station)
+			return false;
+
+		if (command == cmdFire1Off)
+			result = station->FireService(0);
+		else if (command == cmdFire1On)
+			result = station->FireService(1);
+		else
+			result = station->FireService(2);
+		return true;
+	}
+	case cmdOpenShaftDoor:
+	case cmdCloseShaftDoor:
+	case cmdOpenShaftDoorManual:
+	case cmdCloseShaftDoorManual:
 	{
-		if ((int)command_parameters.size() == 1)
+		int param1 = 0, param2 = 0;
+		if ((int)command_parameters.size() != 2 || !IsNumeric(command_parameters[0], param1) || !IsNumeric(command_parameters[1], param2))
+			return true;
+
+		bool manual = (command == cmdOpenShaftDoorManual || command == cmdCloseShaftDoorManual);
+		if (command == cmdOpenShaftDoor || command == cmdOpenShaftDoorManual)
+			result = car->OpenDoors(param1, 3, param2, manual);
+		else
 		{
-			sbs->camera->GotoFloor(ToInt(command_parameters[0]));
+			car->CloseDoors(param1, 3, param2, manual);
+			result = true;
+		}
+		return true;
+	}
+	case cmdAccessDown:
+	case cmdAccessUp:
+	case cmdAccessOff:
+	{
+		int param = 0;
+		if ((int)command_parameters.size() != 1 || !IsNumeric(command_parameters[0], param))
 			return true;
+
+		if (command == cmdAccessOff)
+			result = elevator->SetHoistwayAccess(param, 0);
+		else
+		{
+			hold = elevator->HoistwayAccessHold;
+			result = elevator->SetHoistwayAccess(param, (command == cmdAccessUp) ? 1 : -1);
 		}
-		return false;
+		return true;
+	}
+	case cmdInput:
+		result = car->Input(command_input);
+		return true;
+	case cmdInputEnter:
+		result = car->KeypadEnter();
+		return true;
+	case cmdInputClear:
+		result = car->KeypadClear();
+		return true;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+bool Action::RunCallStation(CallStation *station, bool &result)
+{
+	//run call station commands
+	//returns true if the command was handled, with its status in "result"
+
+	result = false;
+
+	switch (command)
+	{
+	case cmdOff:
+		return true;
+	case cmdFloor:
+		//numeric commands for station floor selections
+		result = station->SelectFloor(command_number);
+		return true;
+	case cmdFireOff:
+		result = station->FireService(0);
+		return true;
+	case cmdFireOn:
+		result = station->FireService(1);
+		return true;
+	case cmdFireBypass:
+		result = station->FireService(2);
+		return true;
+	case cmdInput:
+		result = station->Input(command_input);
+		return true;
+	case cmdInputEnter:
+		result = station->KeypadEnter();
+		return true;
+	case cmdInputClear:
+		result = station->KeypadClear();
+		return true;
+	case cmdUp:
+	case cmdDown:
+		result = station->Call(command == cmdUp);
+		return true;
+	case cmdPressUp:
+	case cmdPressDown:
+		result = station->Press(command == cmdPressUp);
+		return true;
+	default:
+		break;
 	}
 
 	return false;
@@ -1230,6 +1130,7 @@ bool Action::AddParent(Object *parent)
 	}
 
 	parent_objects.emplace_back(parent);
+	parent_types.emplace_back(GetTargetType(parent));
 	return true;
 }
 
@@ -1243,6 +1144,7 @@ bool Action::RemoveParent(Object *parent)
 		if (parent_objects[i] == parent)
 		{
 			parent_objects.erase(parent_objects.begin() + i);
+			parent_types.erase(parent_types.begin() + i);
 			return true;
 		}
 	}
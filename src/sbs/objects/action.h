@@ -46,11 +46,148 @@ public:
 
 private:
 
-	bool Run(Object *caller, Object *parent, bool &hold);
+	//command types, resolved from the command name when the action is created
+	enum Command
+	{
+		cmdNone,
+		cmdFloor, //numeric floor selection
+		cmdOff,
+		cmdOn,
+		cmdCancel,
+		cmdRun,
+		cmdStop,
+		cmdEStop,
+		cmdAlarm,
+		cmdFire2Off,
+		cmdFire2On,
+		cmdFire2Hold,
+		cmdUpPeakOn,
+		cmdUpPeakOff,
+		cmdDownPeakOn,
+		cmdDownPeakOff,
+		cmdPeakOff,
+		cmdIndOn,
+		cmdIndOff,
+		cmdInsOn,
+		cmdInsOff,
+		cmdAcpOn,
+		cmdAcpOff,
+		cmdFanOn,
+		cmdFanOff,
+		cmdMusicOn,
+		cmdMusicOff,
+		cmdUpOn,
+		cmdUpOff,
+		cmdDownOn,
+		cmdDownOff,
+		cmdInsUpOn,
+		cmdInsUpOff,
+		cmdInsDownOn,
+		cmdInsDownOff,
+		cmdGoOn,
+		cmdGoOff,
+		cmdReturn,
+		cmdUp,
+		cmdDown,
+		cmdInterlocksOn,
+		cmdInterlocksOff,
+		cmdFire1Off,
+		cmdFire1On,
+		cmdFire1Bypass,
+		cmdOpenShaftDoor,
+		cmdCloseShaftDoor,
+		cmdOpenShaftDoorManual,
+		cmdCloseShaftDoorManual,
+		cmdAccessDown,
+		cmdAccessUp,
+		cmdAccessOff,
+		cmdInput, //keypad input, of command_input
+		cmdInputEnter,
+		cmdInputClear,
+		cmdFireOff,
+		cmdFireOn,
+		cmdFireBypass,
+		cmdPressUp,
+		cmdPressDown,
+		cmdForward,
+		cmdReverse,
+		cmdEnable,
+		cmdDisable,
+		cmdOpen,
+		cmdClose,
+		cmdAutoClose,
+		cmdStartSlideshow,
+		cmdStopSlideshow,
+		cmdSetTexture,
+		cmdChangeTexture,
+		cmdPlaySound,
+		cmdStopSound,
+		cmdTeleport,
+		cmdGotoFloor
+	};
+
+	//elevator door commands, matched by prefix and followed by an optional door number
+	enum DoorCommand
+	{
+		doorNone,
+		doorOpenIntManual,
+		doorCloseIntManual,
+		doorOpenExtManual,
+		doorCloseExtManual,
+		doorOpenManual,
+		doorCloseManual,
+		doorOpenInt,
+		doorCloseInt,
+		doorOpenExt,
+		doorCloseExt,
+		doorOpen,
+		doorClose,
+		doorStop,
+		doorHold,
+		doorSensorOn,
+		doorSensorOff,
+		doorSensorReset,
+		doorSensor,
+		doorReset
+	};
+
+	//parent object types, resolved when a parent is added
+	enum TargetType
+	{
+		targetOther,
+		targetSBS,
+		targetMesh,
+		targetFloor,
+		targetElevator,
+		targetElevatorCar,
+		targetShaft,
+		targetStairwell,
+		targetCallStation,
+		targetEscalator,
+		targetWalkway,
+		targetCameraTexture,
+		targetLight,
+		targetDoor,
+		targetRevolvingDoor,
+		targetTextureManager
+	};
+
+	void Resolve();
+	static TargetType GetTargetType(Object *parent);
+	bool Run(Object *caller, Object *parent, TargetType type, bool &hold);
+	bool RunElevator(Object *caller, Elevator *elevator, ElevatorCar *car, bool &hold, bool &result);
+	bool RunCallStation(CallStation *station, bool &result);
 
 	std::string command_name;
 	std::vector<std::string> command_parameters;
 	std::vector<Object*> parent_objects;
+	std::vector<TargetType> parent_types; //type of each parent object
+
+	Command command;
+	DoorCommand door_command;
+	int command_number; //floor number for floor selections
+	int door_number; //door number for door commands
+	std::string command_input; //keypad input for input commands
 };
 
 }
@@ -35,6 +35,7 @@
 #include "profiler.h"
 #include "utility.h"
 #include "elevator.h"
+#include "route.h"
 
 namespace SBS {
 
@@ -76,12 +77,17 @@ CallStation::CallStation(Object *parent, int floornum, int number) : Object(pare
 	//create timer
 	timer = new Timer("Input Timeout Timer", this);
 
+	//routes can only board elevators at floors with call stations
+	sbs->GetRouteGraph()->Invalidate();
+
 	if (sbs->Verbose)
 		Report("Created");
 }
 
 CallStation::~CallStation()
 {
+	sbs->GetRouteGraph()->Invalidate();
+
 	RemovePanel();
 
 	if (indicator)
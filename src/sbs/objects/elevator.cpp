@@ -38,6 +38,7 @@
 #include "controller.h"
 #include "random.h"
 #include "elevroute.h"
+#include "route.h"
 #include "elevator.h"
 
 #include <time.h>
@@ -219,6 +220,9 @@ Elevator::Elevator(Object *parent, int number) : Object(parent)
 
 Elevator::~Elevator()
 {
+	//cached routes may reference this elevator's cars
+	sbs->GetRouteGraph()->Invalidate();
+
 	//delete counterweight and rope meshes
 	if (sbs->Verbose)
 		Report("deleting meshes");
@@ -1810,6 +1814,16 @@ std::string Elevator::GetFloorSkipText()
 	return FloorSkipText;
 }
 
+void Elevator::SetType(const std::string &type)
+{
+	//set the elevator type (Local, Express, Service)
+
+	Type = type;
+
+	//route costs depend on the elevator type
+	sbs->GetRouteGraph()->Invalidate();
+}
+
 bool Elevator::InServiceMode()
 {
 	//report if an elevator is in a service mode
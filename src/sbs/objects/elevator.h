@@ -154,6 +154,7 @@ public:
 	Real GetJerkPosition();
 	void SetFloorSkipText(const std::string &id);
 	std::string GetFloorSkipText();
+	void SetType(const std::string &type);
 	bool InServiceMode();
 	bool Go(int floor, bool hold = false);
 	bool EnableACP(bool value);
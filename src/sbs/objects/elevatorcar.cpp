@@ -53,6 +53,7 @@
 #include "utility.h"
 #include "shape.h"
 #include "reverb.h"
+#include "route.h"
 
 #include <time.h>
 
@@ -155,6 +156,9 @@ ElevatorCar::ElevatorCar(Elevator *parent, int number) : Object(parent)
 
 ElevatorCar::~ElevatorCar()
 {
+	//cached routes may reference this car
+	sbs->GetRouteGraph()->Invalidate();
+
 	if (sbs->Verbose)
 		parent->Report("deleting objects");
 
@@ -570,6 +574,7 @@ bool ElevatorCar::AddServicedFloor(int number, bool create_shaft_door)
 		{
 			ServicedFloors.emplace_back(number);
 			std::sort(ServicedFloors.begin(), ServicedFloors.end());
+			sbs->GetRouteGraph()->Invalidate();
 
 			//add serviced floors to doors, if needed
 			if (Created == true && create_shaft_door == true)
@@ -598,7 +603,10 @@ void ElevatorCar::RemoveServicedFloor(int number, bool remove_shaft_door)
 
 	int index = GetFloorIndex(number);
 	if (index > -1)
+	{
 		ServicedFloors.erase(ServicedFloors.begin() + index);
+		sbs->GetRouteGraph()->Invalidate();
+	}
 
 	//remove serviced floors from doors
 	if (Created == true && remove_shaft_door == true)
@@ -74,6 +74,7 @@ Escalator::Escalator(Object *parent, const std::string &name, int run, Real spee
 	start = Vector3::ZERO;
 	end = Vector3::ZERO;
 	buffer_zone_steps = 2;
+	phase = 0;
 
 	//register with engine
 	sbs->RegisterEscalator(this);
@@ -247,19 +248,18 @@ void Escalator::CreateSteps(const std::string &riser_texture, const std::string
 
 	std::string Name = GetName();
 	TrimString(Name);
-	Direction = direction;
+	Direction = Step::GetDirection(direction);
 	this->treadsize = treadsize;
 	this->risersize = risersize;
-	SetCase(Direction, false);
 	int num_steps = (int)Steps.size();
 
-	SetCase(Direction, false);
-	TrimString(Direction);
+	if (Direction == STEP_NONE)
+		ReportError("Invalid direction '" + direction + "'");
 
 	sbs->GetTextureManager()->ResetTextureMapping(true);
-	if (Direction == "right" || Direction == "back")
+	if (Direction == STEP_RIGHT || Direction == STEP_BACK)
 		sbs->GetPolyMesh()->SetWallOrientation("right");
-	if (Direction == "left" || Direction == "front")
+	if (Direction == STEP_LEFT || Direction == STEP_FRONT)
 		sbs->GetPolyMesh()->SetWallOrientation("left");
 
 	PolyMesh *polymesh = sbs->GetPolyMesh();
@@ -274,7 +274,7 @@ void Escalator::CreateSteps(const std::string &riser_texture, const std::string
 
 		Real thickness = treadsize;
 
-		if (Direction == "right")
+		if (Direction == STEP_RIGHT)
 		{
 			pos = ((treadsize * num_steps + 1) / 2) - (treadsize * i);
 			polymesh->DrawWalls(true, true, true, true, false, true);
@@ -298,7 +298,7 @@ void Escalator::CreateSteps(const std::string &riser_texture, const std::string
 				end = Steps[i - 1]->GetPosition();
 			Steps[i - 1]->start = Steps[i - 1]->GetPosition();
 		}
-		if (Direction == "left")
+		if (Direction == STEP_LEFT)
 		{
 			pos = -((treadsize * num_steps + 1) / 2) + (treadsize * i);
 			polymesh->DrawWalls(true, true, true, true, false, true);
@@ -322,7 +322,7 @@ void Escalator::CreateSteps(const std::string &riser_texture, const std::string
 				end = Steps[i - 1]->GetPosition();
 			Steps[i - 1]->start = Steps[i - 1]->GetPosition();
 		}
-		if (Direction == "back")
+		if (Direction == STEP_BACK)
 		{
 			pos = ((treadsize * num_steps + 1) / 2) - (treadsize * i);
 			polymesh->DrawWalls(true, true, true, true, false, true);
@@ -346,7 +346,7 @@ void Escalator::CreateSteps(const std::string &riser_texture, const std::string
 				end = Steps[i - 1]->GetPosition();
 			Steps[i - 1]->start = Steps[i - 1]->GetPosition();
 		}
-		if (Direction == "front")
+		if (Direction == STEP_FRONT)
 		{
 			pos = -((treadsize * num_steps + 1) / 2) + (treadsize * i);
 			polymesh->DrawWalls(true, true, true, true, false, true);
@@ -380,94 +380,55 @@ void Escalator::MoveSteps()
 	if (GetPosition().distance(sbs->camera->GetPosition()) > 100)
 		return;
 
+	if (Direction == STEP_NONE || Steps.empty() || (Run != 1 && Run != -1))
+		return;
+
+	SBS_PROFILE("Escalator::MoveSteps");
+
+	//steps travel along the X axis for left and right escalators, and the Z axis for front and back.
+	//all step positions are computed from the escalator's phase, the distance the steps have
+	//traveled in step lengths, so a step at path position u is at (step number + phase) modulo the step count
+	bool x_axis = (Direction == STEP_RIGHT || Direction == STEP_LEFT);
+	Real sign = (Direction == STEP_LEFT || Direction == STEP_FRONT) ? 1 : -1;
+	Real first = sign * (x_axis == true ? start.x : start.z);
+	Real count = (Real)Steps.size();
+
+	//steps are flat for the first and last two step positions, and inclined in between
+	Real incline_start = 2;
+	Real incline_end = std::max(count - 2, incline_start);
+
+	//advance phase
+	Real speed = Speed * sbs->delta;
+	phase = std::fmod(phase + (Run * speed / treadsize), count);
+	if (phase < 0)
+		phase += count;
+
+	//movement vectors, used to carry the camera along with a step
+	Vector3 flat = Vector3::ZERO;
+	if (x_axis == true)
+		flat.x = sign * Run;
+	else
+		flat.z = sign * Run;
+	Vector3 incline = flat;
+	incline.y = Run * (risersize / treadsize);
+
+	//position steps
 	for (size_t i = 0; i < Steps.size(); i++)
 	{
-		if (Run == 1)
-		{
-			if (Direction == "right")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos < end.x - treadsize)
-					Steps[i]->SetPosition(start);
-				else if (pos >= start.x - (treadsize * 2) || pos <= end.x + treadsize)
-					Steps[i]->Move(Vector3(-Run, 0, 0), Speed * sbs->delta);
-				else if (pos > end.x + treadsize)
-					Steps[i]->Move(Vector3(-Run, Run * (risersize / treadsize), 0), Speed * sbs->delta);
-			}
-			if (Direction == "left")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos > end.x + treadsize)
-					Steps[i]->SetPosition(start);
-				else if (pos <= start.x + (treadsize * 2) || pos >= end.x - treadsize)
-					Steps[i]->Move(Vector3(Run, 0, 0), Speed * sbs->delta);
-				else if (pos < end.x - treadsize)
-					Steps[i]->Move(Vector3(Run, Run * (risersize / treadsize), 0), Speed * sbs->delta);
-			}
-			if (Direction == "back")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos < end.z - treadsize)
-					Steps[i]->SetPosition(start);
-				else if (pos >= start.z - (treadsize * 2) || pos <= end.z + treadsize)
-					Steps[i]->Move(Vector3(0, 0, -Run), Speed * sbs->delta);
-				else if (pos > end.z + treadsize)
-					Steps[i]->Move(Vector3(0, Run * (risersize / treadsize), -Run), Speed * sbs->delta);
-			}
-			if (Direction == "front")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos > end.z + treadsize)
-					Steps[i]->SetPosition(start);
-				else if (pos <= start.z + (treadsize * 2) || pos >= end.z - treadsize)
-					Steps[i]->Move(Vector3(0, 0, Run), Speed * sbs->delta);
-				else if (pos < end.z - treadsize)
-					Steps[i]->Move(Vector3(0, Run * (risersize / treadsize), Run), Speed * sbs->delta);
-			}
-		}
-		else if (Run == -1)
-		{
-			if (Direction == "right")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos > start.x)
-					Steps[i]->SetPosition(Vector3(end.x - treadsize, end.y, end.z));
-				else if (pos <= end.x + treadsize || pos >= start.x - (treadsize * 2))
-					Steps[i]->Move(Vector3(-Run, 0, 0), Speed * sbs->delta);
-				else if (pos < start.x - treadsize)
-					Steps[i]->Move(Vector3(-Run, Run * (risersize / treadsize), 0), Speed * sbs->delta);
-			}
-			if (Direction == "left")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos < start.x)
-					Steps[i]->SetPosition(Vector3(end.x + treadsize, end.y, end.z));
-				else if (pos >= end.x - treadsize || pos <= start.x + (treadsize * 2))
-					Steps[i]->Move(Vector3(Run, 0, 0), Speed * sbs->delta);
-				else if (pos > start.x + treadsize)
-					Steps[i]->Move(Vector3(Run, Run * (risersize / treadsize), 0), Speed * sbs->delta);
-			}
-			if (Direction == "back")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos > start.z)
-					Steps[i]->SetPosition(Vector3(end.x, end.y, end.z - treadsize));
-				else if (pos <= end.z + treadsize || pos >= start.z - (treadsize * 2))
-					Steps[i]->Move(Vector3(0, 0, -Run), Speed * sbs->delta);
-				else if (pos < start.z - treadsize)
-					Steps[i]->Move(Vector3(0, Run * (risersize / treadsize), -Run), Speed * sbs->delta);
-			}
-			if (Direction == "front")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos < start.z)
-					Steps[i]->SetPosition(Vector3(end.x, end.y, end.z + treadsize));
-				else if (pos >= end.z - treadsize || pos <= start.z + (treadsize * 2))
-					Steps[i]->Move(Vector3(0, 0, Run), Speed * sbs->delta);
-				else if (pos > start.z + treadsize)
-					Steps[i]->Move(Vector3(0, Run * (risersize / treadsize), Run), Speed * sbs->delta);
-			}
-		}
+		Real u = (Real)i + phase;
+		if (u >= count)
+			u -= count;
+
+		Vector3 pos = start;
+		if (x_axis == true)
+			pos.x = sign * (first + (u * treadsize));
+		else
+			pos.z = sign * (first + (u * treadsize));
+		pos.y += risersize * (std::min(std::max(u, incline_start), incline_end) - incline_start);
+
+		Steps[i]->SetPosition(pos);
+		Steps[i]->vector = (u > incline_start && u < incline_end) ? incline : flat;
+		Steps[i]->speed = speed;
 	}
 }
 
@@ -502,6 +463,7 @@ void Escalator::ResetState()
 	//reset escalator state
 
 	Run = 0;
+	phase = 0;
 	for (size_t i = 0; i < Steps.size(); i++)
 	{
 		Steps[i]->SetPosition(Steps[i]->start);
@@ -24,6 +24,8 @@
 #ifndef _SBS_ESCALATOR_H
 #define _SBS_ESCALATOR_H
 
+#include "step.h"
+
 namespace SBS {
 
 class SBSIMPEXP Escalator : public Object
@@ -50,12 +52,13 @@ private:
 	int Run; //-1 is reverse, 0 is stop, 1 is forward
 	bool is_enabled;
 	Vector3 start, end;
-	std::string Direction;
+	StepDirection Direction;
 	Real treadsize;
 	Real risersize;
 	int buffer_zone_steps;
 
 	std::vector<Step*> Steps;
+	Real phase; //distance the steps have traveled, in step lengths
 
 	//random malfunctions timer
 	class Timer;
@@ -577,6 +577,37 @@ bool Floor::IsEnabled()
 {
 	return is_enabled;
 }
+
+bool Floor::Evict()
+{
+	//free the render buffers and colliders of this floor's level, interfloor and columnframe meshes
+	//meshes that are still shown are skipped; returns true if any mesh was evicted
+
+	if (is_enabled == true)
+		return false;
+
+	bool result = Level->Evict();
+	if (Interfloor->Evict() == true)
+		result = true;
+	if (ColumnFrame->Evict() == true)
+		result = true;
+
+	return result;
+}
+
+void Floor::Restore()
+{
+	//rebuild this floor's evicted meshes
+
+	Level->Restore();
+	Interfloor->Restore();
+	ColumnFrame->Restore();
+}
+
+bool Floor::IsEvicted()
+{
+	return (Level->IsEvicted() == true || Interfloor->IsEvicted() == true || ColumnFrame->IsEvicted() == true);
+}
 Real Floor::FullHeight()
 {
 	//calculate full height of a floor
@@ -1709,39 +1740,6 @@ void Floor::GetShaftList(std::vector<int> &listing)
 	}
 }
 
-ElevatorRoute* Floor::GetDirectRoute(int DestinationFloor, std::string ElevatorType)
-{
-	//return elevator if this floor has a direct elevator connection to another floor,
-	//based on the given elevator type
-
-	SetCase(ElevatorType, false);
-	std::vector<int> list;
-	GetElevatorList(list);
-
-	for (size_t i = 0; i < list.size(); i++)
-	{
-		Elevator *elev = sbs->GetElevator(list[i]);
-		if (elev)
-		{
-			ElevatorCar *car = elev->GetCarForFloor(Number);
-			if (car)
-			{
-				std::string type = SetCaseCopy(elev->Type, false);
-				bool serviced = car->IsServicedFloor(DestinationFloor);
-				CallStation *station = GetCallStationForElevator(elev->Number);
-
-				if (serviced == true && type == ElevatorType && station)
-				{
-					ElevatorRoute* route = new ElevatorRoute(car, DestinationFloor);
-					return route;
-				}
-			}
-		}
-	}
-
-	return 0;
-}
-
 std::vector<int> Floor::GetDirectFloors(bool include_service)
 {
 	//return a list of floors that can be directly accessed by the elevators that service this floor
@@ -62,6 +62,9 @@ public:
 	Shape* CreateShape(Wall *wall);
 	bool Enabled(bool value);
 	bool IsEnabled();
+	bool Evict();
+	void Restore();
+	bool IsEvicted();
 	Real FullHeight();
 	CallStation* AddCallButtons(int controller, const std::string &sound_file_up, const std::string &sound_file_down, const std::string &BackTexture, const std::string &UpButtonTexture, const std::string &UpButtonTexture_Lit, const std::string &DownButtonTexture, const std::string &DownButtonTexture_Lit, Real CenterX, Real CenterZ, Real voffset, const std::string &direction, Real BackWidth, Real BackHeight, bool ShowBack, Real tw, Real th);
 	CallStation* AddCallStation(int number);
@@ -133,7 +136,6 @@ public:
 	void GetElevatorList(std::vector<int> &listing, bool get_locals = true, bool get_express = true, bool get_service = true);
 	void GetStairwellList(std::vector<int> &listing);
 	void GetShaftList(std::vector<int> &listing);
-	ElevatorRoute* GetDirectRoute(int DestinationFloor, std::string ElevatorType);
 	std::vector<int> GetDirectFloors(bool include_service);
 	Model* GetModel(std::string name);
 	Primitive* GetPrimitive(std::string name);
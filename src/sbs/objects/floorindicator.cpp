@@ -61,6 +61,9 @@ FloorIndicator::FloorIndicator(Object *parent, int index, int elevator, int car,
 	Prefix = texture_prefix;
 	Blank = blank_texture;
 	off = false;
+	atlas = 0;
+	atlas_checked = false;
+	atlas_active = false;
 
 	//move object
 	Move(CenterX, voffset, CenterZ);
@@ -88,6 +91,7 @@ FloorIndicator::FloorIndicator(Object *parent, int index, int elevator, int car,
 
 	std::string texture = Prefix + sbs->GetFloor(Car->StartingFloor)->ID;
 	sbs->GetTextureManager()->EnableLighting(texture, false);
+	current_texture = texture;
 	std::string tmpdirection = direction;
 	SetCase(tmpdirection, false);
 
@@ -115,6 +119,10 @@ FloorIndicator::FloorIndicator(Object *parent, int index, int elevator, int car,
 
 	flash_timer = new Timer("Flash Timer", this);
 
+	//indicators created at load time get their atlas from SBS::Prepare(), once all floors exist
+	if (sbs->IsRunning == true)
+		CreateAtlas();
+
 	EnableLoop(true);
 }
 
@@ -132,6 +140,14 @@ FloorIndicator::~FloorIndicator()
 	}
 	FloorIndicatorMesh = 0;
 
+	//unload atlas material
+	if (atlas_material != "" && sbs->FastDelete == false)
+	{
+		atlas_ptr.reset();
+		if (sbs->GetTextureManager()->UnloadMaterial(atlas_material, "General") == true)
+			sbs->GetTextureManager()->UnregisterTexture(atlas_material);
+	}
+
 	//unregister from parent
 	if (sbs->FastDelete == false && parent_deleting == false)
 	{
@@ -164,7 +180,7 @@ void FloorIndicator::Update(bool blank)
 
 	if (blank == true && Blank != "")
 	{
-		FloorIndicatorMesh->ChangeTexture(Blank);
+		SetTexture(Blank, true);
 		return;
 	}
 
@@ -186,8 +202,92 @@ void FloorIndicator::Update(bool blank)
 
 	texture.insert(0, Prefix);
 
+	SetTexture(texture, false);
+}
+
+void FloorIndicator::SetTexture(const std::string &texture, bool lighting)
+{
+	//change the displayed texture
+	//if lighting is false, disable lighting on the texture
+
+	if (texture == current_texture)
+		return;
+
+	current_texture = texture;
+
+	//in atlas mode, only change the cell shown by the indicator's material
+	if (atlas && sbs->GetTextureManager()->SetAtlasCell(atlas_ptr, atlas, texture) == true)
+	{
+		if (atlas_active == false)
+			FloorIndicatorMesh->ChangeTexture(atlas_material);
+		atlas_active = true;
+		return;
+	}
+
+	//otherwise switch the mesh to the texture
+	atlas_active = false;
 	FloorIndicatorMesh->ChangeTexture(texture);
-	sbs->GetTextureManager()->EnableLighting(texture, false);
+	if (lighting == false)
+		sbs->GetTextureManager()->EnableLighting(texture, false);
+}
+
+void FloorIndicator::CreateAtlas()
+{
+	//set up atlas mode, where all floor textures for this indicator's prefix are packed into a
+	//single texture, and display changes only update the texture transform of this indicator's material
+	//this creates textures and materials, so it must run on the main thread
+
+	if (atlas_checked == true)
+		return;
+
+	atlas_checked = true;
+
+	if (sbs->GetConfigBool("Skyscraper.SBS.IndicatorAtlas", false) == false)
+		return;
+
+	TextureManager *texturemanager = sbs->GetTextureManager();
+
+	//use an existing atlas for this texture set, or create a new one
+	std::string name = "Floor Indicator Atlas:" + Prefix + ":" + Blank;
+	atlas = texturemanager->GetAtlas(name);
+
+	if (!atlas)
+	{
+		std::vector<std::string> textures;
+		for (int i = -sbs->Basements; i < sbs->Floors; i++)
+		{
+			Floor *floor = sbs->GetFloor(i);
+			if (floor)
+				textures.emplace_back(Prefix + floor->ID);
+		}
+		if (Blank != "")
+			textures.emplace_back(Blank);
+
+		atlas = texturemanager->CreateAtlas(name, textures);
+		if (!atlas)
+			return;
+
+		texturemanager->EnableLighting(name, false);
+	}
+
+	//create this indicator's material
+	atlas_material = "Floor Indicator Material " + ToString(GetNumber());
+	if (texturemanager->CreateAtlasMaterial(atlas, atlas_material) == false)
+	{
+		atlas = 0;
+		atlas_material = "";
+		return;
+	}
+
+	texturemanager->EnableLighting(atlas_material, false);
+	atlas_ptr = texturemanager->GetMaterialByName(atlas_material);
+
+	//show the current texture through the atlas
+	if (texturemanager->SetAtlasCell(atlas_ptr, atlas, current_texture) == true)
+	{
+		FloorIndicatorMesh->ChangeTexture(atlas_material);
+		atlas_active = true;
+	}
 }
 
 void FloorIndicator::Flash(bool enabled)
@@ -45,11 +45,22 @@ public:
 	void Off();
 	void On();
 	bool Loop();
+	void CreateAtlas();
 
 private:
+	void SetTexture(const std::string &texture, bool lighting);
+
 	MeshObject* FloorIndicatorMesh; //indicator mesh object
 	bool is_enabled;
 	bool off;
+	std::string current_texture; //currently displayed texture
+
+	//atlas mode
+	TextureAtlas *atlas; //atlas of this indicator's textures
+	std::string atlas_material; //name of this indicator's atlas material
+	Ogre::MaterialPtr atlas_ptr;
+	bool atlas_checked; //true if atlas creation has been attempted
+	bool atlas_active; //true if the atlas material is applied to the mesh
 
 	class Timer; //internal timer class
 
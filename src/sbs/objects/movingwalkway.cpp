@@ -58,6 +58,7 @@ MovingWalkway::MovingWalkway(Object *parent, const std::string &name, int run, R
 	Speed = speed;
 	start = Vector3::ZERO;
 	end = Vector3::ZERO;
+	phase = 0;
 
 	//register with engine
 	sbs->RegisterMovingWalkway(this);
@@ -201,17 +202,19 @@ void MovingWalkway::CreateSteps(const std::string &texture, const std::string &d
 	//create steps
 	std::string Name = GetName();
 	TrimString(Name);
-	Direction = direction;
+	Direction = Step::GetDirection(direction);
 	this->treadsize = treadsize;
-	SetCase(Direction, false);
 	int num_steps = (int)Steps.size();
 
+	if (Direction == STEP_NONE)
+		ReportError("Invalid direction '" + direction + "'");
+
 	PolyMesh* polymesh = sbs->GetPolyMesh();
 
 	sbs->GetTextureManager()->ResetTextureMapping(true);
-	if (Direction == "right" || Direction == "back")
+	if (Direction == STEP_RIGHT || Direction == STEP_BACK)
 		polymesh->SetWallOrientation("right");
-	if (Direction == "left" || Direction == "front")
+	if (Direction == STEP_LEFT || Direction == STEP_FRONT)
 		polymesh->SetWallOrientation("left");
 
 	for (int i = 1; i <= num_steps; i++)
@@ -226,25 +229,25 @@ void MovingWalkway::CreateSteps(const std::string &texture, const std::string &d
 
 		polymesh->DrawWalls(false, true, false, false, false, false);
 
-		if (Direction == "right")
+		if (Direction == STEP_RIGHT)
 		{
 			pos = ((treadsize * num_steps + 1) / 2) - (treadsize * i);
 			polymesh->AddFloorMain(wall, base, texture, 0, 0, -(width / 2), treadsize, width / 2, 0, 0, false, false, tw, th, true);
 			Steps[i - 1]->Move(Vector3(pos, 0, 0));
 		}
-		if (Direction == "left")
+		if (Direction == STEP_LEFT)
 		{
 			pos = -((treadsize * num_steps + 1) / 2) + (treadsize * i);
 			polymesh->AddFloorMain(wall, base, texture, 0, -treadsize, -(width / 2), 0, width / 2, 0, 0, false, false, tw, th, true);
 			Steps[i - 1]->Move(Vector3(pos, 0, 0));
 		}
-		if (Direction == "back")
+		if (Direction == STEP_BACK)
 		{
 			pos = ((treadsize * num_steps + 1) / 2) - (treadsize * i);
 			polymesh->AddFloorMain(wall, base, texture, 0, -(width / 2), 0, width / 2, treadsize, 0, 0, false, false, tw, th, true);
 			Steps[i - 1]->Move(Vector3(0, 0, pos));
 		}
-		if (Direction == "front")
+		if (Direction == STEP_FRONT)
 		{
 			pos = -((treadsize * num_steps + 1) / 2) + (treadsize * i);
 			polymesh->AddFloorMain(wall, base, texture, 0, -(width / 2), -treadsize, width / 2, 0, 0, 0, false, false, tw, th, true);
@@ -269,78 +272,48 @@ void MovingWalkway::MoveSteps()
 	if (GetPosition().distance(sbs->camera->GetPosition()) > 100)
 		return;
 
+	if (Direction == STEP_NONE || Steps.empty() || (Run != 1 && Run != -1))
+		return;
+
+	SBS_PROFILE("MovingWalkway::MoveSteps");
+
+	//steps travel along the X axis for left and right walkways, and the Z axis for front and back.
+	//all step positions are computed from the walkway's phase, the distance the steps have
+	//traveled in step lengths, so a step at path position u is at (step number + phase) modulo the step count
+	bool x_axis = (Direction == STEP_RIGHT || Direction == STEP_LEFT);
+	Real sign = (Direction == STEP_LEFT || Direction == STEP_FRONT) ? 1 : -1;
+	Real first = sign * (x_axis == true ? start.x : start.z);
+	Real count = (Real)Steps.size();
+
+	//advance phase
+	Real speed = Speed * sbs->delta;
+	phase = std::fmod(phase + (Run * speed / treadsize), count);
+	if (phase < 0)
+		phase += count;
+
+	//movement vector, used to carry the camera along with a step
+	Vector3 flat = Vector3::ZERO;
+	if (x_axis == true)
+		flat.x = sign * Run;
+	else
+		flat.z = sign * Run;
+
+	//position steps
 	for (size_t i = 0; i < Steps.size(); i++)
 	{
-		if (Run == 1)
-		{
-			if (Direction == "right")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos < end.x - treadsize)
-					Steps[i]->SetPosition(start);
-				else
-					Steps[i]->Move(Vector3(-Run, 0, 0), Speed * sbs->delta);
-			}
-			if (Direction == "left")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos > end.x + treadsize)
-					Steps[i]->SetPosition(start);
-				else
-					Steps[i]->Move(Vector3(Run, 0, 0), Speed * sbs->delta);
-			}
-			if (Direction == "back")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos < end.z - treadsize)
-					Steps[i]->SetPosition(start);
-				else
-					Steps[i]->Move(Vector3(0, 0, -Run), Speed * sbs->delta);
-			}
-			if (Direction == "front")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos > end.z + treadsize)
-					Steps[i]->SetPosition(start);
-				else
-					Steps[i]->Move(Vector3(0, 0, Run), Speed * sbs->delta);
-			}
-		}
-		else if (Run == -1)
-		{
-			if (Direction == "right")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos > start.x)
-					Steps[i]->SetPosition(Vector3(end.x - treadsize, end.y, end.z));
-				else
-					Steps[i]->Move(Vector3(-Run, 0, 0), Speed * sbs->delta);
-			}
-			if (Direction == "left")
-			{
-				Real pos = Steps[i]->GetPosition().x;
-				if (pos < start.x)
-					Steps[i]->SetPosition(Vector3(end.x + treadsize, end.y, end.z));
-				else
-					Steps[i]->Move(Vector3(Run, 0, 0), Speed * sbs->delta);
-			}
-			if (Direction == "back")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos > start.z)
-					Steps[i]->SetPosition(Vector3(end.x, end.y, end.z - treadsize));
-				else
-					Steps[i]->Move(Vector3(0, 0, -Run), Speed * sbs->delta);
-			}
-			if (Direction == "front")
-			{
-				Real pos = Steps[i]->GetPosition().z;
-				if (pos < start.z)
-					Steps[i]->SetPosition(Vector3(end.x, end.y, end.z + treadsize));
-				else
-					Steps[i]->Move(Vector3(0, 0, Run), Speed * sbs->delta);
-			}
-		}
+		Real u = (Real)i + phase;
+		if (u >= count)
+			u -= count;
+
+		Vector3 pos = start;
+		if (x_axis == true)
+			pos.x = sign * (first + (u * treadsize));
+		else
+			pos.z = sign * (first + (u * treadsize));
+
+		Steps[i]->SetPosition(pos);
+		Steps[i]->vector = flat;
+		Steps[i]->speed = speed;
 	}
 }
 
@@ -375,6 +348,7 @@ void MovingWalkway::ResetState()
 	//reset walkway state
 
 	Run = 0;
+	phase = 0;
 	for (size_t i = 0; i < Steps.size(); i++)
 	{
 		Steps[i]->SetPosition(Steps[i]->start);
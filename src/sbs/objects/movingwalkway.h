@@ -24,6 +24,8 @@
 #ifndef _SBS_MOVINGWALKWAY_H
 #define _SBS_MOVINGWALKWAY_H
 
+#include "step.h"
+
 namespace SBS {
 
 class SBSIMPEXP MovingWalkway : public Object
@@ -48,10 +50,11 @@ private:
 	int Run; //-1 is reverse, 0 is stop, 1 is forward
 	bool is_enabled;
 	Vector3 start, end;
-	std::string Direction;
+	StepDirection Direction;
 	Real treadsize;
 
 	std::vector<Step*> Steps;
+	Real phase; //distance the steps have traveled, in step lengths
 
 	void CreateSteps(const std::string &texture, const std::string &direction, Real width, Real treadsize, Real tw, Real th);
 	void MoveSteps();
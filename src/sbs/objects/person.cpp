@@ -140,7 +140,7 @@ void Person::GotoFloor(int floor)
 	Report("Heading to floor " + newfloor->ID);
 
 	//get route to floor, as a list of elevators
-	std::vector<ElevatorRoute*> elevators = sbs->GetRouteToFloor(current_floor, dest_floor, service_access);
+	std::vector<ElevatorRoute> elevators = sbs->GetRouteToFloor(current_floor, dest_floor, service_access);
 
 	if (elevators.empty() == true)
 	{
@@ -154,9 +154,9 @@ void Person::GotoFloor(int floor)
 	//create a new route table entry for each elevator in list
 	for (size_t i = 0; i < elevators.size(); i++)
 	{
-		Elevator *elevator = elevators[i]->car->GetElevator();
+		Elevator *elevator = elevators[i].car->GetElevator();
 		if (sbs->Verbose == true)
-			Report(ToString((int)i) + ": Elevator " + ToString(elevator->Number) + " - floor selection " + ToString(elevators[i]->floor_selection) + " - elevator name: " + elevator->Name);
+			Report(ToString((int)i) + ": Elevator " + ToString(elevator->Number) + " - floor selection " + ToString(elevators[i].floor_selection) + " - elevator name: " + elevator->Name);
 
 		RouteEntry route_entry;
 		route_entry.elevator_route = elevators[i];
@@ -190,8 +190,8 @@ void Person::ProcessRoute()
 	if (!floor_obj)
 		return;
 
-	ElevatorCar *car = route[0].elevator_route->car;
-	int floor_selection = route[0].elevator_route->floor_selection;
+	ElevatorCar *car = route[0].elevator_route.car;
+	int floor_selection = route[0].elevator_route.floor_selection;
 
 	if (!car)
 		return;
@@ -278,7 +278,7 @@ void Person::ProcessRoute()
 				if (car)
 				{
 					//have elevator route use arrived elevator
-					route[0].elevator_route->car = car;
+					route[0].elevator_route.car = car;
 
 					//person is in elevator
 					route[0].in_elevator = true;
@@ -361,7 +361,6 @@ void Person::ProcessRoute()
 			if (elevator->FireServicePhase1 != 1)
 			{
 				//erase first route entry
-				delete route[0].elevator_route;
 				route.erase(route.begin());
 			}
 			else
@@ -379,7 +378,7 @@ void Person::ProcessRoute()
 				//in order to exit the elevator at the recall floor
 				if (floor_selection != elevator->GetActiveRecallFloor())
 				{
-					route[0].elevator_route->floor_selection = elevator->GetActiveRecallFloor();
+					route[0].elevator_route.floor_selection = elevator->GetActiveRecallFloor();
 					route[0].call_made = 2;
 				}
 			}
@@ -440,14 +439,6 @@ void Person::Stop()
 {
 	//stop route if active
 
-	//delete routes
-	if (route.empty() == false)
-	{
-		for (size_t i = 0; i < route.size(); i++)
-		{
-			delete route[i].elevator_route;
-		}
-	}
 	route.clear();
 }
 
@@ -464,8 +455,8 @@ std::string Person::GetStatus()
 		return "Idle on floor " + floor->ID;
 	}
 
-	ElevatorCar *car = route[0].elevator_route->car;
-	int floor_selection = route[0].elevator_route->floor_selection;
+	ElevatorCar *car = route[0].elevator_route.car;
+	int floor_selection = route[0].elevator_route.floor_selection;
 
 	Floor *floor = sbs->GetFloor(floor_selection);
 	if (!floor)
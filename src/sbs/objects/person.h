@@ -24,6 +24,8 @@
 #ifndef _SBS_PERSON_H
 #define _SBS_PERSON_H
 
+#include "route.h"
+
 namespace SBS {
 
 class SBSIMPEXP Person : public Object
@@ -56,7 +58,7 @@ private:
 
 	struct RouteEntry
 	{
-		ElevatorRoute* elevator_route;
+		ElevatorRoute elevator_route;
 		CallStation* callstation;
 		int call_made;
 		bool floor_selected;
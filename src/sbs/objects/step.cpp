@@ -51,4 +51,23 @@ void Step::OnHit()
 	sbs->camera->MovePosition(vector * 1.675, speed);
 }
 
+StepDirection Step::GetDirection(const std::string &direction)
+{
+	//convert a direction name to a step direction
+
+	std::string dir = direction;
+	SetCase(dir, false);
+	TrimString(dir);
+
+	if (dir == "right")
+		return STEP_RIGHT;
+	if (dir == "left")
+		return STEP_LEFT;
+	if (dir == "back")
+		return STEP_BACK;
+	if (dir == "front")
+		return STEP_FRONT;
+	return STEP_NONE;
+}
+
 }
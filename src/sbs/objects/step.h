@@ -28,6 +28,16 @@
 
 namespace SBS {
 
+//direction of the step base, for escalators and moving walkways
+enum StepDirection
+{
+	STEP_NONE,
+	STEP_RIGHT,
+	STEP_LEFT,
+	STEP_BACK,
+	STEP_FRONT
+};
+
 class SBSIMPEXP Step : public MeshObject
 {
 public:
@@ -35,6 +45,7 @@ public:
 	~Step() {}
 	void Move(const Vector3 &vector, Real speed = 1.0f);
 	void OnHit();
+	static StepDirection GetDirection(const std::string &direction);
 
 	Vector3 vector;
 	Real speed;
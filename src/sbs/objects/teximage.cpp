@@ -27,6 +27,7 @@
 #include "texman.h"
 #include "texture.h"
 #include "teximage.h"
+#include "threadpool.h"
 
 namespace SBS {
 
@@ -35,6 +36,9 @@ TextureImage::TextureImage(TextureManager* manager, const std::string &filename)
     SetName(filename);
 	this->manager = manager;
 	this->filename = filename;
+	texture = 0;
+	pending = false;
+	shared = false;
 }
 
 TextureImage::~TextureImage()
@@ -42,8 +46,11 @@ TextureImage::~TextureImage()
 
 }
 
-Ogre::TexturePtr TextureImage::LoadTexture(int mipmaps, bool &has_alpha, bool use_alpha_color, Ogre::ColourValue alpha_color)
+Ogre::TexturePtr TextureImage::LoadTexture(int mipmaps, bool &has_alpha, bool use_alpha_color, Ogre::ColourValue alpha_color, ThreadPool *pool)
 {
+	//if a thread pool is given, a new texture is created right away, and its image is read and decoded
+	//on a worker thread; the texture is then uploaded by Finish(), and has_alpha is only known then
+
 	//set verbosity level
 	Ogre::TextureManager::getSingleton().setVerbose(sbs->Verbose);
 
@@ -72,8 +79,36 @@ Ogre::TexturePtr TextureImage::LoadTexture(int mipmaps, bool &has_alpha, bool us
 			//get any existing texture
 			mTex = manager->GetTextureByName(filename2, path);
 
+			//if the existing texture is still being decoded by another image, share its upload,
+			//so that has_alpha is applied to this image's material too; otherwise wait for it
+			if (mTex && manager->IsTexturePending(mTex) == true)
+			{
+				if (pool)
+				{
+					texture = mTex;
+					pending = true;
+					shared = true;
+					return mTex;
+				}
+				manager->FinishTextures();
+			}
+
 			//if not found, load new texture
-			if (!mTex)
+			if (!mTex && pool)
+			{
+				mTex = Ogre::TextureManager::getSingleton().create(filename2, path);
+				if (mipmaps != Ogre::MIP_DEFAULT)
+					mTex->setNumMipmaps(mipmaps);
+				manager->IncrementTextureCount();
+
+				texture = mTex;
+				pending = true;
+
+				TextureImage *image = this;
+				pool->Add([image]() { image->Prepare(); });
+				return mTex;
+			}
+			else if (!mTex)
 			{
 				mTex = Ogre::TextureManager::getSingleton().load(filename2, path, Ogre::TEX_TYPE_2D, mipmaps);
 				manager->IncrementTextureCount();
@@ -122,4 +157,63 @@ Ogre::TexturePtr TextureImage::LoadTexture(int mipmaps, bool &has_alpha, bool us
 	return mTex;
 }
 
+void TextureImage::Prepare()
+{
+	//read and decode the texture image, on a worker thread
+
+	try
+	{
+		texture->prepare();
+	}
+	catch (Ogre::Exception &e)
+	{
+		error = e.getDescription();
+	}
+}
+
+bool TextureImage::Finish(bool &has_alpha, size_t &size)
+{
+	//upload a prepared texture, once its worker task has finished
+	//returns false if the texture failed to load
+
+	has_alpha = false;
+	size = 0;
+
+	if (pending == false)
+		return true;
+
+	pending = false;
+
+	//a shared texture is uploaded by the image that created it, which is finished first
+	if (error == "" && shared == false)
+	{
+		try
+		{
+			texture->load();
+		}
+		catch (Ogre::Exception &e)
+		{
+			error = e.getDescription();
+		}
+	}
+	else if (error == "" && texture->isLoaded() == false)
+		error = "Shared texture failed to load";
+
+	if (error != "")
+	{
+		if (shared == false)
+		{
+			Ogre::TextureManager::getSingleton().remove(texture);
+			manager->DecrementTextureCount();
+		}
+		texture = 0;
+		return ReportError("Error loading texture " + filename + "\n" + error);
+	}
+
+	has_alpha = texture->hasAlpha();
+	size = texture->getSize();
+	texture = 0;
+	return true;
+}
+
 }
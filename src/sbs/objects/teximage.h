@@ -31,12 +31,21 @@ class SBSIMPEXP TextureImage : public ObjectBase
 public:
     TextureImage(TextureManager *manager, const std::string &filename);
     ~TextureImage();
-	Ogre::TexturePtr LoadTexture(int mipmaps, bool &has_alpha, bool use_alpha_color = false, Ogre::ColourValue alpha_color = Ogre::ColourValue::Black);
+	Ogre::TexturePtr LoadTexture(int mipmaps, bool &has_alpha, bool use_alpha_color = false, Ogre::ColourValue alpha_color = Ogre::ColourValue::Black, ThreadPool *pool = 0);
+	bool IsPending() { return pending; }
+	Ogre::TexturePtr GetTexture() { return texture; }
+	bool Finish(bool &has_alpha, size_t &size);
 
 private:
 
+	void Prepare();
+
     TextureManager* manager;
 	std::string filename;
+	Ogre::TexturePtr texture; //texture being prepared on a worker thread
+	std::string error; //error from preparing the texture
+	bool pending; //true if the texture is waiting to be uploaded
+	bool shared; //true if the texture is being decoded and uploaded by another image
 
 };
 
@@ -0,0 +1,516 @@
+/*
+	Scalable Building Simulator - Triangle Bounding Volume Hierarchy
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <algorithm>
+#include <limits>
+#include "globals.h"
+#include "sbs.h"
+#include "mesh.h"
+#include "polymesh.h"
+#include "profiler.h"
+#include "bvh.h"
+
+namespace SBS {
+
+//build parameters
+static const uint32_t MinLeafSize = 2; //always create a leaf at or below this count
+static const uint32_t MaxLeafSize = 16; //never create a leaf above this count, unless it can't be split
+static const int BinCount = 16; //number of SAH bins per axis
+static const int MaxDepth = 48; //switch to median splits past this depth
+
+static Real Area(const Vector3 &min, const Vector3 &max)
+{
+	//get the surface area of a box
+
+	Vector3 d = max - min;
+	return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+static Real SafeInverse(Real value)
+{
+	//invert a ray direction component, avoiding infinities for axis-aligned rays
+
+	if (std::abs(value) > 1e-12)
+		return 1.0 / value;
+	return (value >= 0) ? 1e12 : -1e12;
+}
+
+static bool IntersectBox(const TriangleBVH::Node &node, const Vector3 &origin, const Vector3 &inv_dir, Real max_distance, Real &t_near)
+{
+	//slab test of a ray against a node's bounds
+
+	Real t1 = (node.min.x - origin.x) * inv_dir.x;
+	Real t2 = (node.max.x - origin.x) * inv_dir.x;
+	Real tmin = std::min(t1, t2);
+	Real tmax = std::max(t1, t2);
+
+	t1 = (node.min.y - origin.y) * inv_dir.y;
+	t2 = (node.max.y - origin.y) * inv_dir.y;
+	tmin = std::max(tmin, std::min(t1, t2));
+	tmax = std::min(tmax, std::max(t1, t2));
+
+	t1 = (node.min.z - origin.z) * inv_dir.z;
+	t2 = (node.max.z - origin.z) * inv_dir.z;
+	tmin = std::max(tmin, std::min(t1, t2));
+	tmax = std::min(tmax, std::max(t1, t2));
+
+	t_near = tmin;
+	return tmax >= std::max(tmin, Real(0)) && tmin <= max_distance;
+}
+
+TriangleBVH::TriangleBVH(MeshObject *parent) : ObjectBase(parent)
+{
+	mesh = parent;
+	removed = 0;
+	dirty = true;
+}
+
+TriangleBVH::~TriangleBVH()
+{
+
+}
+
+void TriangleBVH::Invalidate()
+{
+	//mark the hierarchy for a full rebuild on the next query
+
+	dirty = true;
+}
+
+void TriangleBVH::Build()
+{
+	//build the hierarchy from the mesh's current pick triangles
+
+	SBS_PROFILE("TriangleBVH::Build");
+
+	nodes.clear();
+	prims.clear();
+	pending.clear();
+	removed = 0;
+	dirty = false;
+
+	size_t count = mesh->pickIndices.size() / 3;
+	location.resize(count);
+
+	if (count == 0)
+		return;
+
+	const std::vector<Vector3> &pos = mesh->pickPositions;
+	const std::vector<uint32_t> &idx = mesh->pickIndices;
+
+	//get triangle bounds and centroids
+	std::vector<Vector3> tri_min (count), tri_max (count), centroids (count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const Vector3 &a = pos[idx[i * 3]];
+		const Vector3 &b = pos[idx[(i * 3) + 1]];
+		const Vector3 &c = pos[idx[(i * 3) + 2]];
+
+		tri_min[i] = a;
+		tri_min[i].makeFloor(b);
+		tri_min[i].makeFloor(c);
+		tri_max[i] = a;
+		tri_max[i].makeCeil(b);
+		tri_max[i].makeCeil(c);
+		centroids[i] = (tri_min[i] + tri_max[i]) * 0.5;
+	}
+
+	prims.resize(count);
+	for (size_t i = 0; i < count; i++)
+		prims[i] = (uint32_t)i;
+
+	nodes.reserve(count);
+	BuildNode(0, (uint32_t)count, 0, tri_min, tri_max, centroids);
+
+	for (size_t i = 0; i < prims.size(); i++)
+		location[prims[i]] = (uint32_t)i;
+}
+
+uint32_t TriangleBVH::BuildNode(uint32_t start, uint32_t count, int depth, std::vector<Vector3> &tri_min, std::vector<Vector3> &tri_max, std::vector<Vector3> &centroids)
+{
+	//recursively build a node over the given range of prims, and return its index
+
+	uint32_t index = (uint32_t)nodes.size();
+	nodes.emplace_back();
+
+	//get node and centroid bounds
+	uint32_t end = start + count;
+	Vector3 bmin = tri_min[prims[start]], bmax = tri_max[prims[start]];
+	Vector3 cmin = centroids[prims[start]], cmax = cmin;
+	for (uint32_t i = start + 1; i < end; i++)
+	{
+		uint32_t tri = prims[i];
+		bmin.makeFloor(tri_min[tri]);
+		bmax.makeCeil(tri_max[tri]);
+		cmin.makeFloor(centroids[tri]);
+		cmax.makeCeil(centroids[tri]);
+	}
+	nodes[index].min = bmin;
+	nodes[index].max = bmax;
+	nodes[index].start = start;
+	nodes[index].count = count;
+
+	if (count <= MinLeafSize)
+		return index;
+
+	//find the split with the lowest surface area heuristic cost
+	int best_axis = -1, best_bin = 0;
+	Real leaf_cost = (Real)count;
+	Real best_cost = leaf_cost;
+	Real parent_area = Area(bmin, bmax);
+	Vector3 extent = cmax - cmin;
+
+	if (depth < MaxDepth && parent_area > 0)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (extent[axis] <= 0)
+				continue;
+
+			Vector3 bin_min[BinCount], bin_max[BinCount];
+			uint32_t bin_count[BinCount] = {};
+			Real scale = BinCount / extent[axis];
+
+			for (uint32_t i = start; i < end; i++)
+			{
+				uint32_t tri = prims[i];
+				int bin = std::min(BinCount - 1, (int)((centroids[tri][axis] - cmin[axis]) * scale));
+				if (bin_count[bin] == 0)
+				{
+					bin_min[bin] = tri_min[tri];
+					bin_max[bin] = tri_max[tri];
+				}
+				else
+				{
+					bin_min[bin].makeFloor(tri_min[tri]);
+					bin_max[bin].makeCeil(tri_max[tri]);
+				}
+				bin_count[bin]++;
+			}
+
+			//sweep from the right to get the area and count right of each split plane
+			Real right_area[BinCount - 1];
+			uint32_t right_count[BinCount - 1];
+			Vector3 rmin, rmax;
+			uint32_t rcount = 0;
+			for (int i = BinCount - 1; i > 0; i--)
+			{
+				if (bin_count[i] > 0)
+				{
+					if (rcount == 0)
+					{
+						rmin = bin_min[i];
+						rmax = bin_max[i];
+					}
+					else
+					{
+						rmin.makeFloor(bin_min[i]);
+						rmax.makeCeil(bin_max[i]);
+					}
+					rcount += bin_count[i];
+				}
+				right_count[i - 1] = rcount;
+				right_area[i - 1] = (rcount > 0) ? Area(rmin, rmax) : 0;
+			}
+
+			//sweep from the left and evaluate each split plane
+			Vector3 lmin, lmax;
+			uint32_t lcount = 0;
+			for (int i = 0; i < BinCount - 1; i++)
+			{
+				if (bin_count[i] > 0)
+				{
+					if (lcount == 0)
+					{
+						lmin = bin_min[i];
+						lmax = bin_max[i];
+					}
+					else
+					{
+						lmin.makeFloor(bin_min[i]);
+						lmax.makeCeil(bin_max[i]);
+					}
+					lcount += bin_count[i];
+				}
+
+				if (lcount == 0 || right_count[i] == 0)
+					continue;
+
+				Real cost = 1 + ((Area(lmin, lmax) * lcount) + (right_area[i] * right_count[i])) / parent_area;
+				if (cost < best_cost)
+				{
+					best_cost = cost;
+					best_axis = axis;
+					best_bin = i;
+				}
+			}
+		}
+	}
+
+	//stay a leaf if splitting doesn't pay off
+	if (best_axis == -1 && count <= MaxLeafSize)
+		return index;
+
+	uint32_t mid = start;
+	if (best_axis != -1)
+	{
+		//partition prims by bin
+		Real scale = BinCount / extent[best_axis];
+		Real min = cmin[best_axis];
+		uint32_t *split = std::partition(&prims[start], &prims[start] + count, [&](uint32_t tri)
+		{
+			int bin = std::min(BinCount - 1, (int)((centroids[tri][best_axis] - min) * scale));
+			return bin <= best_bin;
+		});
+		mid = (uint32_t)(split - &prims[0]);
+	}
+
+	if (mid == start || mid == end)
+	{
+		//fall back to a median split along the longest centroid axis
+		int axis = 0;
+		if (extent.y > extent[axis])
+			axis = 1;
+		if (extent.z > extent[axis])
+			axis = 2;
+
+		mid = start + (count / 2);
+		std::nth_element(&prims[start], &prims[mid], &prims[start] + count, [&](uint32_t a, uint32_t b)
+		{
+			return centroids[a][axis] < centroids[b][axis];
+		});
+	}
+
+	//build children; the left child always follows its parent
+	BuildNode(start, mid - start, depth + 1, tri_min, tri_max, centroids);
+	uint32_t right = BuildNode(mid, end - mid, depth + 1, tri_min, tri_max, centroids);
+
+	nodes[index].start = right;
+	nodes[index].count = 0;
+	return index;
+}
+
+void TriangleBVH::Update()
+{
+	//bring the hierarchy up to date with the mesh's pick triangles
+
+	size_t count = mesh->pickIndices.size() / 3;
+
+	if (dirty == true || count < location.size())
+	{
+		Build();
+		return;
+	}
+
+	//queue triangles that were appended directly to the pick buffers
+	for (size_t i = location.size(); i < count; i++)
+		AddTriangle(i);
+
+	//rebuild if too many triangles are outside of the tree, or too many tree slots are empty
+	size_t tree_size = prims.size() - removed;
+	if (pending.size() > 64 && pending.size() > tree_size / 4)
+		Build();
+	else if (removed > 64 && removed > prims.size() / 2)
+		Build();
+}
+
+void TriangleBVH::AddTriangle(size_t index)
+{
+	//queue a newly appended triangle, to be tested linearly until the next rebuild
+
+	if (dirty == true)
+		return;
+
+	if (index != location.size())
+	{
+		Invalidate();
+		return;
+	}
+
+	location.emplace_back(Pending | (uint32_t)pending.size());
+	pending.emplace_back((uint32_t)index);
+}
+
+void TriangleBVH::RemoveTriangle(size_t index)
+{
+	//remove a triangle; this must be called before the mesh moves its last triangle
+	//into the removed slot (see MeshObject::RemoveTriOwnerFast)
+
+	if (dirty == true)
+		return;
+
+	size_t count = mesh->pickIndices.size() / 3;
+	if (count < location.size())
+	{
+		Invalidate();
+		return;
+	}
+
+	//queue triangles that were appended directly to the pick buffers
+	for (size_t i = location.size(); i < count; i++)
+		AddTriangle(i);
+
+	if (index >= count)
+		return;
+
+	Unlink(index);
+
+	//the last triangle takes over the removed index
+	size_t last = count - 1;
+	if (index != last)
+	{
+		uint32_t loc = location[last];
+		location[index] = loc;
+		if (loc & Pending)
+			pending[loc & ~Pending] = (uint32_t)index;
+		else
+			prims[loc] = (uint32_t)index;
+	}
+
+	location.pop_back();
+}
+
+void TriangleBVH::Unlink(size_t index)
+{
+	//remove a triangle from the tree or pending list
+
+	uint32_t loc = location[index];
+
+	if (loc & Pending)
+	{
+		uint32_t pos = loc & ~Pending;
+		uint32_t moved = pending.back();
+		pending[pos] = moved;
+		location[moved] = loc;
+		pending.pop_back();
+	}
+	else
+	{
+		//leave node bounds as-is; they stay conservative until the next rebuild
+		prims[loc] = Removed;
+		removed++;
+	}
+}
+
+void TriangleBVH::TestTriangle(uint32_t tri, const Vector3 &origin, const Vector3 &direction, Real &best, int &triangle)
+{
+	const std::vector<Vector3> &pos = mesh->pickPositions;
+	const std::vector<uint32_t> &idx = mesh->pickIndices;
+	size_t i = tri * 3;
+
+	Real t, u, v;
+	if (sbs->GetPolyMesh()->IntersectRayTri(origin, direction, pos[idx[i]], pos[idx[i + 1]], pos[idx[i + 2]], t, u, v) == false)
+		return;
+
+	//prefer the lowest triangle index on ties, to match a linear search
+	if (t < best || (t == best && (int)tri < triangle))
+	{
+		best = t;
+		triangle = (int)tri;
+	}
+}
+
+bool TriangleBVH::RayCast(const Vector3 &origin, const Vector3 &direction, Real &distance, int &triangle)
+{
+	//find the nearest triangle hit by a ray (direction must be normalized)
+	//returns the triangle index and distance along the ray
+
+	SBS_PROFILE("TriangleBVH::RayCast");
+
+	Update();
+
+	Real best = std::numeric_limits<Real>::infinity();
+	triangle = -1;
+
+	if (!nodes.empty())
+	{
+		Vector3 inv_dir (SafeInverse(direction.x), SafeInverse(direction.y), SafeInverse(direction.z));
+
+		stack.clear();
+		stack.emplace_back(0);
+
+		while (!stack.empty())
+		{
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node &node = nodes[index];
+
+			Real t_near;
+			if (IntersectBox(node, origin, inv_dir, best, t_near) == false)
+				continue;
+
+			if (node.count > 0)
+			{
+				for (uint32_t i = node.start; i < node.start + node.count; i++)
+				{
+					if (prims[i] != Removed)
+						TestTriangle(prims[i], origin, direction, best, triangle);
+				}
+				continue;
+			}
+
+			//visit the nearer child first
+			uint32_t left = index + 1, right = node.start;
+			Real t_left, t_right;
+			bool hit_left = IntersectBox(nodes[left], origin, inv_dir, best, t_left);
+			bool hit_right = IntersectBox(nodes[right], origin, inv_dir, best, t_right);
+
+			if (hit_left == true && hit_right == true)
+			{
+				if (t_left <= t_right)
+				{
+					stack.emplace_back(right);
+					stack.emplace_back(left);
+				}
+				else
+				{
+					stack.emplace_back(left);
+					stack.emplace_back(right);
+				}
+			}
+			else if (hit_left == true)
+				stack.emplace_back(left);
+			else if (hit_right == true)
+				stack.emplace_back(right);
+		}
+	}
+
+	//test triangles added since the last build
+	for (size_t i = 0; i < pending.size(); i++)
+		TestTriangle(pending[i], origin, direction, best, triangle);
+
+	if (triangle < 0)
+		return false;
+
+	distance = best;
+	return true;
+}
+
+size_t TriangleBVH::GetSize()
+{
+	//return size in bytes of the hierarchy
+
+	return (nodes.capacity() * sizeof(Node)) + ((prims.capacity() + location.capacity() + pending.capacity() + stack.capacity()) * sizeof(uint32_t));
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+	Scalable Building Simulator - Triangle Bounding Volume Hierarchy
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_BVH_H
+#define _SBS_BVH_H
+
+namespace SBS {
+
+//bounding volume hierarchy over a mesh object's pick triangles (pickPositions/pickIndices)
+//built with a binned surface area heuristic, and stored as a flattened depth-first node array
+class SBSIMPEXP TriangleBVH : public ObjectBase
+{
+public:
+
+	struct Node
+	{
+		Vector3 min; //node bounds
+		Vector3 max;
+		uint32_t start; //first primitive for leaves, right child node for interior nodes (left child is the next node)
+		uint32_t count; //primitive count, 0 for interior nodes
+	};
+
+	//functions
+	explicit TriangleBVH(MeshObject *parent);
+	~TriangleBVH();
+	void Build();
+	void Invalidate();
+	void AddTriangle(size_t index);
+	void RemoveTriangle(size_t index);
+	bool RayCast(const Vector3 &origin, const Vector3 &direction, Real &distance, int &triangle);
+	size_t GetNodeCount() { return nodes.size(); }
+	size_t GetPendingCount() { return pending.size(); }
+	size_t GetSize();
+
+private:
+
+	void Update();
+	uint32_t BuildNode(uint32_t start, uint32_t count, int depth, std::vector<Vector3> &tri_min, std::vector<Vector3> &tri_max, std::vector<Vector3> &centroids);
+	void Unlink(size_t index);
+	void TestTriangle(uint32_t tri, const Vector3 &origin, const Vector3 &direction, Real &best, int &triangle);
+
+	MeshObject *mesh;
+
+	std::vector<Node> nodes; //flattened node array, root first
+	std::vector<uint32_t> prims; //triangle indices in leaf order, or Removed
+	std::vector<uint32_t> location; //per-triangle position in prims, or pending list position if flagged with Pending
+	std::vector<uint32_t> pending; //triangles added since the last build, tested linearly
+	std::vector<uint32_t> stack; //traversal stack
+	size_t removed; //number of removed primitive slots in the tree
+	bool dirty; //true if a full rebuild is needed
+
+	static const uint32_t Removed = 0xFFFFFFFF;
+	static const uint32_t Pending = 0x80000000;
+};
+
+}
+
+#endif
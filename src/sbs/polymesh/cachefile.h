@@ -0,0 +1,85 @@
+/*
+	Scalable Building Simulator - Cache File Functions
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_CACHEFILE_H
+#define _SBS_CACHEFILE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace SBS {
+
+//shared functions of the binary cache files (collider cache and geometry snapshot)
+
+static const uint64_t HashSeed = 14695981039346656037ULL;
+static const uint32_t CacheByteOrder = 0x01020304;
+
+//FNV-1a hash, continued from the given hash value
+inline uint64_t Hash(const void *data, size_t size, uint64_t hash = HashSeed)
+{
+	const unsigned char *bytes = (const unsigned char*)data;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+inline uint64_t Hash(const std::string &value, uint64_t hash = HashSeed)
+{
+	//include the length, so that adjacent strings can't run together
+	uint64_t length = value.size();
+	hash = Hash(&length, sizeof(length), hash);
+	return Hash(value.data(), value.size(), hash);
+}
+
+//common start of a cache file header
+//data is only valid for the same file type, format version, scalar size and byte order
+struct CacheFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t scalar_size;
+	uint32_t byte_order;
+
+	void Set(const char *magic, uint32_t version, uint32_t scalar_size)
+	{
+		memcpy(this->magic, magic, 4);
+		this->version = version;
+		this->scalar_size = scalar_size;
+		byte_order = CacheByteOrder;
+	}
+
+	bool IsValid(const char *magic, uint32_t version, uint32_t scalar_size) const
+	{
+		return (memcmp(this->magic, magic, 4) == 0 && this->version == version && this->scalar_size == scalar_size && byte_order == CacheByteOrder);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+/*
+	Scalable Building Simulator - Collider Cache
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <fstream>
+#include <filesystem>
+#include <LinearMath/btScalar.h>
+#include "globals.h"
+#include "sbs.h"
+#include "cachefile.h"
+#include "collidercache.h"
+
+namespace SBS {
+
+//cache file header; data is only valid for the same Bullet version, scalar type and byte order
+struct CacheHeader
+{
+	CacheFileHeader file;
+	uint32_t bullet_version;
+	uint32_t count;
+};
+
+static const char CacheMagic[4] = {'S', 'B', 'C', 'C'};
+static const uint32_t CacheVersion = 2;
+
+ColliderCache::ColliderCache(Object *parent) : ObjectBase(parent)
+{
+	hits = 0;
+	modified = false;
+}
+
+ColliderCache::~ColliderCache()
+{
+
+}
+
+bool ColliderCache::Load(const std::string &filename)
+{
+	//load cache entries from the specified file
+	//returns false if the file doesn't exist or isn't a valid cache for this build
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	this->filename = filename;
+	entries.clear();
+	hits = 0;
+	modified = false;
+
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+		return false;
+
+	CacheHeader header;
+	if (!file.read((char*)&header, sizeof(header)))
+		return false;
+
+	if (header.file.IsValid(CacheMagic, CacheVersion, sizeof(btScalar)) == false || header.bullet_version != BT_BULLET_VERSION)
+	{
+		//stale cache; it will be replaced on save
+		modified = true;
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header.count; i++)
+	{
+		uint64_t key;
+		uint32_t size;
+		if (!file.read((char*)&key, sizeof(key)) || !file.read((char*)&size, sizeof(size)))
+			break;
+
+		Entry &entry = entries[key];
+		entry.data.resize(size);
+		entry.used = false;
+		if (!file.read(entry.data.data(), size))
+		{
+			//truncated file
+			entries.erase(key);
+			modified = true;
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool ColliderCache::Save()
+{
+	//save entries used by this session to the cache file, if anything changed
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (filename == "")
+		return false;
+
+	//drop entries for geometry that no longer exists
+	uint32_t count = 0;
+	for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+	{
+		if (it->second.used == true)
+			count++;
+		else
+			modified = true;
+	}
+
+	if (modified == false)
+		return true;
+
+	std::error_code error;
+	std::filesystem::path path (filename);
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path(), error);
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return ReportError("Error writing collider cache '" + filename + "'");
+
+	CacheHeader header;
+	header.file.Set(CacheMagic, CacheVersion, sizeof(btScalar));
+	header.bullet_version = BT_BULLET_VERSION;
+	header.count = count;
+	file.write((const char*)&header, sizeof(header));
+
+	for (std::unordered_map<uint64_t, Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+	{
+		if (it->second.used == false)
+			continue;
+
+		uint64_t key = it->first;
+		uint32_t size = (uint32_t)it->second.data.size();
+		file.write((const char*)&key, sizeof(key));
+		file.write((const char*)&size, sizeof(size));
+		file.write(it->second.data.data(), size);
+	}
+
+	if (!file)
+		return ReportError("Error writing collider cache '" + filename + "'");
+
+	modified = false;
+	return true;
+}
+
+bool ColliderCache::Get(uint64_t key, std::vector<char> &data)
+{
+	//get cached data for the specified key
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::unordered_map<uint64_t, Entry>::iterator it = entries.find(key);
+	if (it == entries.end())
+		return false;
+
+	it->second.used = true;
+	data = it->second.data;
+	hits++;
+	return true;
+}
+
+void ColliderCache::Add(uint64_t key, const void *data, size_t size)
+{
+	//add or replace cached data for the specified key
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	Entry &entry = entries[key];
+	entry.data.assign((const char*)data, (const char*)data + size);
+	entry.used = true;
+	modified = true;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+	Scalable Building Simulator - Collider Cache
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_COLLIDERCACHE_H
+#define _SBS_COLLIDERCACHE_H
+
+#include <mutex>
+#include <unordered_map>
+
+namespace SBS {
+
+//disk cache of baked triangle collider BVH data, keyed by a hash of each mesh's collider triangles
+//lookups and additions are thread-safe, so colliders can be built on worker threads
+class SBSIMPEXP ColliderCache : public ObjectBase
+{
+public:
+
+	explicit ColliderCache(Object *parent);
+	~ColliderCache();
+	bool Load(const std::string &filename);
+	bool Save();
+	bool Get(uint64_t key, std::vector<char> &data);
+	void Add(uint64_t key, const void *data, size_t size);
+	size_t GetCount() { return entries.size(); }
+	size_t GetHits() { return hits; }
+
+private:
+
+	std::string filename;
+	struct Entry
+	{
+		std::vector<char> data;
+		bool used; //true if looked up or added this session; only used entries are saved
+	};
+
+	std::unordered_map<uint64_t, Entry> entries;
+	std::mutex mutex;
+	size_t hits; //number of successful lookups
+	bool modified; //true if entries were added since loading
+};
+
+}
+
+#endif
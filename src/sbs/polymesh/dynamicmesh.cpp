@@ -21,6 +21,7 @@
 	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <algorithm>
 #include <OgreSceneManager.h>
 #include <OgreSubMesh.h>
 #include <OgreMeshManager.h>
@@ -43,6 +44,10 @@
 
 namespace SBS {
 
+//extra vertex space reserved in combined meshes, as a fraction (1/n) of each client's vertex count
+//and of the whole buffer, so that small changes can be written in place without a full rebuild
+static const unsigned int SlackDivisor = 8;
+
 DynamicMesh::DynamicMesh(Object* parent, SceneNode *node, const std::string &name, Real max_render_distance, bool dynamic_buffers) : ObjectBase(parent)
 {
 	//creates a new Dynamic Mesh object, which manages multiple sets of geometry data for efficiency.
@@ -397,7 +402,14 @@ void DynamicMesh::NeedsUpdate(MeshObject *client)
 		return;
 
 	if (client == 0 || meshes.size() == 1)
+	{
 		prepared = false;
+
+		//mark the client's vertex range as changed, or the whole mesh if no client is specified
+		int index = GetClientIndex(client);
+		for (size_t i = 0; i < meshes.size(); i++)
+			meshes[i]->SetDirty(index);
+	}
 	else if (meshes.size() > 1)
 	{
 		int index = GetClientIndex(client);
@@ -438,7 +450,7 @@ int DynamicMesh::GetMaterials(std::vector<std::string> &materials, int client)
 				if (!clients[i]->Walls[j]->GetPolygon(k))
 					continue;
 
-				std::string material = clients[i]->Walls[j]->GetPolygon(k)->material;
+				std::string material = clients[i]->Walls[j]->GetPolygon(k)->GetMaterial();
 
 				//find material in current list
 				bool found = false;
@@ -500,13 +512,8 @@ unsigned int DynamicMesh::GetVertexCount(const std::string &material, int client
 					if (!poly)
 						continue;
 
-					if (poly->material == material)
-					{
-						for (size_t l = 0; l < poly->geometry.size(); l++)
-						{
-								total += poly->geometry[l].size();
-						}
-					}
+					if (poly->GetMaterial() == material)
+						total += poly->GetVertexCount();
 				}
 			}
 		}
@@ -553,6 +560,14 @@ unsigned int DynamicMesh::GetIndexOffset(MeshObject *client)
 	if (meshes.size() > 1)
 		return index;
 
+	//use the client's reserved range in a prepared combined mesh
+	if (meshes.size() == 1)
+	{
+		int number = GetClientIndex(client);
+		if (number >= 0 && number < (int)meshes[0]->client_entries.size() && meshes[0]->client_entries[number].client == client)
+			return meshes[0]->client_entries[number].vertex_offset;
+	}
+
 	for (size_t i = 0; i < clients.size(); i++)
 	{
 		//if found, return current index value
@@ -590,6 +605,24 @@ void DynamicMesh::DetachClient(MeshObject *client)
 	}
 }
 
+bool DynamicMesh::Release(MeshObject *client)
+{
+	//free the render buffers of a client's separate mesh
+	//the mesh is rebuilt by the next call to NeedsUpdate for the client
+	//combined meshes are shared by all clients, and are left in place
+
+	if (meshes.size() < 2)
+		return false;
+
+	int index = GetClientIndex(client);
+
+	if (index < 0 || index >= (int)meshes.size())
+		return false;
+
+	meshes[index]->Release();
+	return true;
+}
+
 int DynamicMesh::GetSubMeshCount(int mesh_index)
 {
 	if (meshes.empty() == true)
@@ -655,6 +688,9 @@ DynamicMesh::Mesh::Mesh(DynamicMesh *parent, const std::string &name, SceneNode
 	Movable = 0;
 	auto_shadows = true;
 	parent_deleting = false;
+	buffer_used = 0;
+	buffer_capacity = 0;
+	rebuild = true;
 
 	if (!node)
 	{
@@ -714,11 +750,7 @@ DynamicMesh::Mesh::~Mesh()
 {
 	Detach();
 
-	for (size_t i = 0; i < client_entries.size(); i++)
-	{
-		delete client_entries[i].bounds;
-	}
-	client_entries.clear();
+	ClearClients();
 
 	try
 	{
@@ -866,7 +898,7 @@ void DynamicMesh::Mesh::DeleteSubMesh(int client, int index)
 							if (!poly)
 								continue;
 
-							if (poly->material == Submeshes[i].material)
+							if (poly->GetMaterial() == Submeshes[i].material)
 							{
 								used = true;
 								break;
@@ -891,7 +923,7 @@ void DynamicMesh::Mesh::DeleteSubMesh(int client, int index)
 						if (!poly)
 							continue;
 
-						if (poly->material == Submeshes[i].material)
+						if (poly->GetMaterial() == Submeshes[i].material)
 						{
 							used = true;
 							break;
@@ -926,11 +958,21 @@ void DynamicMesh::Mesh::Prepare(bool process_vertices, int client)
 	//all submeshes share mesh vertex data, but triangle indices are stored in each submesh
 	//each submesh represents a portion of the mesh that uses the same material
 
+	//combined meshes reserve slack space for each client, so that when only some clients have changed,
+	//just their vertex ranges are rewritten, and only the index buffers of their materials are rebuilt
+
 	SBS_PROFILE("DynamicMesh::Mesh::Prepare");
 
 	if (prepared == true || !node)
 		return;
 
+	//update changed clients in place, if possible
+	if (process_vertices == true && client == -1 && UpdateClients() == true)
+	{
+		prepared = true;
+		return;
+	}
+
 	unsigned int vertex_count = Parent->GetVertexCount("", client);
 
 	std::vector<std::string> materials;
@@ -943,6 +985,8 @@ void DynamicMesh::Mesh::Prepare(bool process_vertices, int client)
 			delete MeshWrapper->sharedVertexData;
 		MeshWrapper->sharedVertexData = new Ogre::VertexData();
 
+		ClearClients();
+
 		//delete any existing submeshes
 		for (size_t i = 0; i < Submeshes.size(); i++)
 		{
@@ -977,7 +1021,6 @@ void DynamicMesh::Mesh::Prepare(bool process_vertices, int client)
 		}
 		Ogre::VertexData* data = new Ogre::VertexData();
 		MeshWrapper->sharedVertexData = data;
-		data->vertexCount = vertex_count;
 		Ogre::VertexDeclaration* decl = data->vertexDeclaration;
 
 		//set up vertex data elements
@@ -988,104 +1031,56 @@ void DynamicMesh::Mesh::Prepare(bool process_vertices, int client)
 		offset += Ogre::VertexElement::getTypeSize(Ogre::VET_FLOAT3);
 		decl->addElement(0, offset, Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES); //texels
 
-		//set up vertex data arrays
-		float *mVertexElements = new float[vertex_count * 8];
-
-		//populate array with vertex geometry from each client mesh
-		unsigned int loc = 0;
+		//lay out client vertex ranges, reserving slack space if combined
+		ClearClients();
 		unsigned int vindex = 0;
 
-		//clear vertex offset, counts, and bounds tables
-		for (size_t i = 0; i < client_entries.size(); i++)
-		{
-			delete client_entries[i].bounds;
-		}
-		client_entries.clear();
-
 		for (int num = start; num <= end; num++)
 		{
-			MeshObject *mesh = Parent->GetClient(num);
-			Ogre::AxisAlignedBox client_box;
-			Real radius = 0;
-
 			ClientEntry entry;
-
-			//add current client's vertex index to offset table
+			entry.client = Parent->GetClient(num);
 			entry.vertex_offset = vindex;
+			entry.vertex_count = entry.client->GetVertexCount();
+			entry.vertex_capacity = entry.vertex_count;
+			if (client == -1)
+				entry.vertex_capacity += entry.vertex_count / SlackDivisor;
+			entry.bounds = new Ogre::AxisAlignedBox();
+			entry.radius = 0;
+			entry.dirty = false;
 
-			//get mesh's offset of associated scene node
-			Vector3 offset = sbs->ToRemote(mesh->GetPosition() - node->GetPosition());
-
-			//fill array with mesh's geometry data, from each wall
-			for (size_t index = 0; index < mesh->Walls.size(); index++)
-			{
-				if (!mesh->Walls[index])
-					continue;
-
-				for (size_t i = 0; i < mesh->Walls[index]->GetPolygonCount(); i++)
-				{
-					Polygon *poly = mesh->Walls[index]->GetPolygon(i);
-
-					if (!poly)
-						continue;
-
-					for (size_t j = 0; j < poly->geometry.size(); j++)
-					{
-						for (size_t k = 0; k < poly->geometry[j].size(); k++)
-						{
-							Geometry &element = poly->geometry[j][k];
-
-							//make mesh's vertex relative to this scene node
-							Vector3 vertex;
-							if (client == -1)
-							{
-								Vector3 raw_vertex = mesh->GetOrientation() * element.vertex; //add mesh's rotation
-								vertex = (node->GetOrientation().Inverse() * raw_vertex) + offset; //remove node's rotation and add mesh offset
-							}
-							else
-								vertex = element.vertex;
-
-							//add elements to array
-							mVertexElements[loc] = (float)vertex.x;
-							mVertexElements[loc + 1] = (float)vertex.y;
-							mVertexElements[loc + 2] = (float)vertex.z;
-							mVertexElements[loc + 3] = (float)element.normal.x;
-							mVertexElements[loc + 4] = (float)element.normal.y;
-							mVertexElements[loc + 5] = (float)element.normal.z;
-							mVertexElements[loc + 6] = (float)element.texel.x;
-							mVertexElements[loc + 7] = (float)element.texel.y;
-							client_box.merge(vertex);
-							radius = std::max(radius, vertex.length());
-							loc += 8;
-						}
-					}
-				}
-			}
+			vindex += entry.vertex_capacity;
+			client_entries.emplace_back(entry);
+		}
 
-			//store client bounding box and radius
-			entry.bounds = new Ogre::AxisAlignedBox(client_box);
-			entry.radius = radius;
+		buffer_used = vindex;
+		buffer_capacity = vindex;
+		if (client == -1)
+			buffer_capacity += vindex / SlackDivisor;
+		data->vertexCount = buffer_capacity;
 
-			//add client vertex count to list
-			entry.vertex_count = mesh->GetVertexCount();
-			vindex += entry.vertex_count;
+		//set up vertex data array, with unused space zeroed
+		float *mVertexElements = new float[buffer_capacity * 8]();
 
-			//store client information
-			client_entries.emplace_back(entry);
+		//populate array with vertex geometry from each client mesh
+		for (size_t i = 0; i < client_entries.size(); i++)
+		{
+			FillVertices(client_entries[i], &mVertexElements[client_entries[i].vertex_offset * 8], client == -1);
 		}
 
 		//create vertex hardware buffer
 		Ogre::HardwareVertexBufferSharedPtr vbuffer;
 		if (Parent->UseDynamicBuffers() == false)
-			vbuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(decl->getVertexSize(0), vertex_count, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+			vbuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(decl->getVertexSize(0), buffer_capacity, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
 		else
-			vbuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(decl->getVertexSize(0), vertex_count, Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+			vbuffer = Ogre::HardwareBufferManager::getSingleton().createVertexBuffer(decl->getVertexSize(0), buffer_capacity, Ogre::HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
 
 		vbuffer->writeData(0, vbuffer->getSizeInBytes(), mVertexElements, true);
 		delete [] mVertexElements;
 
 		//bind vertex data to mesh
 		data->vertexBufferBinding->setBinding(0, vbuffer);
+
+		rebuild = false;
 	}
 
 	//process index arrays for each submesh
@@ -1097,193 +1092,400 @@ void DynamicMesh::Mesh::Prepare(bool process_vertices, int client)
 		else
 			material = "";
 
-		Submesh *submesh;
-		int client_count;
-		unsigned int triangle_count = 0;
+		BuildSubMesh(material, client, process_vertices);
+	}
 
-		if (material != "")
-			triangle_count = Parent->GetTriangleCount(material, client_count, client);
+	//mark ogre mesh as dirty to update changes
+	MeshWrapper->_dirtyState();
 
-		//get submesh index
-		int match = FindMatchingSubMesh(material);
+	if (process_vertices == true)
+	{
+		UpdateBoundingBox();
+
+		MeshWrapper->load();
 
-		//skip if no triangles found
-		if (triangle_count == 0)
+		//if a mesh was attached and was empty, it needs to be reattached to be visible
+		if (previous_count == 0 && enabled == true)
 		{
-			//delete submesh if needed
-			DeleteSubMesh(client, -1);
-			continue;
+			Enabled(false);
+			Enabled(true);
 		}
+	}
 
-		//if a match is not found, create a new submesh
-		if (match == -1)
-			submesh = CreateSubMesh(material);
-		else
-			submesh = &Submeshes[match];
+	prepared = true;
+}
+
+void DynamicMesh::Mesh::SetDirty(int client)
+{
+	//mark a client's vertex range as changed, or the whole vertex buffer if -1
+
+	if (client >= 0 && client < (int)client_entries.size())
+		client_entries[client].dirty = true;
+	else
+		rebuild = true;
+}
+
+bool DynamicMesh::Mesh::UpdateClients()
+{
+	//rewrite the vertex ranges of changed clients in the existing vertex buffer,
+	//and rebuild the index buffers of the materials they use
+	//returns false if a full rebuild is needed instead
+
+	if (rebuild == true || buffer_capacity == 0 || !MeshWrapper->sharedVertexData)
+		return false;
+
+	//a full rebuild is needed if the client list has changed
+	int count = Parent->GetClientCount();
+	if ((int)client_entries.size() != count)
+		return false;
 
-		if (!submesh)
+	for (int i = 0; i < count; i++)
+	{
+		if (client_entries[i].client != Parent->GetClient(i))
+			return false;
+	}
+
+	Ogre::VertexData *data = MeshWrapper->sharedVertexData;
+	Ogre::HardwareVertexBufferSharedPtr vbuffer = data->vertexBufferBinding->getBuffer(0);
+	size_t vsize = data->vertexDeclaration->getVertexSize(0);
+
+	//move clients that have outgrown their reserved ranges
+	for (int i = 0; i < count; i++)
+	{
+		ClientEntry &entry = client_entries[i];
+
+		if (entry.dirty == false)
 			continue;
 
-		//skip this submesh, if old and new client counts are the same, and vertices weren't processed
-		if (client_count == submesh->clients && process_vertices == false)
+		unsigned int vertex_count = entry.client->GetVertexCount();
+		if (vertex_count > entry.vertex_capacity)
+		{
+			if (Reserve(entry, vertex_count) == false)
+				return false;
+		}
+	}
+
+	std::vector<std::string> materials; //materials used by changed clients, before and after
+	std::vector<float> elements;
+
+	for (int i = 0; i < count; i++)
+	{
+		ClientEntry &entry = client_entries[i];
+
+		if (entry.dirty == false)
 			continue;
 
-		//reset submesh's client reference count
-		submesh->clients = 0;
+		for (size_t j = 0; j < entry.materials.size(); j++)
+		{
+			if (std::find(materials.begin(), materials.end(), entry.materials[j]) == materials.end())
+				materials.emplace_back(entry.materials[j]);
+		}
 
-		//set up index data array
-		unsigned int isize = triangle_count * 3;
-		Ogre::HardwareIndexBufferSharedPtr ibuffer;
+		entry.vertex_count = entry.client->GetVertexCount();
+		elements.resize(entry.vertex_count * 8);
+		FillVertices(entry, elements.data(), true);
 
-		//if the number of vertices is greater than what can fit in a 16-bit index, use 32-bit indexes instead
-		if (vertex_count > 65536)
+		for (size_t j = 0; j < entry.materials.size(); j++)
 		{
-			//set up a 32-bit index buffer
-			unsigned int *mIndices = new unsigned int[isize];
+			if (std::find(materials.begin(), materials.end(), entry.materials[j]) == materials.end())
+				materials.emplace_back(entry.materials[j]);
+		}
 
-			//create array of triangle indices
-			unsigned int loc = 0;
+		//write client's range, without discarding the rest of the buffer
+		if (entry.vertex_count > 0)
+			vbuffer->writeData(vsize * entry.vertex_offset, vsize * entry.vertex_count, elements.data(), false);
 
-			//for each client, get triangles for a matching client submesh
-			for (int num = start; num <= end; num++)
-			{
-				MeshObject *mesh = Parent->GetClient(num);
+		entry.dirty = false;
+	}
 
-				int poly_index = 0;
+	//rebuild index buffers that reference changed clients
+	for (size_t i = 0; i < materials.size(); i++)
+	{
+		BuildSubMesh(materials[i], -1, true);
+	}
 
-				for (size_t i = 0; i < mesh->Walls.size(); i++)
-				{
-					if (!mesh->Walls[i])
-						continue;
+	UpdateBoundingBox();
 
-					for (size_t j = 0; j < mesh->Walls[i]->GetPolygonCount(); j++)
-					{
-						Polygon *poly = mesh->Walls[i]->GetPolygon(j);
+	//mark ogre mesh as dirty to update changes
+	MeshWrapper->_dirtyState();
 
-						if (!poly)
-							continue;
+	return true;
+}
 
-						if (poly->material == material)
-						{
-							//get index offset of mesh
-							unsigned int offset = Parent->GetIndexOffset(mesh);
+void DynamicMesh::Mesh::FillVertices(ClientEntry &entry, float *elements, bool transform)
+{
+	//fill an array with a client mesh's vertex data, and update the client's bounds and material list
+	//if transform is true, vertices are made relative to this mesh's scene node
 
-							//add mesh's triangles to array and adjust for offset
-							for (size_t k = 0; k < poly->triangles.size(); k++)
-							{
-								Triangle &tri = poly->triangles[k];
-								mIndices[loc] = poly_index + tri.a + offset;
-								mIndices[loc + 1] = poly_index + tri.b + offset;
-								mIndices[loc + 2] = poly_index + tri.c + offset;
-								loc += 3;
-							}
+	MeshObject *mesh = entry.client;
+	Ogre::AxisAlignedBox client_box;
+	Real radius = 0;
+	unsigned int loc = 0;
 
-							//increment submesh's client reference count
-							submesh->clients += 1;
-						}
+	entry.materials.clear();
 
-						poly_index += poly->vertex_count;
-					}
-				}
-			}
+	//get mesh's offset and rotation relative to associated scene node
+	Vector3 offset = sbs->ToRemote(mesh->GetPosition() - node->GetPosition());
+	Quaternion mesh_rotation = mesh->GetOrientation();
+	Quaternion node_rotation = node->GetOrientation().Inverse();
 
-			//create index hardware buffer
-			ibuffer = Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(Ogre::HardwareIndexBuffer::IT_32BIT, isize, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+	//fill array with mesh's geometry data, from each wall
+	for (size_t index = 0; index < mesh->Walls.size(); index++)
+	{
+		if (!mesh->Walls[index])
+			continue;
 
-			//write data to index buffer
-			ibuffer->writeData(0, ibuffer->getSizeInBytes(), mIndices, true);
-			delete [] mIndices;
-		}
-		else
+		for (size_t i = 0; i < mesh->Walls[index]->GetPolygonCount(); i++)
 		{
-			//set up a 16-bit index buffer
-			unsigned short *mIndices = new unsigned short[isize];
+			Polygon *poly = mesh->Walls[index]->GetPolygon(i);
 
-			//create array of triangle indices
-			unsigned int loc = 0;
+			if (!poly)
+				continue;
+
+			const std::string &material = poly->GetMaterial();
+			if (std::find(entry.materials.begin(), entry.materials.end(), material) == entry.materials.end())
+				entry.materials.emplace_back(material);
 
-			//for each client, get triangles for a matching client submesh
-			for (int num = start; num <= end; num++)
+			//read vertex data directly from the mesh's geometry pool
+			const Vector3 *positions = poly->GetPositions();
+			const Vector3 *normals = poly->GetNormals();
+			const Vector2 *texels = poly->GetTexels();
+
+			for (size_t j = 0; j < poly->GetVertexCount(); j++)
 			{
-				MeshObject *mesh = Parent->GetClient(num);
+				//make mesh's vertex relative to this scene node
+				Vector3 vertex;
+				if (transform == true)
+					vertex = (node_rotation * (mesh_rotation * positions[j])) + offset; //add mesh's rotation, remove node's rotation and add mesh offset
+				else
+					vertex = positions[j];
+
+				//add elements to array
+				elements[loc] = (float)vertex.x;
+				elements[loc + 1] = (float)vertex.y;
+				elements[loc + 2] = (float)vertex.z;
+				elements[loc + 3] = (float)normals[j].x;
+				elements[loc + 4] = (float)normals[j].y;
+				elements[loc + 5] = (float)normals[j].z;
+				elements[loc + 6] = (float)texels[j].x;
+				elements[loc + 7] = (float)texels[j].y;
+				client_box.merge(vertex);
+				radius = std::max(radius, vertex.length());
+				loc += 8;
+			}
+		}
+	}
 
-				int poly_index = 0;
+	//store client bounding box and radius
+	*entry.bounds = client_box;
+	entry.radius = radius;
+}
 
-				for (size_t i = 0; i < mesh->Walls.size(); i++)
-				{
-					if (!mesh->Walls[i])
-						continue;
+void DynamicMesh::Mesh::BuildSubMesh(const std::string &material, int client, bool force)
+{
+	//build the index buffer of the submesh using the specified material, from the triangles
+	//of the specified client, or all clients if -1
+	//if force is false, skip the submesh if its client count hasn't changed
 
-					for (size_t j = 0; j < mesh->Walls[i]->GetPolygonCount(); j++)
-					{
-						Polygon *poly = mesh->Walls[i]->GetPolygon(j);
+	Submesh *submesh;
+	int client_count;
+	unsigned int triangle_count = 0;
 
-						if (!poly)
-							continue;
+	if (material != "")
+		triangle_count = Parent->GetTriangleCount(material, client_count, client);
 
-						if (poly->material == material)
-						{
-							//get index offset of mesh
-							unsigned int offset = Parent->GetIndexOffset(mesh);
+	//get submesh index
+	int match = FindMatchingSubMesh(material);
 
-							//add mesh's triangles to array and adjust for offset
-							for (size_t k = 0; k < poly->triangles.size(); k++)
-							{
-								Triangle &tri = poly->triangles[k];
-								mIndices[loc] = poly_index + tri.a + offset;
-								mIndices[loc + 1] = poly_index + tri.b + offset;
-								mIndices[loc + 2] = poly_index + tri.c + offset;
-								loc += 3;
-							}
+	//skip if no triangles found
+	if (triangle_count == 0)
+	{
+		//delete submesh if needed
+		DeleteSubMesh(client, -1);
+		return;
+	}
 
-							//increment submesh's client reference count
-							submesh->clients += 1;
-						}
+	//if a match is not found, create a new submesh
+	if (match == -1)
+		submesh = CreateSubMesh(material);
+	else
+		submesh = &Submeshes[match];
+
+	if (!submesh)
+		return;
+
+	//skip this submesh, if old and new client counts are the same, and vertices weren't processed
+	if (client_count == submesh->clients && force == false)
+		return;
+
+	//reset submesh's client reference count
+	submesh->clients = 0;
+
+	int start = 0;
+	int end = Parent->GetClientCount() - 1;
+
+	if (client > -1)
+	{
+		start = client;
+		end = client;
+	}
 
-						poly_index += poly->vertex_count;
+	//set up index data array
+	unsigned int isize = triangle_count * 3;
+	unsigned int *mIndices = new unsigned int[isize];
+
+	//create array of triangle indices
+	unsigned int loc = 0;
+
+	//for each client, get triangles for a matching client submesh
+	for (int num = start; num <= end; num++)
+	{
+		MeshObject *mesh = Parent->GetClient(num);
+
+		//get index offset of mesh
+		unsigned int offset = 0;
+		if (num - start < (int)client_entries.size())
+			offset = client_entries[num - start].vertex_offset;
+
+		int poly_index = 0;
+
+		for (size_t i = 0; i < mesh->Walls.size(); i++)
+		{
+			if (!mesh->Walls[i])
+				continue;
+
+			for (size_t j = 0; j < mesh->Walls[i]->GetPolygonCount(); j++)
+			{
+				Polygon *poly = mesh->Walls[i]->GetPolygon(j);
+
+				if (!poly)
+					continue;
+
+				if (poly->GetMaterial() == material)
+				{
+					//add mesh's triangles to array and adjust for offset
+					const Triangle *triangles = poly->GetTriangles();
+					for (size_t k = 0; k < poly->GetTriangleCount(); k++)
+					{
+						const Triangle &tri = triangles[k];
+						mIndices[loc] = poly_index + tri.a + offset;
+						mIndices[loc + 1] = poly_index + tri.b + offset;
+						mIndices[loc + 2] = poly_index + tri.c + offset;
+						loc += 3;
 					}
+
+					//increment submesh's client reference count
+					submesh->clients += 1;
 				}
+
+				poly_index += poly->GetVertexCount();
 			}
+		}
+	}
 
-			//create index hardware buffer
-			ibuffer = Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(Ogre::HardwareIndexBuffer::IT_16BIT, isize, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+	Ogre::HardwareIndexBufferSharedPtr ibuffer;
 
-			//write data to index buffer
-			ibuffer->writeData(0, ibuffer->getSizeInBytes(), mIndices, true);
-			delete [] mIndices;
-		}
+	size_t vertex_count = 0;
+	if (MeshWrapper->sharedVertexData)
+		vertex_count = MeshWrapper->sharedVertexData->vertexCount;
 
-		//delete any old index data
-		if (submesh->object->indexData)
-		{
-			delete submesh->object->indexData;
-			submesh->object->indexData = new Ogre::IndexData();
-		}
+	//if the number of vertices is greater than what can fit in a 16-bit index, use 32-bit indexes instead
+	if (vertex_count > 65536)
+	{
+		//create 32-bit index hardware buffer, and write data to it
+		ibuffer = Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(Ogre::HardwareIndexBuffer::IT_32BIT, isize, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+		ibuffer->writeData(0, ibuffer->getSizeInBytes(), mIndices, true);
+	}
+	else
+	{
+		//convert to 16-bit indices
+		unsigned short *mShortIndices = new unsigned short[isize];
+		for (unsigned int i = 0; i < isize; i++)
+			mShortIndices[i] = (unsigned short)mIndices[i];
+
+		//create 16-bit index hardware buffer, and write data to it
+		ibuffer = Ogre::HardwareBufferManager::getSingleton().createIndexBuffer(Ogre::HardwareIndexBuffer::IT_16BIT, isize, Ogre::HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+		ibuffer->writeData(0, ibuffer->getSizeInBytes(), mShortIndices, true);
+		delete [] mShortIndices;
+	}
+	delete [] mIndices;
 
-		//bind index data to submesh
-		submesh->object->indexData->indexCount = isize;
-		submesh->object->indexData->indexBuffer = ibuffer;
-		submesh->object->indexData->indexStart = 0;
+	//delete any old index data
+	if (submesh->object->indexData)
+	{
+		delete submesh->object->indexData;
+		submesh->object->indexData = new Ogre::IndexData();
 	}
 
-	//mark ogre mesh as dirty to update changes
-	MeshWrapper->_dirtyState();
+	//bind index data to submesh
+	submesh->object->indexData->indexCount = isize;
+	submesh->object->indexData->indexBuffer = ibuffer;
+	submesh->object->indexData->indexStart = 0;
+}
 
-	if (process_vertices == true)
+bool DynamicMesh::Mesh::Reserve(ClientEntry &entry, unsigned int vertex_count)
+{
+	//move a client that has outgrown its range to a released range, or to the unused space
+	//at the end of the vertex buffer, and release its old range
+	//returns false if there isn't enough space, and the buffer needs a full rebuild
+
+	unsigned int offset = 0;
+	unsigned int capacity = 0;
+
+	//find the smallest released range that fits
+	size_t best = free_ranges.size();
+	for (size_t i = 0; i < free_ranges.size(); i++)
 	{
-		UpdateBoundingBox();
+		if (free_ranges[i].count < vertex_count)
+			continue;
 
-		MeshWrapper->load();
+		if (best == free_ranges.size() || free_ranges[i].count < free_ranges[best].count)
+			best = i;
+	}
 
-		//if a mesh was attached and was empty, it needs to be reattached to be visible
-		if (previous_count == 0 && enabled == true)
-		{
-			Enabled(false);
-			Enabled(true);
-		}
+	if (best < free_ranges.size())
+	{
+		offset = free_ranges[best].offset;
+		capacity = free_ranges[best].count;
+		free_ranges.erase(free_ranges.begin() + best);
+	}
+	else if (buffer_used + vertex_count <= buffer_capacity)
+	{
+		//allocate from end of buffer, with slack space if available
+		offset = buffer_used;
+		capacity = std::min(vertex_count + (vertex_count / SlackDivisor), buffer_capacity - buffer_used);
+		buffer_used += capacity;
 	}
+	else
+		return false;
 
-	prepared = true;
+	//release old range
+	if (entry.vertex_capacity > 0)
+	{
+		FreeRange range;
+		range.offset = entry.vertex_offset;
+		range.count = entry.vertex_capacity;
+		free_ranges.emplace_back(range);
+	}
+
+	entry.vertex_offset = offset;
+	entry.vertex_capacity = capacity;
+	return true;
+}
+
+void DynamicMesh::Mesh::ClearClients()
+{
+	//clear vertex offset, counts, and bounds tables, and released ranges
+
+	for (size_t i = 0; i < client_entries.size(); i++)
+	{
+		delete client_entries[i].bounds;
+	}
+	client_entries.clear();
+	free_ranges.clear();
+	buffer_used = 0;
+	buffer_capacity = 0;
+	rebuild = true;
 }
 
 void DynamicMesh::Mesh::EnableDebugView(bool value)
@@ -1404,36 +1606,35 @@ void DynamicMesh::Mesh::UpdateVertices(int client, const std::string &material,
 			if (single == true)
 			{
 				//match material
-				if (poly->material != material)
+				if (poly->GetMaterial() != material)
 					continue;
 
 				if (poly != polygon)
 					continue;
 			}
 
-			for (size_t k = 0; k < poly->geometry.size(); k++)
+			const Vector3 *positions = poly->GetPositions();
+			const Vector3 *normals = poly->GetNormals();
+			const Vector2 *texels = poly->GetTexels();
+
+			for (size_t k = 0; k < poly->GetVertexCount(); k++)
 			{
-				for (size_t l = 0; l < poly->geometry[k].size(); l++)
-				{
-					Geometry &element = poly->geometry[k][l];
-
-					//make mesh's vertex relative to this scene node
-					Vector3 raw_vertex = mesh->GetOrientation() * element.vertex; //add mesh's rotation
-					Vector3 vertex2 = (node->GetOrientation().Inverse() * raw_vertex) + offset; //remove node's rotation and add mesh offset
-
-					//add elements to array
-					mVertexElements[pos] = (float)vertex2.x;
-					mVertexElements[pos + 1] = (float)vertex2.y;
-					mVertexElements[pos + 2] = (float)vertex2.z;
-					mVertexElements[pos + 3] = (float)element.normal.x;
-					mVertexElements[pos + 4] = (float)element.normal.y;
-					mVertexElements[pos + 5] = (float)element.normal.z;
-					mVertexElements[pos + 6] = (float)element.texel.x;
-					mVertexElements[pos + 7] = (float)element.texel.y;
-					box.merge(vertex2);
-					pos += 8;
-					add += 1;
-				}
+				//make mesh's vertex relative to this scene node
+				Vector3 raw_vertex = mesh->GetOrientation() * positions[k]; //add mesh's rotation
+				Vector3 vertex2 = (node->GetOrientation().Inverse() * raw_vertex) + offset; //remove node's rotation and add mesh offset
+
+				//add elements to array
+				mVertexElements[pos] = (float)vertex2.x;
+				mVertexElements[pos + 1] = (float)vertex2.y;
+				mVertexElements[pos + 2] = (float)vertex2.z;
+				mVertexElements[pos + 3] = (float)normals[k].x;
+				mVertexElements[pos + 4] = (float)normals[k].y;
+				mVertexElements[pos + 5] = (float)normals[k].z;
+				mVertexElements[pos + 6] = (float)texels[k].x;
+				mVertexElements[pos + 7] = (float)texels[k].y;
+				box.merge(vertex2);
+				pos += 8;
+				add += 1;
 			}
 		}
 	}
@@ -1488,6 +1689,29 @@ void DynamicMesh::Mesh::Detach()
 	node = 0;
 }
 
+void DynamicMesh::Mesh::Release()
+{
+	//free vertex and index buffers, keeping the entity attached to the mesh
+
+	if (!node)
+		return;
+
+	SBS_PROFILE("DynamicMesh::Mesh::Release");
+
+	if (MeshWrapper->sharedVertexData)
+		delete MeshWrapper->sharedVertexData;
+	MeshWrapper->sharedVertexData = new Ogre::VertexData();
+
+	ClearClients();
+
+	//delete submeshes, last first so indices stay valid
+	for (int i = (int)Submeshes.size() - 1; i >= 0; i--)
+		DeleteSubMesh(-1, i);
+
+	MeshWrapper->_dirtyState();
+	prepared = false;
+}
+
 int DynamicMesh::Mesh::GetSubMeshCount()
 {
 	return MeshWrapper->getNumSubMeshes();
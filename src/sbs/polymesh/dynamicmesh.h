@@ -57,6 +57,7 @@ public:
 	bool UseDynamicBuffers() { return dynamic_buffers; }
 	void UpdateVertices(MeshObject *client, const std::string &material = "", Polygon *polygon = 0, bool single = false);
 	void DetachClient(MeshObject *client);
+	bool Release(MeshObject *client);
 	int GetMeshCount() { return (int)meshes.size(); }
 	int GetSubMeshCount(int mesh_index);
 	std::string GetMeshName(int mesh_index);
@@ -86,16 +87,27 @@ private:
 		int GetSubMeshCount();
 		void UpdateVertices(int client, const std::string &material, Polygon *polygon = 0, bool single = false);
 		void Detach();
+		void Release();
 		void UpdateBoundingBox();
 		void EnableShadows(bool value);
 		void SetMaterial(const std::string& material);
 
 		struct ClientEntry
 		{
+			MeshObject *client; //client mesh this entry was built from
 			unsigned int vertex_offset;
 			unsigned int vertex_count;
+			unsigned int vertex_capacity; //vertices reserved in the buffer, including slack space
 			Ogre::AxisAlignedBox* bounds;
 			Real radius;
+			std::vector<std::string> materials; //materials used by the client when last written
+			bool dirty; //client's vertices need to be rewritten
+		};
+
+		struct FreeRange
+		{
+			unsigned int offset;
+			unsigned int count;
 		};
 
 		struct Submesh
@@ -105,10 +117,21 @@ private:
 			std::string material;
 		};
 
+		void SetDirty(int client);
+		bool UpdateClients();
+		void FillVertices(ClientEntry &entry, float *elements, bool transform);
+		void BuildSubMesh(const std::string &material, int client, bool force);
+		bool Reserve(ClientEntry &entry, unsigned int vertex_count);
+		void ClearClients();
+
 		std::string name;
 		Ogre::MeshPtr MeshWrapper; //mesh
 		std::vector<Submesh> Submeshes; //submeshes (per-material mesh)
 		std::vector<ClientEntry> client_entries; //per-client information
+		std::vector<FreeRange> free_ranges; //released vertex ranges in a combined vertex buffer
+		unsigned int buffer_used; //vertices allocated from the start of the vertex buffer
+		unsigned int buffer_capacity; //total vertices in the vertex buffer
+		bool rebuild; //true if the vertex buffer needs a full rebuild
 		Ogre::Entity *Movable;
 		SceneNode *node;
 		DynamicMesh *Parent;
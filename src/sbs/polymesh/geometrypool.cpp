@@ -0,0 +1,254 @@
+/*
+	Scalable Building Simulator - Geometry Pool
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "globals.h"
+#include "sbs.h"
+#include "mesh.h"
+#include "wall.h"
+#include "polygon.h"
+#include "profiler.h"
+#include "geometrypool.h"
+
+namespace SBS {
+
+//minimum number of unused vertices before the pool is compacted
+static const size_t MinCompactSize = 1024;
+
+GeometryPool::GeometryPool(MeshObject *parent) : ObjectBase(parent)
+{
+	mesh = parent;
+	unused_vertices = 0;
+	unused_triangles = 0;
+
+	//material ID 0 is no material
+	GetMaterialID("");
+}
+
+GeometryPool::~GeometryPool()
+{
+
+}
+
+void GeometryPool::Allocate(Range &range, const GeometrySet &geometry, const std::vector<Triangle> &triangles)
+{
+	//append a polygon's geometry to the end of the pool, and set its range
+
+	range.vertex_start = (uint32_t)positions.size();
+	range.ring_start = (uint32_t)rings.size();
+	range.ring_count = (uint32_t)geometry.size();
+	range.triangle_start = (uint32_t)this->triangles.size();
+	range.triangle_count = (uint32_t)triangles.size();
+
+	size_t count = 0;
+	for (size_t i = 0; i < geometry.size(); i++)
+		count += geometry[i].size();
+	range.vertex_count = (uint32_t)count;
+
+	positions.reserve(positions.size() + count);
+	normals.reserve(normals.size() + count);
+	texels.reserve(texels.size() + count);
+
+	for (size_t i = 0; i < geometry.size(); i++)
+	{
+		rings.emplace_back((uint32_t)geometry[i].size());
+
+		for (size_t j = 0; j < geometry[i].size(); j++)
+		{
+			const Geometry &data = geometry[i][j];
+			positions.emplace_back(data.vertex);
+			normals.emplace_back(data.normal);
+			texels.emplace_back(data.texel);
+		}
+	}
+
+	this->triangles.insert(this->triangles.end(), triangles.begin(), triangles.end());
+}
+
+void GeometryPool::Allocate(Range &range, const GeometryArray &geometry, const std::vector<Triangle> &triangles)
+{
+	//append a single-ring polygon's geometry to the end of the pool, and set its range
+
+	range.vertex_start = (uint32_t)positions.size();
+	range.vertex_count = (uint32_t)geometry.size();
+	range.ring_start = (uint32_t)rings.size();
+	range.ring_count = 1;
+	range.triangle_start = (uint32_t)this->triangles.size();
+	range.triangle_count = (uint32_t)triangles.size();
+
+	rings.emplace_back((uint32_t)geometry.size());
+
+	for (size_t i = 0; i < geometry.size(); i++)
+	{
+		positions.emplace_back(geometry[i].vertex);
+		normals.emplace_back(geometry[i].normal);
+		texels.emplace_back(geometry[i].texel);
+	}
+
+	this->triangles.insert(this->triangles.end(), triangles.begin(), triangles.end());
+}
+
+void GeometryPool::Free(Range &range)
+{
+	//release a polygon's range
+	//the space is reclaimed by the next compaction
+
+	unused_vertices += range.vertex_count;
+	unused_triangles += range.triangle_count;
+	range = Range();
+}
+
+void GeometryPool::GetGeometry(const Range &range, GeometrySet &geometry)
+{
+	//get a copy of a range's geometry, split into rings
+
+	geometry.clear();
+	geometry.resize(range.ring_count);
+
+	size_t index = range.vertex_start;
+	for (size_t i = 0; i < range.ring_count; i++)
+	{
+		size_t count = rings[range.ring_start + i];
+		geometry[i].resize(count);
+
+		for (size_t j = 0; j < count; j++)
+		{
+			Geometry &data = geometry[i][j];
+			data.vertex = positions[index];
+			data.normal = normals[index];
+			data.texel = texels[index];
+			index++;
+		}
+	}
+}
+
+int GeometryPool::GetMaterialID(const std::string &material)
+{
+	//get the ID of a material name, adding it to the material table if needed
+
+	std::unordered_map<std::string, int>::const_iterator it = material_ids.find(material);
+	if (it != material_ids.end())
+		return it->second;
+
+	int id = (int)materials.size();
+	materials.emplace_back(material);
+	material_ids[material] = id;
+	return id;
+}
+
+const std::string& GeometryPool::GetMaterial(int id)
+{
+	//get a material name by ID
+
+	if (id < 0 || id >= (int)materials.size())
+		return materials[0];
+
+	return materials[id];
+}
+
+bool GeometryPool::Compact(bool force)
+{
+	//remove unused space left by deleted and replaced polygons, by rewriting the geometry
+	//of all of the mesh's polygons in wall order, and updating their ranges
+	//this only runs if more than half of the pool is unused, unless force is true
+	//returns true if the pool was compacted
+
+	if (unused_vertices == 0 && unused_triangles == 0)
+		return false;
+
+	if (force == false && (unused_vertices < MinCompactSize || unused_vertices * 2 < positions.size()))
+		return false;
+
+	SBS_PROFILE("GeometryPool::Compact");
+
+	size_t vertex_total = positions.size() - unused_vertices;
+	size_t triangle_total = triangles.size() - unused_triangles;
+
+	std::vector<Vector3> new_positions, new_normals;
+	std::vector<Vector2> new_texels;
+	std::vector<uint32_t> new_rings;
+	std::vector<Triangle> new_triangles;
+	new_positions.reserve(vertex_total);
+	new_normals.reserve(vertex_total);
+	new_texels.reserve(vertex_total);
+	new_triangles.reserve(triangle_total);
+
+	for (size_t i = 0; i < mesh->Walls.size(); i++)
+	{
+		Wall *wall = mesh->Walls[i];
+		if (!wall)
+			continue;
+
+		for (int j = 0; j < wall->GetPolygonCount(); j++)
+		{
+			Polygon *poly = wall->GetPolygon(j);
+			if (!poly)
+				continue;
+
+			Range &range = poly->range;
+			Range moved;
+			moved.vertex_start = (uint32_t)new_positions.size();
+			moved.vertex_count = range.vertex_count;
+			moved.ring_start = (uint32_t)new_rings.size();
+			moved.ring_count = range.ring_count;
+			moved.triangle_start = (uint32_t)new_triangles.size();
+			moved.triangle_count = range.triangle_count;
+
+			new_positions.insert(new_positions.end(), positions.begin() + range.vertex_start, positions.begin() + range.vertex_start + range.vertex_count);
+			new_normals.insert(new_normals.end(), normals.begin() + range.vertex_start, normals.begin() + range.vertex_start + range.vertex_count);
+			new_texels.insert(new_texels.end(), texels.begin() + range.vertex_start, texels.begin() + range.vertex_start + range.vertex_count);
+			new_rings.insert(new_rings.end(), rings.begin() + range.ring_start, rings.begin() + range.ring_start + range.ring_count);
+			new_triangles.insert(new_triangles.end(), triangles.begin() + range.triangle_start, triangles.begin() + range.triangle_start + range.triangle_count);
+
+			range = moved;
+		}
+	}
+
+	positions.swap(new_positions);
+	normals.swap(new_normals);
+	texels.swap(new_texels);
+	rings.swap(new_rings);
+	triangles.swap(new_triangles);
+
+	unused_vertices = 0;
+	unused_triangles = 0;
+	return true;
+}
+
+size_t GeometryPool::GetSize()
+{
+	//return size in bytes of the pool, including allocated array space
+
+	size_t size = sizeof(GeometryPool);
+	size += positions.capacity() * sizeof(Vector3);
+	size += normals.capacity() * sizeof(Vector3);
+	size += texels.capacity() * sizeof(Vector2);
+	size += rings.capacity() * sizeof(uint32_t);
+	size += triangles.capacity() * sizeof(Triangle);
+
+	for (size_t i = 0; i < materials.size(); i++)
+		size += sizeof(std::string) + materials[i].capacity();
+
+	return size;
+}
+
+}
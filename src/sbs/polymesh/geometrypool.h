@@ -0,0 +1,94 @@
+/*
+	Scalable Building Simulator - Geometry Pool
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_GEOMETRYPOOL_H
+#define _SBS_GEOMETRYPOOL_H
+
+#include <unordered_map>
+#include "triangle.h"
+
+namespace SBS {
+
+struct Geometry
+{
+	//basic 3D geometry
+	Vector3 vertex;
+	Vector2 texel;
+	Vector3 normal;
+};
+
+typedef std::vector<std::vector<Geometry> > GeometrySet;
+typedef std::vector<Geometry> GeometryArray;
+
+//pooled geometry storage of a mesh object's polygons, as contiguous position, normal and texel arrays,
+//a ring table (vertex count of each sub-polygon), and a shared triangle array.
+//polygons are views into the pool, and triangle indices are relative to the polygon's first vertex.
+//freed ranges are left in place until Compact() is called with enough unused space
+class SBSIMPEXP GeometryPool : public ObjectBase
+{
+public:
+
+	struct Range
+	{
+		uint32_t vertex_start;
+		uint32_t vertex_count;
+		uint32_t ring_start;
+		uint32_t ring_count;
+		uint32_t triangle_start;
+		uint32_t triangle_count;
+
+		Range() : vertex_start(0), vertex_count(0), ring_start(0), ring_count(0), triangle_start(0), triangle_count(0) {}
+	};
+
+	std::vector<Vector3> positions;
+	std::vector<Vector3> normals;
+	std::vector<Vector2> texels;
+	std::vector<uint32_t> rings;
+	std::vector<Triangle> triangles;
+
+	//functions
+	explicit GeometryPool(MeshObject *parent);
+	~GeometryPool();
+	void Allocate(Range &range, const GeometrySet &geometry, const std::vector<Triangle> &triangles);
+	void Allocate(Range &range, const GeometryArray &geometry, const std::vector<Triangle> &triangles);
+	void Free(Range &range);
+	void GetGeometry(const Range &range, GeometrySet &geometry);
+	int GetMaterialID(const std::string &material);
+	const std::string& GetMaterial(int id);
+	bool Compact(bool force = false);
+	size_t GetUnusedCount() { return unused_vertices; }
+	size_t GetSize();
+
+private:
+
+	MeshObject *mesh;
+
+	std::vector<std::string> materials; //material table, indexed by material ID
+	std::unordered_map<std::string, int> material_ids;
+	size_t unused_vertices; //vertices in freed ranges
+	size_t unused_triangles; //triangles in freed ranges
+};
+
+}
+
+#endif
@@ -39,8 +39,12 @@
 #include "dynamicmesh.h"
 #include "polymesh.h"
 #include "polygon.h"
+#include "geometrypool.h"
 #include "utility.h"
 #include "mesh.h"
+#include "bvh.h"
+#include "cachefile.h"
+#include "collidercache.h"
 
 namespace SBS {
 
@@ -67,8 +71,14 @@ MeshObject::MeshObject(Object* parent, const std::string &name, DynamicMesh* wra
 	model_loaded = false;
 	Bounds = new Ogre::AxisAlignedBox();
 	collidermesh = 0;
-	size = 0;
 	tricollider = true;
+	pick_bvh = 0;
+	evicted = false;
+	released = false;
+	wall_bounds_min = Vector3::ZERO;
+	wall_bounds_max = Vector3::ZERO;
+	has_wall_bounds = false;
+	geometry_pool = new GeometryPool(this);
 
 	std::string Name = GetSceneNode()->GetFullName();
 	this->name = Name;
@@ -119,6 +129,11 @@ MeshObject::~MeshObject()
 	//delete wall objects
 	DeleteWalls();
 
+	//delete geometry pool, after the polygons that use it
+	if (geometry_pool)
+		delete geometry_pool;
+	geometry_pool = 0;
+
 	if (collider_node)
 		delete collider_node;
 	collider_node = 0;
@@ -139,6 +154,10 @@ MeshObject::~MeshObject()
 	if (Bounds)
 		delete Bounds;
 	Bounds = 0;
+
+	if (pick_bvh)
+		delete pick_bvh;
+	pick_bvh = 0;
 }
 
 void MeshObject::GetBounds()
@@ -164,6 +183,10 @@ bool MeshObject::Enabled(bool value)
 
 	SBS_PROFILE("MeshObject::Enable");
 
+	//rebuild an evicted mesh before showing it
+	if (value == true && evicted == true)
+		Restore();
+
 	bool status = MeshWrapper->Enabled(value, this);
 
 	EnableCollider(value);
@@ -241,6 +264,9 @@ void MeshObject::Prepare(bool force)
 	if (prepared == true && force == false)
 		return;
 
+	//reclaim geometry pool space from deleted polygons
+	geometry_pool->Compact();
+
 	//set up bounding box
 	CreateBoundingBox();
 
@@ -359,6 +385,7 @@ void MeshObject::DeleteWalls()
 		}
 	}
 	Walls.clear();
+	has_wall_bounds = false;
 }
 
 void MeshObject::DeleteWalls(Object *parent)
@@ -380,6 +407,8 @@ void MeshObject::DeleteWalls(Object *parent)
 			}
 		}
 	}
+
+	geometry_pool->Compact();
 }
 
 Vector3 MeshObject::GetPoint(const std::string &wallname, const Vector3 &start, const Vector3 &end)
@@ -485,6 +514,14 @@ void MeshObject::Cut(Vector3 start, Vector3 end, bool cutwalls, bool cutfloors,
 {
 	//cut all walls in this mesh object
 
+	//skip the walls if the box misses the whole mesh, unless doorway checks need to be reset by the wall cuts
+	if (checkwallnumber == 0 || reset_check == false)
+	{
+		Vector3 min, max;
+		if (GetWallBounds(min, max) == false || PolyMesh::BoxOverlaps(min, max, start, end) == false)
+			return;
+	}
+
 	for (size_t i = 0; i < Walls.size(); i++)
 	{
 		if (!Walls[i])
@@ -492,6 +529,67 @@ void MeshObject::Cut(Vector3 start, Vector3 end, bool cutwalls, bool cutfloors,
 
 		sbs->GetPolyMesh()->Cut(Walls[i], start, end, cutwalls, cutfloors, checkwallnumber, reset_check);
 	}
+
+	//reclaim geometry pool space from replaced polygons
+	geometry_pool->Compact();
+}
+
+void MeshObject::Cut(const std::vector<CutBox> &boxes, bool cutwalls, bool cutfloors)
+{
+	//cut a set of boxes from all walls in this mesh object, in a single pass over the walls
+	//boxes that miss the mesh are dropped, and the rest are only applied to walls they intersect
+
+	Vector3 min, max;
+	if (GetWallBounds(min, max) == false)
+		return;
+
+	std::vector<CutBox> hits;
+	for (size_t i = 0; i < boxes.size(); i++)
+	{
+		if (PolyMesh::BoxOverlaps(min, max, boxes[i].start, boxes[i].end) == true)
+			hits.emplace_back(boxes[i]);
+	}
+
+	if (hits.empty())
+		return;
+
+	for (size_t i = 0; i < Walls.size(); i++)
+	{
+		if (!Walls[i])
+			continue;
+
+		sbs->GetPolyMesh()->Cut(Walls[i], hits, cutwalls, cutfloors);
+	}
+
+	//reclaim geometry pool space from replaced polygons
+	geometry_pool->Compact();
+}
+
+bool MeshObject::GetWallBounds(Vector3 &min, Vector3 &max)
+{
+	//get the bounding box of this mesh's wall polygons, in local positioning
+	//the box can be larger than the current polygons, since it isn't shrunk when polygons are removed
+	//returns false if no polygons have been added
+
+	min = wall_bounds_min;
+	max = wall_bounds_max;
+	return has_wall_bounds;
+}
+
+void MeshObject::AddWallBounds(const Vector3 &min, const Vector3 &max)
+{
+	//grow the wall bounding box to include the specified box
+
+	if (has_wall_bounds == false)
+	{
+		wall_bounds_min = min;
+		wall_bounds_max = max;
+		has_wall_bounds = true;
+		return;
+	}
+
+	wall_bounds_min.makeFloor(min);
+	wall_bounds_max.makeCeil(max);
 }
 
 void MeshObject::CutOutsideBounds(Vector3 start, Vector3 end, bool cutwalls, bool cutfloors)
@@ -507,10 +605,13 @@ void MeshObject::CutOutsideBounds(Vector3 start, Vector3 end, bool cutwalls, boo
 	Vector3 back_min (-limit, -limit, end.z);
 	Vector3 back_max (limit, limit, limit);
 
-	Cut(left_min, left_max, cutwalls, cutfloors);
-	Cut(right_min, right_max, cutwalls, cutfloors);
-	Cut(front_min, front_max, cutwalls, cutfloors);
-	Cut(back_min, back_max, cutwalls, cutfloors);
+	std::vector<CutBox> boxes;
+	boxes.emplace_back(CutBox(left_min, left_max));
+	boxes.emplace_back(CutBox(right_min, right_max));
+	boxes.emplace_back(CutBox(front_min, front_max));
+	boxes.emplace_back(CutBox(back_min, back_max));
+
+	Cut(boxes, cutwalls, cutfloors);
 }
 
 bool MeshObject::LoadFromFile(const std::string &filename)
@@ -710,14 +811,11 @@ Real MeshObject::GetHeight()
 			if (!poly)
 				continue;
 
-			for (size_t k = 0; k < poly->geometry.size(); k++)
+			const Vector3 *positions = poly->GetPositions();
+			for (size_t k = 0; k < poly->GetVertexCount(); k++)
 			{
-				for (size_t l = 0; l < poly->geometry[k].size(); l++)
-				{
-					Real new_y = poly->geometry[k][l].vertex.y;
-					if (new_y > y)
-						y = new_y;
-				}
+				if (positions[k].y > y)
+					y = positions[k].y;
 			}
 		}
 	}
@@ -748,12 +846,14 @@ Real MeshObject::HitBeam(const Vector3 &origin, const Vector3 &direction, Real m
 			if (!poly)
 				continue;
 
-			for (size_t k = 0; k < poly->triangles.size(); k++)
+			const Vector3 *positions = poly->GetPositions();
+			const Triangle *triangles = poly->GetTriangles();
+			for (size_t k = 0; k < poly->GetTriangleCount(); k++)
 			{
-				const Triangle &tri = poly->triangles[k];
-				Vector3 tri_a = poly->GetVertex(tri.a);
-				Vector3 tri_b = poly->GetVertex(tri.b);
-				Vector3 tri_c = poly->GetVertex(tri.c);
+				const Triangle &tri = triangles[k];
+				const Vector3 &tri_a = positions[tri.a];
+				const Vector3 &tri_b = positions[tri.b];
+				const Vector3 &tri_c = positions[tri.c];
 
 				std::pair<bool, Real> result = Ogre::Math::intersects(ray, tri_a, tri_b, tri_c);
 				if (result.first == true)
@@ -767,87 +867,140 @@ Real MeshObject::HitBeam(const Vector3 &origin, const Vector3 &direction, Real m
 	return -1;
 }
 
-void MeshObject::CreateCollider()
+bool MeshObject::CanCreateCollider()
 {
-	//set up triangle collider based on raw SBS mesh geometry
-
-	SBS_PROFILE("MeshObject::CreateCollider");
+	//returns true if a triangle collider should be created for this mesh
 
 	if (create_collider == false)
-		return;
+		return false;
 
 	//exit if collider already exists
 	if (mBody)
-		return;
+		return false;
 
 	if (!GetSceneNode())
-		return;
+		return false;
 
 	//exit if mesh is empty
 	if (Walls.size() == 0)
+		return false;
+
+	//evicted meshes get their collider back from Restore()
+	if (evicted == true)
+		return false;
+
+	return true;
+}
+
+void MeshObject::CreateCollider()
+{
+	//set up triangle collider based on raw SBS mesh geometry
+
+	SBS_PROFILE("MeshObject::CreateCollider");
+
+	if (CanCreateCollider() == false)
 		return;
 
+	CreateCollider(CreateColliderShape(GetSceneNode()->GetScale()));
+}
+
+OgreBulletCollisions::TriangleMeshCollisionShape* MeshObject::CreateColliderShape(Real scale, ColliderCache *cache)
+{
+	//build and finalize a triangle collider shape from raw SBS mesh geometry
+	//this only reads the mesh's walls, and can be run on a worker thread for different meshes at once
+	//if a cache is given, a cached BVH for the same triangles is used instead of building one
+
 	unsigned int tricount = GetTriangleCount("", true);
 	unsigned int vcount = GetVertexCount();
 
-	try
-	{
-		//initialize collider shape
-		OgreBulletCollisions::TriangleMeshCollisionShape* shape = new OgreBulletCollisions::TriangleMeshCollisionShape(vcount, tricount * 3);
+	//initialize collider shape
+	OgreBulletCollisions::TriangleMeshCollisionShape* shape = new OgreBulletCollisions::TriangleMeshCollisionShape(vcount, tricount * 3);
 
-		Real scale = GetSceneNode()->GetScale();
+	//add vertices to shape
 
-		//add vertices to shape
+	int additions = 0;
+	uint64_t hash = HashSeed;
+
+	for (size_t i = 0; i < Walls.size(); i++)
+	{
+		if (!Walls[i])
+			continue;
 
-		int additions = 0;
-		for (size_t i = 0; i < Walls.size(); i++)
+		for (size_t j = 0; j < Walls[i]->GetPolygonCount(); j++)
 		{
-			if (!Walls[i])
+			Polygon *poly = Walls[i]->GetPolygon(j);
+
+			if (!poly)
 				continue;
 
-			for (size_t j = 0; j < Walls[i]->GetPolygonCount(); j++)
-			{
-				Polygon *poly = Walls[i]->GetPolygon(j);
+			const Vector3 *positions = poly->GetPositions();
+			const Triangle *triangles = poly->GetTriangles();
 
-				if (!poly)
-					continue;
+			for (size_t k = 0; k < poly->GetTriangleCount(); k++)
+			{
+				const Triangle &tri = triangles[k];
 
-				PolyArray polyarray;
+				Vector3 vertices[3] = {positions[tri.a], positions[tri.b], positions[tri.c]};
 
-				for (size_t k = 0; k < poly->geometry.size(); k++)
+				if (scale != 1.0)
 				{
-					for (size_t l = 0; l < poly->geometry[k].size(); l++)
-						polyarray.emplace_back(poly->geometry[k][l].vertex);
+					vertices[0] *= scale;
+					vertices[1] *= scale;
+					vertices[2] *= scale;
 				}
 
-				for (size_t k = 0; k < poly->triangles.size(); k++)
-				{
-					const Triangle &tri = poly->triangles[k];
+				if (cache)
+					hash = Hash(vertices, sizeof(vertices), hash);
 
-					Vector3 a = polyarray[tri.a];
-					Vector3 b = polyarray[tri.b];
-					Vector3 c = polyarray[tri.c];
+				shape->AddTriangle(vertices[0], vertices[1], vertices[2]);
+				additions++;
+			}
+		}
+	}
 
-					if (scale != 1.0)
-					{
-						a *= scale;
-						b *= scale;
-						c *= scale;
-					}
+	//exit if no geometry
+	if (additions == 0)
+	{
+		delete shape;
+		return 0;
+	}
 
-					shape->AddTriangle(a, b, c);
-					additions++;
-				}
-			}
+	//finalize shape, using the cached BVH if available
+	if (cache)
+	{
+		std::vector<char> data;
+		if (cache->Get(hash, data) == true && shape->Finish(data.data(), (unsigned int)data.size()) == true)
+			return shape;
+	}
+
+	shape->Finish();
+
+	//store the new BVH in the cache
+	if (cache)
+	{
+		unsigned int size = shape->GetSerializedSize();
+		if (size > 0)
+		{
+			void *buffer = btAlignedAlloc(size, 16);
+			if (shape->Serialize(buffer, size) == true)
+				cache->Add(hash, buffer, size);
+			btAlignedFree(buffer);
 		}
+	}
 
-		//exit if no geometry
-		if (additions == 0)
-			return;
+	return shape;
+}
 
-		//finalize shape
-		shape->Finish();
+void MeshObject::CreateCollider(OgreBulletCollisions::TriangleMeshCollisionShape *shape)
+{
+	//create a static rigid body for a finished triangle collider shape
+	//this adds the collider to the physics world, and must be run on the main thread
 
+	if (!shape)
+		return;
+
+	try
+	{
 		//create a collider scene node
 		if (!collider_node)
 			collider_node = GetSceneNode()->CreateChild(GetName() + " collider");
@@ -924,36 +1077,32 @@ Vector2 MeshObject::GetExtents(int coord, bool flip_z)
 			if (!poly)
 				continue;
 
-			for (size_t k = 0; k < poly->geometry.size(); k++)
+			const Vector3 *positions = poly->GetPositions();
+			for (size_t k = 0; k < poly->GetVertexCount(); k++)
 			{
-				for (size_t l = 0; l < poly->geometry[k].size(); l++)
+				if (coord == 1)
+					tempnum = positions[k].x;
+				if (coord == 2)
+					tempnum = positions[k].y;
+				if (coord == 3)
 				{
-					Ogre::Vector3 vertex = poly->geometry[k][l].vertex;
-
-					if (coord == 1)
-						tempnum = poly->geometry[k][l].vertex.x;
-					if (coord == 2)
-						tempnum = poly->geometry[k][l].vertex.y;
-					if (coord == 3)
-					{
-						if (flip_z == false)
-							tempnum = poly->geometry[k][l].vertex.z;
-						else
-							tempnum = -poly->geometry[k][l].vertex.z;
-					}
+					if (flip_z == false)
+						tempnum = positions[k].z;
+					else
+						tempnum = -positions[k].z;
+				}
 
-					if (j == 0)
-					{
+				if (j == 0)
+				{
+					esmall = tempnum;
+					ebig = tempnum;
+				}
+				else
+				{
+					if (tempnum < esmall)
 						esmall = tempnum;
+					if (tempnum > ebig)
 						ebig = tempnum;
-					}
-					else
-					{
-						if (tempnum < esmall)
-							esmall = tempnum;
-						if (tempnum > ebig)
-							ebig = tempnum;
-					}
 				}
 			}
 		}
@@ -1154,8 +1303,8 @@ unsigned int MeshObject::GetTriangleCount(const std::string &material, bool tota
 
 				if (poly)
 				{
-					if (poly->material == material || (material == "" && total == true))
-						tris += poly->triangles.size();
+					if (poly->GetMaterial() == material || (material == "" && total == true))
+						tris += poly->GetTriangleCount();
 				}
 			}
 		}
@@ -1216,14 +1365,28 @@ size_t MeshObject::GetSize()
 {
 	//return size in bytes of this mesh object
 
-	if (size > 0)
-		return size;
+	MemoryUsage usage;
+	GetMemoryUsage(usage);
+
+	return sizeof(MeshObject) + usage.geometry + usage.pick + usage.bvh;
+}
+
+void MeshObject::GetMemoryUsage(MemoryUsage &usage)
+{
+	//add this mesh object's geometry memory usage to the given totals
+	//sizes are computed from allocated capacity, so they stay current as walls are cut or deleted
+
+	usage.geometry += Walls.capacity() * sizeof(Wall*);
+	usage.geometry += geometry_pool->GetSize();
 
 	for (size_t i = 0; i < Walls.size(); i++)
 	{
 		if (!Walls[i])
 			continue;
 
+		usage.walls++;
+		usage.geometry += sizeof(Wall);
+
 		for (size_t j = 0; j < Walls[i]->GetPolygonCount(); j++)
 		{
 			Polygon *poly = Walls[i]->GetPolygon(j);
@@ -1231,11 +1394,19 @@ size_t MeshObject::GetSize()
 			if (!poly)
 				continue;
 
-			size += poly->size;
+			usage.polygons++;
+			usage.vertices += poly->GetVertexCount();
+			usage.triangles += poly->GetTriangleCount();
+			usage.geometry += poly->GetSize() + sizeof(Polygon*);
 		}
 	}
 
-	return size;
+	usage.pick += pickPositions.capacity() * sizeof(Vector3);
+	usage.pick += pickIndices.capacity() * sizeof(uint32_t);
+	usage.pick += triOwners.capacity() * sizeof(TriOwner);
+
+	if (pick_bvh)
+		usage.bvh += pick_bvh->GetSize();
 }
 
 void MeshObject::CreateBoundingBox()
@@ -1261,14 +1432,12 @@ void MeshObject::CreateBoundingBox()
 
 			if (!poly)
 				continue;
-			for (size_t k = 0; k < poly->geometry.size(); k++)
+			const Vector3 *positions = poly->GetPositions();
+			for (size_t k = 0; k < poly->GetVertexCount(); k++)
 			{
-				for (size_t l = 0; l < poly->geometry[k].size(); l++)
-				{
-					Bounds->merge(poly->geometry[k][l].vertex);
-					local_box.merge(sbs->ToLocal(poly->geometry[k][l].vertex) + GetPosition());
-					merge = true;
-				}
+				Bounds->merge(positions[k]);
+				local_box.merge(sbs->ToLocal(positions[k]) + GetPosition());
+				merge = true;
 			}
 		}
 	}
@@ -1325,6 +1494,10 @@ void MeshObject::AddTriOwner(Wall *wall, Polygon *poly)
 	pickIndices.push_back(base + 2);
 
 	triOwners.push_back({wall, poly});
+
+	//queue the triangle in the pick hierarchy
+	if (pick_bvh)
+		pick_bvh->AddTriangle(triOwners.size() - 1);
 }
 
 void MeshObject::RemoveTriOwner(size_t triIndex)
@@ -1333,6 +1506,10 @@ void MeshObject::RemoveTriOwner(size_t triIndex)
 
 	size_t idxOffset = triIndex * 3;
 
+	//the following triangles shift down, so rebuild the pick hierarchy on next use
+	if (pick_bvh)
+		pick_bvh->Invalidate();
+
 	//erase the three indices
 	pickIndices.erase(pickIndices.begin() + idxOffset, pickIndices.begin() + idxOffset + 3);
 
@@ -1348,6 +1525,10 @@ void MeshObject::RemoveTriOwnerFast(size_t triIndex)
 	if (triIndex >= triCount)
 		return;
 
+	//update the pick hierarchy before the last triangle moves into this slot
+	if (pick_bvh)
+		pick_bvh->RemoveTriangle(triIndex);
+
 	size_t idxOffset = triIndex * 3;
 	size_t lastIdxOffset = (triCount - 1) * 3;
 
@@ -1367,4 +1548,62 @@ void MeshObject::RemoveTriOwnerFast(size_t triIndex)
 	triOwners.pop_back();
 }
 
+TriangleBVH* MeshObject::GetPickBVH()
+{
+	//get the pick triangle hierarchy, creating it if needed
+
+	if (!pick_bvh)
+		pick_bvh = new TriangleBVH(this);
+	return pick_bvh;
+}
+
+bool MeshObject::Evict()
+{
+	//free the render buffers, triangle collider and pick hierarchy of a disabled mesh
+	//polygon geometry and pick buffers are kept, and are used by Restore() to rebuild them
+
+	if (evicted == true || enabled == true)
+		return false;
+
+	SBS_PROFILE("MeshObject::Evict");
+
+	released = MeshWrapper->Release(this);
+
+	if (tricollider == true && IsPhysical() == false)
+		DeleteCollider();
+
+	if (pick_bvh)
+		delete pick_bvh;
+	pick_bvh = 0;
+
+	evicted = true;
+	return true;
+}
+
+void MeshObject::Restore()
+{
+	//rebuild the render buffers and triangle collider of an evicted mesh
+
+	if (evicted == false)
+		return;
+
+	SBS_PROFILE("MeshObject::Restore");
+
+	evicted = false;
+
+	if (released == true)
+		MeshWrapper->NeedsUpdate(this);
+	released = false;
+
+	if (CanCreateCollider() == true && tricollider == true && IsPhysical() == false)
+	{
+		//use the collider cache, which holds this mesh's BVH from when the building was loaded
+		CreateCollider(CreateColliderShape(GetSceneNode()->GetScale(), sbs->GetColliderCache()));
+
+		//new colliders are added to the world, so remove it again if the mesh is still disabled
+		if (enabled == false)
+			EnableCollider(false);
+	}
+}
+
 }
@@ -40,9 +40,35 @@ struct Extents
 	}
 };
 
+//box for batch cuts
+struct CutBox
+{
+	Vector3 start;
+	Vector3 end;
+
+	CutBox(const Vector3 &start, const Vector3 &end)
+	{
+		this->start = start;
+		this->end = end;
+	}
+};
+
 class SBSIMPEXP MeshObject : public Object
 {
 public:
+	struct MemoryUsage
+	{
+		size_t walls;     //wall count
+		size_t polygons;  //polygon count
+		size_t vertices;  //polygon vertex count
+		size_t triangles; //polygon triangle count
+		size_t geometry;  //bytes used by walls and polygons
+		size_t pick;      //bytes used by pick buffers
+		size_t bvh;       //bytes used by the pick hierarchy
+
+		MemoryUsage() : walls(0), polygons(0), vertices(0), triangles(0), geometry(0), pick(0), bvh(0) {}
+	};
+
 	std::string name; //mesh name
 	bool create_collider; //set to false if collider shouldn't be automatically generated
 	bool tricollider; //collider type; box if false, triangle if true
@@ -69,7 +95,10 @@ public:
 	bool IsPhysical();
 	Vector3 GetOffset();
 	void Cut(Vector3 start, Vector3 end, bool cutwalls, bool cutfloors, int checkwallnumber = 0, bool reset_check = true);
+	void Cut(const std::vector<CutBox> &boxes, bool cutwalls, bool cutfloors);
 	void CutOutsideBounds(Vector3 start, Vector3 end, bool cutwalls, bool cutfloors);
+	bool GetWallBounds(Vector3 &min, Vector3 &max);
+	void AddWallBounds(const Vector3 &min, const Vector3 &max);
 	bool UsingDynamicBuffers();
 	void GetBounds();
 	void ChangeHeight(Real newheight);
@@ -82,6 +111,9 @@ public:
 	Real GetHeight();
 	Real HitBeam(const Vector3 &origin, const Vector3 &direction, Real max_distance);
 	void CreateCollider();
+	void CreateCollider(OgreBulletCollisions::TriangleMeshCollisionShape *shape);
+	OgreBulletCollisions::TriangleMeshCollisionShape* CreateColliderShape(Real scale, ColliderCache *cache = 0);
+	bool CanCreateCollider();
 	void DeleteCollider();
 	Wall* FindPolygon(const std::string &name, int &index);
 	bool InBoundingBox(const Vector3 &pos, bool check_y);
@@ -93,11 +125,17 @@ public:
 	void SetMaterial(const std::string& material);
 	void EnablePhysics(bool value, Real restitution = 0, Real friction = 0, Real mass = 0);
 	size_t GetSize();
+	void GetMemoryUsage(MemoryUsage &usage);
 	void RemoveTriOwner(Wall *wall);
 	void RemoveTriOwner(Polygon *poly);
 	void RemoveTriOwner(size_t triIndex);
 	void RemoveTriOwnerFast(size_t triIndex);
 	void AddTriOwner(Wall *wall, Polygon *poly);
+	TriangleBVH* GetPickBVH();
+	bool Evict();
+	void Restore();
+	bool IsEvicted() { return evicted; }
+	GeometryPool* GetGeometryPool() { return geometry_pool; }
 
 	DynamicMesh *MeshWrapper; //dynamic mesh this mesh object uses
 	std::vector<Wall*> Walls; //associated wall (polygon container) objects
@@ -122,19 +160,38 @@ public:
 	std::vector<uint32_t>  pickIndices;   //3 indices per triangle
 	std::vector<TriOwner>  triOwners;     //size == pickIndices.size() / 3
 
+	struct PickResult
+	{
+		TriOwner owner;  //owning wall and polygon, or null if no hit
+		Vector3 isect;   //intersection point
+		Vector3 normal;  //triangle normal, facing the ray
+		Real distance;   //distance from the ray origin
+		bool hit;        //true if a triangle was hit
+	};
+
 private:
 	bool enabled;
 	bool is_physical;
 	Real restitution, friction, mass;
 	bool prepared;
 	bool wrapper_selfcreate;
+	bool evicted; //true if render buffers, collider and pick hierarchy have been freed
+	bool released; //true if the dynamic mesh freed this mesh's render buffers
+
+	//bounding box of all wall polygons in local positioning, grown as polygons are added
+	Vector3 wall_bounds_min;
+	Vector3 wall_bounds_max;
+	bool has_wall_bounds;
 
 	bool LoadFromFile(const std::string &filename);
 	bool LoadColliderModel(Ogre::MeshPtr &collidermesh);
 	void CreateBoundingBox();
 
 	Ogre::MeshPtr collidermesh;
-	size_t size;
+
+	TriangleBVH *pick_bvh; //pick triangle hierarchy, created on first use
+
+	GeometryPool *geometry_pool; //pooled geometry of this mesh's polygons
 };
 
 }
@@ -30,6 +30,7 @@
 #include "polymesh.h"
 #include "texman.h"
 #include "utility.h"
+#include "geometrypool.h"
 #include "polygon.h"
 
 namespace SBS {
@@ -40,40 +41,41 @@ Polygon::Polygon(Object *parent, const std::string &name, MeshObject *meshwrappe
 	t_matrix = Matrix3::ZERO;
 	t_vector = Vector3::ZERO;
 	SetName(name);
-	size = 0;
+	material_id = 0;
+	bounds_min = Vector3::ZERO;
+	bounds_max = Vector3::ZERO;
 
 	sbs->GetPolyMesh()->PolygonCount++;
 }
 
 Polygon::~Polygon()
 {
-	if (material != "" && sbs->FastDelete == false)
-		sbs->GetTextureManager()->DecrementTextureUsage(material);
+	if (GetMaterial() != "" && sbs->FastDelete == false)
+		sbs->GetTextureManager()->DecrementTextureUsage(GetMaterial());
+
+	//release geometry from the pool
+	mesh->GetGeometryPool()->Free(range);
 
 	mesh->ResetPrepare();
 
 	sbs->GetPolyMesh()->PolygonCount--;
 }
 
-void Polygon::Create(GeometrySet &geometry, std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane)
+void Polygon::Create(const GeometrySet &geometry, const std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane)
 {
 	//create a polygon
+	//geometry and triangles are copied into the mesh's geometry pool, replacing any previous geometry
 
 	t_matrix = tex_matrix;
 	t_vector = tex_vector;
-	this->material = material;
+	SetMaterial(material);
 	this->plane = plane;
-	this->geometry = geometry;
-	this->triangles = triangles;
-	size = triangles.size() * (sizeof(unsigned int) * 3);
 
-	vertex_count = 0;
-	for (size_t i = 0; i < geometry.size(); i++)
-	{
-		vertex_count += geometry[i].size();
-		size += geometry[i].size() * sizeof(Geometry);
-	}
+	GeometryPool *pool = mesh->GetGeometryPool();
+	pool->Free(range);
+	pool->Allocate(range, geometry, triangles);
 
+	UpdateBounds();
 	mesh->ResetPrepare();
 
 	//register texture usage
@@ -81,19 +83,18 @@ void Polygon::Create(GeometrySet &geometry, std::vector<Triangle> &triangles, Ma
 		sbs->GetTextureManager()->IncrementTextureUsage(material);
 }
 
-void Polygon::Create(std::vector<Geometry> &geometry, std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane)
+void Polygon::Create(const std::vector<Geometry> &geometry, const std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane)
 {
 	t_matrix = tex_matrix;
 	t_vector = tex_vector;
-	this->material = material;
+	SetMaterial(material);
 	this->plane = plane;
-	this->geometry.emplace_back(geometry);
-	this->triangles = triangles;
-	size = triangles.size() * (sizeof(unsigned int) * 3);
 
-	vertex_count = geometry.size();
-	size = sizeof(Geometry) * vertex_count;
+	GeometryPool *pool = mesh->GetGeometryPool();
+	pool->Free(range);
+	pool->Allocate(range, geometry, triangles);
 
+	UpdateBounds();
 	mesh->ResetPrepare();
 
 	//register texture usage
@@ -101,6 +102,26 @@ void Polygon::Create(std::vector<Geometry> &geometry, std::vector<Triangle> &tri
 		sbs->GetTextureManager()->IncrementTextureUsage(material);
 }
 
+size_t Polygon::GetSize()
+{
+	//return size in bytes of polygon
+	//the polygon's geometry is counted by the mesh's geometry pool
+
+	return sizeof(Polygon);
+}
+
+void Polygon::GetGeometry(GeometrySet &geometry)
+{
+	//get a copy of the polygon's geometry, split into rings
+
+	mesh->GetGeometryPool()->GetGeometry(range, geometry);
+}
+
+void Polygon::SetMaterial(const std::string &material)
+{
+	material_id = mesh->GetGeometryPool()->GetMaterialID(material);
+}
+
 void Polygon::GetTextureMapping(Matrix3 &tm, Vector3 &tv)
 {
 	//return texture mapping matrix and vector
@@ -112,18 +133,16 @@ void Polygon::Move(const Vector3 &vector, Real speed)
 {
 	bool dynamic = mesh->UsingDynamicBuffers();
 
-	for (size_t i = 0; i < geometry.size(); i++)
-	{
-		for (size_t j = 0; j < geometry[i].size(); j++)
-		{
-			Geometry &data = geometry[i][j];
-			data.vertex += sbs->ToRemote(vector * speed);
-		}
-	}
+	Vector3 offset = sbs->ToRemote(vector * speed);
+	Vector3 *positions = GetPositions();
+	for (size_t i = 0; i < range.vertex_count; i++)
+		positions[i] += offset;
+
+	UpdateBounds();
 
 	//update vertices in render buffer, if using dynamic buffers
 	if (dynamic == true)
-		mesh->MeshWrapper->UpdateVertices(mesh, material, this, true);
+		mesh->MeshWrapper->UpdateVertices(mesh, GetMaterial(), this, true);
 }
 
 Plane Polygon::GetAbsolutePlane()
@@ -143,14 +162,8 @@ Vector2 Polygon::GetExtents(int coord)
 		return Vector2(0, 0);
 
 	//get polygon extents
-	PolyArray poly;
-	for (size_t i = 0; i < geometry.size(); i++)
-	{
-		for (size_t j = 0; j < geometry[i].size(); j++)
-		{
-			poly.emplace_back(geometry[i][j].vertex);
-		}
-	}
+	Vector3 *positions = GetPositions();
+	PolyArray poly (positions, positions + range.vertex_count);
 
 	Vector2 extents = sbs->GetPolyMesh()->GetExtents(poly, coord);
 
@@ -163,19 +176,18 @@ void Polygon::ChangeHeight(Real newheight)
 
 	Vector2 extents = GetExtents(2);
 
-	for (size_t i = 0; i < geometry.size(); i++)
+	Vector3 *positions = GetPositions();
+	for (size_t i = 0; i < range.vertex_count; i++)
 	{
-		for (size_t j = 0; j < geometry[i].size(); j++)
-		{
-			Geometry &data = geometry[i][j];
-			if (data.vertex.y == extents.y)
-				data.vertex.y = sbs->ToRemote(newheight);
-		}
+		if (positions[i].y == extents.y)
+			positions[i].y = sbs->ToRemote(newheight);
 	}
 
+	UpdateBounds();
+
 	//update vertices in render buffer, if using dynamic buffers
 	if (dynamic == true)
-		mesh->MeshWrapper->UpdateVertices(mesh, material, this, true);
+		mesh->MeshWrapper->UpdateVertices(mesh, GetMaterial(), this, true);
 }
 
 bool Polygon::ReplaceTexture(const std::string &oldtexture, const std::string &newtexture)
@@ -185,17 +197,17 @@ bool Polygon::ReplaceTexture(const std::string &oldtexture, const std::string &n
 	if (oldtexture == newtexture)
 		return false;
 
-	if (material == oldtexture)
+	if (GetMaterial() == oldtexture)
 	{
-		std::string old = material;
+		int old = material_id;
 		sbs->GetTextureManager()->DecrementTextureUsage(oldtexture);
-		material = newtexture;
+		SetMaterial(newtexture);
 		sbs->GetTextureManager()->IncrementTextureUsage(newtexture);
 
 		bool result = mesh->GetDynamicMesh()->ChangeTexture(oldtexture, newtexture, mesh);
 		if (result == false)
 		{
-			material = old; //revert name
+			material_id = old; //revert name
 			return false;
 		}
 
@@ -212,19 +224,20 @@ bool Polygon::ChangeTexture(const std::string &texture, bool matcheck)
 
 	if (matcheck == true)
 	{
-		if (material == texture)
+		if (GetMaterial() == texture)
 			return false;
 	}
 
-	std::string old = material;
-	sbs->GetTextureManager()->DecrementTextureUsage(material);
-	material = texture;
+	int old_id = material_id;
+	std::string old = GetMaterial();
+	sbs->GetTextureManager()->DecrementTextureUsage(old);
+	SetMaterial(texture);
 	sbs->GetTextureManager()->IncrementTextureUsage(texture);
 
 	bool result = mesh->GetDynamicMesh()->ChangeTexture(old, texture, mesh);
 	if (result == false)
 	{
-		material = old; //revert name
+		material_id = old_id; //revert name
 		return false;
 	}
 
@@ -234,17 +247,10 @@ bool Polygon::ChangeTexture(const std::string &texture, bool matcheck)
 
 Vector3 Polygon::GetVertex(int index)
 {
-	int offset = 0;
-	for (size_t i = 0; i < geometry.size(); i++)
-	{
-		for (size_t j = 0; j < geometry[i].size(); j++)
-		{
-			if (index == offset + j)
-				return geometry[i][j].vertex;
-		}
-		offset += geometry[i].size();
-	}
-	return Vector3::ZERO;
+	if (index < 0 || index >= (int)range.vertex_count)
+		return Vector3::ZERO;
+
+	return GetPositions()[index];
 }
 
 bool Polygon::IntersectRay(const Vector3& rayOrigin, const Vector3& rayDir, Vector3& hitPoint)
@@ -267,14 +273,17 @@ bool Polygon::IntersectRay(const Vector3& rayOrigin, const Vector3& rayDir, Vect
 	hitPoint = rayOrigin + rayDir * t;
 
 	//point-in-polygon test (convex polygons)
-	for (size_t i = 0; i < geometry.size(); i++)
+	const Vector3 *positions = GetPositions();
+	size_t offset = 0;
+	for (size_t i = 0; i < range.ring_count; i++)
 	{
-		const auto& verts = geometry[i];
-		size_t n = verts.size();
+		const Vector3 *verts = positions + offset;
+		size_t n = GetRingSize(i);
+		offset += n;
 		for (size_t i = 0; i < n; ++i)
 		{
-			Vector3 v0 = verts[i].vertex;
-			Vector3 v1 = verts[(i + 1) % n].vertex;
+			Vector3 v0 = verts[i];
+			Vector3 v1 = verts[(i + 1) % n];
 			Vector3 edge = v1 - v0;
 			Vector3 toPoint = hitPoint - v0;
 			Vector3 cross = edge.crossProduct(toPoint);
@@ -348,4 +357,26 @@ bool Polygon::IntersectSegment(const Vector3 &start, const Vector3 &end, Vector3
 	return plane_hit;
 }
 
+void Polygon::UpdateBounds()
+{
+	//update the bounding box of the polygon's vertices, in local (SBS) positioning,
+	//matching the vertex conversion used by PolyMesh::Cut
+
+	const Vector3 *positions = GetPositions();
+	for (size_t i = 0; i < range.vertex_count; i++)
+	{
+		Vector3 vertex = sbs->ToLocal(positions[i]);
+		if (i == 0)
+		{
+			bounds_min = vertex;
+			bounds_max = vertex;
+		}
+		else
+		{
+			bounds_min.makeFloor(vertex);
+			bounds_max.makeCeil(vertex);
+		}
+	}
+}
+
 }
@@ -28,42 +28,32 @@
 #include <OgreMatrix3.h>
 #include "mesh.h"
 #include "triangle.h"
+#include "geometrypool.h"
 
 namespace SBS {
 
-struct Geometry
-{
-	//basic 3D geometry
-	Vector3 vertex;
-	Vector2 texel;
-	Vector3 normal;
-};
-
-typedef std::vector<std::vector<Geometry> > GeometrySet;
-typedef std::vector<Geometry> GeometryArray;
-
 class SBSIMPEXP Polygon : public ObjectBase
 {
 public:
 
 	MeshObject* mesh;
-	GeometrySet geometry; //mesh geometry (vertices/texels/normals) container
-	int vertex_count;
-	std::vector<Triangle> triangles;
+	GeometryPool::Range range; //polygon's vertices, rings and triangles in the mesh's geometry pool
+	int material_id; //polygon material, from the geometry pool's material table
 	Plane plane; //plane in remote (Ogre) form, relative positioning
 
 	//texture mapping matrix and vector
 	Matrix3 t_matrix;
 	Vector3 t_vector;
 
-	std::string material; //polygon material
-
-	size_t size; //size in bytes of polygon
+	//bounding box of the vertices in local (SBS) positioning, used to skip polygons when cutting
+	Vector3 bounds_min;
+	Vector3 bounds_max;
 
 	Polygon(Object *parent, const std::string &name, MeshObject *meshwrapper);
 	~Polygon();
-	void Create(GeometrySet &geometry, std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane);
-	void Create(std::vector<Geometry> &geometry, std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane);
+	void Create(const GeometrySet &geometry, const std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane);
+	void Create(const std::vector<Geometry> &geometry, const std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, const std::string &material, Plane &plane);
+	size_t GetSize();
 	void GetTextureMapping(Matrix3 &t_matrix, Vector3 &t_vector);
 	bool IntersectSegment(const Vector3 &start, const Vector3 &end, Vector3 &isect, Real *pr, Vector3 &normal);
 	bool IntersectSegmentPlane(const Vector3 &start, const Vector3 &end, Vector3 &isect, Real *pr, Vector3 &normal);
@@ -75,6 +65,23 @@ public:
 	bool ChangeTexture(const std::string &texture, bool matcheck = true);
 	Vector3 GetVertex(int index);
 	bool IntersectRay(const Vector3& rayOrigin, const Vector3& rayDir, Vector3& hitPoint);
+	void UpdateBounds();
+	void GetGeometry(GeometrySet &geometry);
+	const std::string& GetMaterial() { return mesh->GetGeometryPool()->GetMaterial(material_id); }
+
+	//pooled geometry accessors
+	//pointers are invalidated when polygons are created or the pool is compacted
+	size_t GetVertexCount() { return range.vertex_count; }
+	size_t GetTriangleCount() { return range.triangle_count; }
+	size_t GetRingCount() { return range.ring_count; }
+	size_t GetRingSize(size_t ring) { return mesh->GetGeometryPool()->rings[range.ring_start + ring]; }
+	Vector3* GetPositions() { return mesh->GetGeometryPool()->positions.data() + range.vertex_start; }
+	Vector3* GetNormals() { return mesh->GetGeometryPool()->normals.data() + range.vertex_start; }
+	Vector2* GetTexels() { return mesh->GetGeometryPool()->texels.data() + range.vertex_start; }
+	Triangle* GetTriangles() { return mesh->GetGeometryPool()->triangles.data() + range.triangle_start; }
+
+private:
+	void SetMaterial(const std::string &material);
 };
 
 }
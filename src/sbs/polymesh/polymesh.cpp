@@ -30,6 +30,7 @@
 #include "profiler.h"
 #include "utility.h"
 #include "polymesh.h"
+#include "bvh.h"
 
 namespace SBS {
 
@@ -244,12 +245,16 @@ bool PolyMesh::CreateMesh(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly,
 		delete [] table;
 	table = 0;
 
+	//reserve triangle space for all rings at once, so the polygon's array has no slack
+	size_t triangle_count = triangles.size();
+	for (size_t i = 0; i < trimesh_size; i++)
+		triangle_count += trimesh[i].triangles.size();
+	triangles.reserve(triangle_count);
+
 	//add triangles to single array, to be passed to the submesh
 	size_t location = 0;
 	for (size_t i = 0; i < trimesh_size; i++)
 	{
-		if (triangles.capacity() < trimesh[i].triangles.size())
-			triangles.reserve(trimesh[i].triangles.size());
 		for (size_t j = 0; j < trimesh[i].triangles.size(); j++)
 		{
 			Triangle tri = trimesh[i].triangles[j];
@@ -350,12 +355,16 @@ bool PolyMesh::CreateMesh(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly,
 		}
 	}
 
+	//reserve triangle space for all rings at once, so the polygon's array has no slack
+	size_t triangle_count = triangles.size();
+	for (size_t i = 0; i < trimesh_size; i++)
+		triangle_count += trimesh[i].triangles.size();
+	triangles.reserve(triangle_count);
+
 	//add triangles to single array, to be passed to the submesh
 	size_t location = 0;
 	for (size_t i = 0; i < trimesh_size; i++)
 	{
-		if (triangles.capacity() < trimesh[i].triangles.size())
-			triangles.reserve(trimesh[i].triangles.size());
 		for (size_t j = 0; j < trimesh[i].triangles.size(); j++)
 		{
 			Triangle tri = trimesh[i].triangles[j];
@@ -384,6 +393,31 @@ bool PolyMesh::CreateMesh(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly,
 	return true;
 }
 
+void PolyMesh::AddPickGeometry(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly, const GeometrySet &geometry, const std::vector<Triangle> &triangles)
+{
+	//append finished polygon geometry to the mesh's pick buffers, for geometry that wasn't made by CreateMesh
+
+	uint32_t base = static_cast<uint32_t>(mesh->pickPositions.size());
+	for (size_t i = 0; i < geometry.size(); i++)
+	{
+		for (size_t j = 0; j < geometry[i].size(); j++)
+			mesh->pickPositions.emplace_back(geometry[i][j].vertex); //remote space
+	}
+
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		const Triangle &tri = triangles[i];
+		mesh->pickIndices.push_back(base + tri.a);
+		mesh->pickIndices.push_back(base + tri.b);
+		mesh->pickIndices.push_back(base + tri.c);
+		mesh->triOwners.push_back({ownerWall, ownerPoly});
+	}
+
+	//recreate colliders if specified
+	if (sbs->DeleteColliders == true)
+		mesh->DeleteCollider();
+}
+
 Vector2* PolyMesh::GetTexels(Matrix3 &tex_matrix, Vector3 &tex_vector, PolygonSet &vertices, Real tw, Real th, size_t &texel_count)
 {
 	//return texel array for specified texture transformation matrix and vector
@@ -1619,14 +1653,20 @@ void PolyMesh::CutOrig(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bo
 		PolygonSet newpolys;
 
 		//skip empty polygons
-		if (polygon->geometry.size() == 0)
+		if (polygon->GetRingCount() == 0)
 			continue;
 
-		//cut all polygons within range
-		for (size_t j = 0; j < polygon->geometry.size(); j++)
+		//cut all polygons within range, reading each ring from the mesh's geometry pool
+		const Vector3 *positions = polygon->GetPositions();
+		size_t ring_start = 0;
+		for (size_t j = 0; j < polygon->GetRingCount(); j++)
 		{
+			const Vector3 *ring = positions + ring_start;
+			size_t ring_size = polygon->GetRingSize(j);
+			ring_start += ring_size;
+
 			//skip null geometry
-			if (polygon->geometry[j].size() == 0)
+			if (ring_size == 0)
 				continue;
 
 			PolyArray temppoly, temppoly2, temppoly3, temppoly4, temppoly5, worker;
@@ -1637,9 +1677,9 @@ void PolyMesh::CutOrig(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bo
 			bool polycheck2 = false;
 
 			//copy source polygon vertices
-			for (size_t k = 0; k < polygon->geometry[j].size(); k++)
+			for (size_t k = 0; k < ring_size; k++)
 			{
-				Ogre::Vector3 vertex = sbs->ToLocal(polygon->geometry[j][k].vertex);
+				Ogre::Vector3 vertex = sbs->ToLocal(ring[k]);
 				temppoly.emplace_back(vertex);
 				polybounds.merge(vertex);
 			}
@@ -1839,9 +1879,9 @@ void PolyMesh::CutOrig(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bo
 			{
 				//otherwise put original polygon into array (will only be used if the related submesh is recreated)
 				PolyArray poly;
-				for (size_t k = 0; k < polygon->geometry[j].size(); k++)
+				for (size_t k = 0; k < ring_size; k++)
 				{
-					poly.emplace_back(sbs->ToLocal(polygon->geometry[j][k].vertex));
+					poly.emplace_back(sbs->ToLocal(ring[k]));
 				}
 				newpolys.emplace_back(poly);
 			}
@@ -1858,7 +1898,7 @@ void PolyMesh::CutOrig(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bo
 			if (newpolys.size() > 0)
 			{
 				//get texture data from original polygon
-				oldmat = polygon->material;
+				oldmat = polygon->GetMaterial();
 				polygon->GetTextureMapping(mapping, oldvector);
 			}
 
@@ -1910,6 +1950,11 @@ void PolyMesh::Cut(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bool c
 
 	const Real EPS = SMALL_EPSILON;
 
+	//skip the wall if the cut box misses all of its polygons
+	Vector3 wall_min, wall_max;
+	if (wall->GetBounds(wall_min, wall_max) == false || BoxOverlaps(wall_min, wall_max, start, end) == false)
+		return;
+
 	auto computeNormal = [&](const GeometryArray& p)->Vector3
 	{
 		for (size_t i = 0; i + 2 < p.size(); ++i)
@@ -2088,27 +2133,39 @@ void PolyMesh::Cut(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bool c
 			continue;
 
 		//skip empty poly
-		if (polygon->geometry.empty())
+		if (polygon->GetRingCount() == 0)
+			continue;
+
+		//skip the polygon if the cut box misses it, since none of its rings would change
+		if (BoxOverlaps(polygon->bounds_min, polygon->bounds_max, start, end) == false)
 			continue;
 
 		GeometrySet rebuilt;
 		bool touchedAny = false;
 
-		for (size_t j = 0; j < polygon->geometry.size(); ++j)
+		//read rings from the mesh's geometry pool
+		const Vector3 *positions = polygon->GetPositions();
+		const Vector3 *normals = polygon->GetNormals();
+		const Vector2 *texels = polygon->GetTexels();
+		size_t ring_start = 0;
+
+		for (size_t j = 0; j < polygon->GetRingCount(); ++j)
 		{
-			const auto& src = polygon->geometry[j];
-			if (src.empty())
+			const size_t first = ring_start;
+			const size_t count = polygon->GetRingSize(j);
+			ring_start += count;
+			if (count == 0)
 				continue;
 
 			//build local-space geometry ring
 			GeometryArray ring;
-			ring.reserve(src.size());
-			for (const auto& g : src)
+			ring.reserve(count);
+			for (size_t k = first; k < first + count; ++k)
 			{
 				Geometry v;
-				v.vertex = sbs->ToLocal(g.vertex);
-				v.texel  = g.texel;
-				v.normal = g.normal;
+				v.vertex = sbs->ToLocal(positions[k]);
+				v.texel  = texels[k];
+				v.normal = normals[k];
 				ring.emplace_back(v);
 			}
 
@@ -2260,7 +2317,7 @@ void PolyMesh::Cut(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bool c
 		{
 			//get material and mapping from the original polygon
 			const std::string name = polygon->GetName();
-			const std::string oldmat = polygon->material;
+			const std::string oldmat = polygon->GetMaterial();
 
 			//delete original polygon
 			wall->DeletePolygon(i, false);
@@ -2274,6 +2331,34 @@ void PolyMesh::Cut(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bool c
 	}
 }
 
+void PolyMesh::Cut(Wall *wall, const std::vector<CutBox> &boxes, bool cutwalls, bool cutfloors, int checkwallnumber, bool reset_check)
+{
+	//cut a set of boxes from a wall
+	//each box only reaches the polygons it intersects, using the wall and polygon bounds
+
+	for (size_t i = 0; i < boxes.size(); i++)
+		Cut(wall, boxes[i].start, boxes[i].end, cutwalls, cutfloors, checkwallnumber, reset_check == true && i == 0);
+}
+
+bool PolyMesh::BoxOverlaps(const Vector3 &min, const Vector3 &max, Vector3 start, Vector3 end)
+{
+	//returns true if a bounding box intersects a cut box, allowing boundary contact within SMALL_EPSILON
+	//the cut box corners can be in any order
+
+	if (start.x > end.x)
+		std::swap(start.x, end.x);
+	if (start.y > end.y)
+		std::swap(start.y, end.y);
+	if (start.z > end.z)
+		std::swap(start.z, end.z);
+
+	const Real EPS = SMALL_EPSILON;
+
+	return !(max.x < start.x - EPS || min.x > end.x + EPS ||
+			 max.y < start.y - EPS || min.y > end.y + EPS ||
+			 max.z < start.z - EPS || min.z > end.z + EPS);
+}
+
 void PolyMesh::GetDoorwayExtents(MeshObject *mesh, int checknumber, PolyArray &polygon)
 {
 	//calculate doorway extents, for use with AddDoorwayWalls function
@@ -2721,44 +2806,70 @@ bool PolyMesh::IntersectRayTri(const Vector3& ro, const Vector3& rd, const Vecto
 
 MeshObject::TriOwner PolyMesh::FindWallIntersect_Tri(MeshObject* mesh, const Vector3& start, const Vector3& end, Vector3& isect, Real& distance, Vector3& normal)
 {
-    const Vector3 ro = start;
-    const Vector3 rd = (end - start).normalisedCopy();
-    Real bestT = std::numeric_limits<double>::infinity();
-    int bestTri = -1;
+	//find the nearest pick triangle hit by a ray, and return its owning wall and polygon
 
-    const auto& pos = mesh->pickPositions;
-    const auto& idx = mesh->pickIndices;
+	SBS_PROFILE("PolyMesh::FindWallIntersect_Tri");
 
-    for (size_t i = 0; i < idx.size(); i += 3)
+	MeshObject::PickResult result;
+	PickTriangle(mesh, start, (end - start).normalisedCopy(), result);
+
+	if (result.hit == true)
 	{
-        const Vector3& a = pos[idx[i + 0]];
-        const Vector3& b = pos[idx[i + 1]];
-        const Vector3& c = pos[idx[i + 2]];
-        Real t, u, v;
-        if (IntersectRayTri(ro, rd, a,b,c, t,u,v))
-		{
-            if (t < bestT)
-			{
-                bestT = t;
-                bestTri = static_cast<int>(i / 3);
-                // compute normal in the same space
-                normal = (b - a).crossProduct(c - a).normalisedCopy();
-                // Two-sided: make normal face the ray (optional)
-                if (normal.dotProduct(rd) > 0)
-					normal = -normal;
-            }
-        }
-    }
+		isect = result.isect;
+		distance = result.distance;
+		normal = result.normal;
+	}
+
+	return result.owner;
+}
+
+void PolyMesh::FindWallIntersect_Tri(MeshObject* mesh, const std::vector<Ray> &rays, std::vector<MeshObject::PickResult> &results)
+{
+	//batch version of FindWallIntersect_Tri, for running many ray queries against a single mesh
+	//ray directions don't need to be normalized
+
+	SBS_PROFILE("PolyMesh::FindWallIntersect_Tri");
 
-	MeshObject::TriOwner owner;
-	owner.poly = 0;
-	owner.wall = 0;
-    if (bestTri < 0)
-		return owner;
+	results.resize(rays.size());
+
+	for (size_t i = 0; i < rays.size(); i++)
+		PickTriangle(mesh, rays[i].getOrigin(), rays[i].getDirection().normalisedCopy(), results[i]);
+}
 
-    isect = ro + rd * static_cast<Real>(bestT);
-    distance = (isect - ro).length();
-    return mesh->triOwners[bestTri]; // deterministic ownership
+bool PolyMesh::PickTriangle(MeshObject* mesh, const Vector3 &origin, const Vector3 &direction, MeshObject::PickResult &result)
+{
+	//run a ray query against a mesh's pick triangle hierarchy
+
+	result.owner.wall = 0;
+	result.owner.poly = 0;
+	result.isect = Vector3::ZERO;
+	result.normal = Vector3::ZERO;
+	result.distance = 0;
+	result.hit = false;
+
+	Real t;
+	int tri;
+	if (mesh->GetPickBVH()->RayCast(origin, direction, t, tri) == false)
+		return false;
+
+	const auto& pos = mesh->pickPositions;
+	const auto& idx = mesh->pickIndices;
+	const Vector3& a = pos[idx[(tri * 3) + 0]];
+	const Vector3& b = pos[idx[(tri * 3) + 1]];
+	const Vector3& c = pos[idx[(tri * 3) + 2]];
+
+	//compute normal in the same space
+	result.normal = (b - a).crossProduct(c - a).normalisedCopy();
+
+	//two-sided: make normal face the ray
+	if (result.normal.dotProduct(direction) > 0)
+		result.normal = -result.normal;
+
+	result.isect = origin + direction * t;
+	result.distance = (result.isect - origin).length();
+	result.owner = mesh->triOwners[tri]; //deterministic ownership
+	result.hit = true;
+	return true;
 }
 
 }
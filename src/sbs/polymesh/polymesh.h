@@ -53,6 +53,7 @@ public:
 	bool CreateMesh(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly, const std::string &name, const std::string &material, PolygonSet &vertices, Matrix3 &tex_matrix, Vector3 &tex_vector, GeometrySet &geometry, std::vector<Triangle> &triangles, PolygonSet &converted_vertices, Real tw, Real th, bool convert_vertices = true);
 	bool CreateMesh(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly, const std::string &name, const std::string &material, PolygonSet &vertices, std::vector<std::vector<Vector2>> &uvMap, GeometrySet &geometry, std::vector<Triangle> &triangles, PolygonSet &converted_vertices, Real tw, Real th, bool convert_vertices = true);
 	Wall* FindWallIntersect(MeshObject *mesh, const Vector3 &start, const Vector3 &end, Vector3 &isect, Real &distance, Vector3 &normal, Wall *wall = 0);
+	void AddPickGeometry(MeshObject *mesh, Wall* ownerWall, Polygon* ownerPoly, const GeometrySet &geometry, const std::vector<Triangle> &triangles);
 	Vector2* GetTexels(Matrix3 &tex_matrix, Vector3 &tex_vector, PolygonSet &vertices, Real tw, Real th, size_t &texel_count);
 	Vector2 GetExtents(int coord, bool flip_z = false);
 	bool AddWallMain(Wall* wallobject, const std::string &name, const std::string &texture, Real thickness, Real x1, Real z1, Real x2, Real z2, Real height_in1, Real height_in2, Real altitude1, Real altitude2, Real tw, Real th, bool autosize, bool report = true);
@@ -78,6 +79,8 @@ public:
 	void ExtrudePolygon(PolyArray &polygon, Real thickness, PolygonSet &output_faces);
 	Vector2 GetExtents(PolyArray &varray, int coord, bool flip_z = false);
 	void Cut(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bool cutfloors, int checkwallnumber = 0, bool reset_check = true);
+	void Cut(Wall *wall, const std::vector<CutBox> &boxes, bool cutwalls, bool cutfloors, int checkwallnumber = 0, bool reset_check = true);
+	static bool BoxOverlaps(const Vector3 &min, const Vector3 &max, Vector3 start, Vector3 end);
 	void CutOrig(Wall *wall, Vector3 start, Vector3 end, bool cutwalls, bool cutfloors, int checkwallnumber = 0, bool reset_check = true);
 	void GetDoorwayExtents(MeshObject *mesh, int checknumber, PolyArray &polygon);
 	Vector3 GetPolygonDirection(PolyArray &polygon);
@@ -91,6 +94,8 @@ public:
 	Wall* AddDoorwayWalls(MeshObject* mesh, const std::string &wallname, const std::string &texture, Real tw, Real th);
 	bool IntersectRayTri(const Vector3& ro, const Vector3& rd, const Vector3& a, const Vector3& b, const Vector3& c, double& t, double& u, double& v);
 	MeshObject::TriOwner FindWallIntersect_Tri(MeshObject* mesh, const Vector3& start, const Vector3& end, Vector3& isect, Real& distance, Vector3& normal);
+	void FindWallIntersect_Tri(MeshObject* mesh, const std::vector<Ray> &rays, std::vector<MeshObject::PickResult> &results);
+	bool PickTriangle(MeshObject* mesh, const Vector3 &origin, const Vector3 &direction, MeshObject::PickResult &result);
 
 private:
 
@@ -0,0 +1,530 @@
+/*
+	Scalable Building Simulator - Geometry Snapshot
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <unordered_set>
+#include "globals.h"
+#include "sbs.h"
+#include "wall.h"
+#include "mesh.h"
+#include "texman.h"
+#include "utility.h"
+#include "snapshot.h"
+
+namespace SBS {
+
+static const char SnapshotMagic[4] = {'S', 'B', 'G', 'S'};
+static const uint32_t SnapshotVersion = 3;
+
+static size_t Align(size_t offset)
+{
+	return (offset + 7) & ~(size_t)7;
+}
+
+GeometrySnapshot::GeometrySnapshot(Object *parent) : ObjectBase(parent)
+{
+	is_open = false;
+	Clear();
+}
+
+GeometrySnapshot::~GeometrySnapshot()
+{
+
+}
+
+void GeometrySnapshot::Clear()
+{
+	//free loaded and recorded data
+
+	replay = false;
+	restored = 0;
+	misses = 0;
+
+	std::vector<char>().swap(buffer);
+	memset(&loaded, 0, sizeof(loaded));
+	index.clear();
+	used.clear();
+
+	added_sources.clear();
+	std::vector<Record>().swap(added_records);
+	std::vector<uint32_t>().swap(added_rings);
+	std::vector<Geometry>().swap(added_vertices);
+	std::vector<Triangle>().swap(added_triangles);
+	std::string().swap(added_strings);
+}
+
+void GeometrySnapshot::Open(const std::string &filename, const std::string &source, uint64_t source_hash)
+{
+	//start recording polygons for a building load, and load the building's previous snapshot
+	//the snapshot is replayed if its main source file matches
+
+	Close();
+
+	this->filename = filename;
+	is_open = true;
+
+	if (Load() == true && loaded.source_count > 0)
+	{
+		const Source &first = loaded.sources[0];
+		replay = (first.hash == source_hash && GetString(loaded, first.name, first.name_length) == source);
+	}
+
+	Source info;
+	info.hash = source_hash;
+	info.name = AddString(source);
+	info.name_length = (uint32_t)source.size();
+	added_sources.emplace_back(info);
+
+	if (sbs->Verbose == true && replay == true)
+		Report("Using geometry snapshot '" + filename + "'");
+}
+
+void GeometrySnapshot::AddSource(const std::string &source, uint64_t source_hash)
+{
+	//register an included source file
+	//replay stops if the file doesn't match the snapshot, since it may change texture mapping state
+
+	if (is_open == false)
+		return;
+
+	size_t i = added_sources.size();
+
+	if (replay == true)
+	{
+		if (i >= loaded.source_count || loaded.sources[i].hash != source_hash || GetString(loaded, loaded.sources[i].name, loaded.sources[i].name_length) != source)
+		{
+			replay = false;
+			if (sbs->Verbose == true)
+				Report("Geometry snapshot is out of date at '" + source + "'");
+		}
+	}
+
+	Source info;
+	info.hash = source_hash;
+	info.name = AddString(source);
+	info.name_length = (uint32_t)source.size();
+	added_sources.emplace_back(info);
+}
+
+bool GeometrySnapshot::Load()
+{
+	//load the snapshot file into a single buffer, and set up array views into it
+
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+
+	std::streamoff size = file.tellg();
+	if (size < (std::streamoff)sizeof(Header))
+		return false;
+
+	buffer.resize((size_t)size);
+	file.seekg(0);
+	if (!file.read(buffer.data(), size))
+		return false;
+
+	Header header;
+	memcpy(&header, buffer.data(), sizeof(header));
+
+	if (header.file.IsValid(SnapshotMagic, SnapshotVersion, sizeof(Real)) == false)
+		return false;
+
+	//skip snapshots made with other texture mapping or unit settings
+	if (header.config != GetConfigHash())
+	{
+		if (sbs->Verbose == true)
+			Report("Geometry snapshot '" + filename + "' was made with other settings");
+		return false;
+	}
+
+	//get array offsets
+	size_t offset = Align(sizeof(Header));
+	size_t sources = offset;
+	offset = Align(offset + header.source_count * sizeof(Source));
+	size_t records = offset;
+	offset = Align(offset + header.record_count * sizeof(Record));
+	size_t rings = offset;
+	offset = Align(offset + header.ring_count * sizeof(uint32_t));
+	size_t vertices = offset;
+	offset = Align(offset + header.vertex_count * sizeof(Geometry));
+	size_t triangles = offset;
+	offset = Align(offset + header.triangle_count * sizeof(Triangle));
+	size_t strings = offset;
+	offset += header.string_size;
+
+	if (offset > buffer.size())
+		return ReportError("Geometry snapshot '" + filename + "' is truncated");
+
+	loaded.sources = (const Source*)&buffer[sources];
+	loaded.records = (const Record*)&buffer[records];
+	loaded.rings = (const uint32_t*)&buffer[rings];
+	loaded.vertices = (const Geometry*)&buffer[vertices];
+	loaded.triangles = (const Triangle*)&buffer[triangles];
+	loaded.strings = &buffer[strings];
+	loaded.source_count = header.source_count;
+	loaded.record_count = header.record_count;
+
+	//verify record ranges, and index records by key
+	index.reserve(header.record_count);
+	for (uint32_t i = 0; i < header.record_count; i++)
+	{
+		const Record &record = loaded.records[i];
+
+		if ((uint64_t)record.ring_start + record.ring_count > header.ring_count ||
+				(uint64_t)record.triangle_start + record.triangle_count > header.triangle_count ||
+				(uint64_t)record.material + record.material_length > header.string_size)
+		{
+			Clear();
+			return ReportError("Geometry snapshot '" + filename + "' is invalid");
+		}
+
+		uint64_t vertex_end = record.vertex_start;
+		for (uint32_t j = 0; j < record.ring_count; j++)
+			vertex_end += loaded.rings[record.ring_start + j];
+
+		if (vertex_end > header.vertex_count)
+		{
+			Clear();
+			return ReportError("Geometry snapshot '" + filename + "' is invalid");
+		}
+
+		//triangle indices are relative to the record's first vertex
+		uint64_t vertex_count = vertex_end - record.vertex_start;
+		for (uint32_t j = 0; j < record.triangle_count; j++)
+		{
+			const Triangle &triangle = loaded.triangles[record.triangle_start + j];
+
+			if (triangle.a >= vertex_count || triangle.b >= vertex_count || triangle.c >= vertex_count)
+			{
+				Clear();
+				return ReportError("Geometry snapshot '" + filename + "' is invalid");
+			}
+		}
+
+		index[record.key] = i;
+	}
+
+	for (uint32_t i = 0; i < header.source_count; i++)
+	{
+		if ((uint64_t)loaded.sources[i].name + loaded.sources[i].name_length > header.string_size)
+		{
+			Clear();
+			return ReportError("Geometry snapshot '" + filename + "' is invalid");
+		}
+	}
+
+	return true;
+}
+
+bool GeometrySnapshot::Save()
+{
+	//write the snapshot for this load, if it changed
+	//loaded records that were used are kept, and records for new geometry are added
+
+	if (is_open == false || filename == "")
+		return false;
+
+	//skip if the whole snapshot was replayed
+	std::unordered_set<uint64_t> keys;
+	for (size_t i = 0; i < used.size(); i++)
+		keys.insert(loaded.records[used[i]].key);
+
+	if (replay == true && misses == 0 && keys.size() == loaded.record_count && added_sources.size() == loaded.source_count)
+		return true;
+
+	//merge used and new records into output arrays
+	std::vector<Record> records;
+	std::vector<uint32_t> rings;
+	std::vector<Geometry> vertices;
+	std::vector<Triangle> triangles;
+	std::string strings = added_strings;
+	records.reserve(keys.size() + added_records.size());
+
+	keys.clear();
+	for (int pass = 0; pass < 2; pass++)
+	{
+		const Table *table;
+		Table added;
+		size_t count;
+
+		if (pass == 0)
+		{
+			table = &loaded;
+			count = used.size();
+		}
+		else
+		{
+			memset(&added, 0, sizeof(added));
+			added.records = added_records.data();
+			added.rings = added_rings.data();
+			added.vertices = added_vertices.data();
+			added.triangles = added_triangles.data();
+			added.strings = added_strings.data();
+			table = &added;
+			count = added_records.size();
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const Record &source = table->records[(pass == 0) ? used[i] : i];
+
+			if (keys.insert(source.key).second == false)
+				continue;
+
+			Record record = source;
+			record.ring_start = (uint32_t)rings.size();
+			record.vertex_start = (uint32_t)vertices.size();
+			record.triangle_start = (uint32_t)triangles.size();
+
+			size_t vertex_count = 0;
+			for (uint32_t j = 0; j < source.ring_count; j++)
+			{
+				rings.emplace_back(table->rings[source.ring_start + j]);
+				vertex_count += table->rings[source.ring_start + j];
+			}
+			vertices.insert(vertices.end(), table->vertices + source.vertex_start, table->vertices + source.vertex_start + vertex_count);
+			triangles.insert(triangles.end(), table->triangles + source.triangle_start, table->triangles + source.triangle_start + source.triangle_count);
+
+			if (pass == 0)
+			{
+				record.material = (uint32_t)strings.size();
+				strings.append(loaded.strings + source.material, source.material_length);
+			}
+
+			records.emplace_back(record);
+		}
+	}
+
+	Header header;
+	header.file.Set(SnapshotMagic, SnapshotVersion, sizeof(Real));
+	header.config = GetConfigHash();
+	header.source_count = (uint32_t)added_sources.size();
+	header.record_count = (uint32_t)records.size();
+	header.ring_count = (uint32_t)rings.size();
+	header.vertex_count = (uint32_t)vertices.size();
+	header.triangle_count = (uint32_t)triangles.size();
+	header.string_size = (uint32_t)strings.size();
+
+	std::error_code error;
+	std::filesystem::path path (filename);
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path(), error);
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file)
+		return ReportError("Error writing geometry snapshot '" + filename + "'");
+
+	//write arrays, each aligned to 8 bytes
+	size_t offset = 0;
+	const char padding[8] = {0};
+	const void *data[] = {&header, added_sources.data(), records.data(), rings.data(), vertices.data(), triangles.data(), strings.data()};
+	size_t sizes[] = {sizeof(header), added_sources.size() * sizeof(Source), records.size() * sizeof(Record), rings.size() * sizeof(uint32_t), vertices.size() * sizeof(Geometry), triangles.size() * sizeof(Triangle), strings.size()};
+
+	for (size_t i = 0; i < 7; i++)
+	{
+		file.write(padding, Align(offset) - offset);
+		offset = Align(offset);
+		file.write((const char*)data[i], sizes[i]);
+		offset += sizes[i];
+	}
+
+	if (!file)
+		return ReportError("Error writing geometry snapshot '" + filename + "'");
+
+	if (sbs->Verbose == true)
+		Report("Saved geometry snapshot '" + filename + "' with " + ToString((int)records.size()) + " polygons");
+
+	return true;
+}
+
+void GeometrySnapshot::Close()
+{
+	//stop recording, and free snapshot data
+
+	Clear();
+	is_open = false;
+	filename = "";
+}
+
+uint64_t GeometrySnapshot::GetConfigHash()
+{
+	//get a hash of the settings that change the geometry and texels of created polygons,
+	//which aren't part of the source files
+
+	int mapper = sbs->GetTextureManager()->GetDefaultMapper();
+	Real scale = sbs->GetUtility()->UnitScale;
+
+	uint64_t hash = Hash(&mapper, sizeof(mapper));
+	return Hash(&scale, sizeof(scale), hash);
+}
+
+uint64_t GeometrySnapshot::GetKey(Wall *wall, const std::string &name, const std::string &texture, const PolyArray &vertices, Real tw, Real th, bool autosize)
+{
+	//get the key of a polygon created from a texture name and vertex list
+
+	uint64_t hash = HashSeed;
+	hash = Hash(wall->GetMesh()->name, hash);
+	hash = Hash(wall->GetName(), hash);
+	hash = Hash(name, hash);
+	hash = Hash(texture, hash);
+	hash = Hash(vertices.data(), vertices.size() * sizeof(Vector3), hash);
+	hash = Hash(&tw, sizeof(tw), hash);
+	hash = Hash(&th, sizeof(th), hash);
+	hash = Hash(&autosize, sizeof(autosize), hash);
+	return hash;
+}
+
+uint64_t GeometrySnapshot::GetKey(Wall *wall, const std::string &name, const std::string &material, const PolygonSet &vertices, const Matrix3 &tex_matrix, const Vector3 &tex_vector)
+{
+	//get the key of a polygon set created from a material and texture mapping
+
+	uint64_t hash = HashSeed ^ 1;
+	hash = Hash(wall->GetMesh()->name, hash);
+	hash = Hash(wall->GetName(), hash);
+	hash = Hash(name, hash);
+	hash = Hash(material, hash);
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		uint64_t count = vertices[i].size();
+		hash = Hash(&count, sizeof(count), hash);
+		hash = Hash(vertices[i].data(), vertices[i].size() * sizeof(Vector3), hash);
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			Real value = tex_matrix[i][j];
+			hash = Hash(&value, sizeof(value), hash);
+		}
+	}
+	hash = Hash(tex_vector.ptr(), sizeof(Real) * 3, hash);
+	return hash;
+}
+
+bool GeometrySnapshot::Restore(uint64_t key, const std::string &material, GeometrySet &geometry, std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, Plane &plane)
+{
+	//get the stored results for a polygon, if the snapshot has it
+	//returns false if the polygon needs to be created normally, and recorded with Store()
+
+	if (replay == false)
+		return false;
+
+	std::unordered_map<uint64_t, uint32_t>::iterator it = index.find(key);
+	if (it == index.end())
+	{
+		misses++;
+		return false;
+	}
+
+	const Record &record = loaded.records[it->second];
+
+	//the material also depends on texture definitions
+	if (GetString(loaded, record.material, record.material_length) != material)
+	{
+		misses++;
+		return false;
+	}
+
+	const Geometry *vertex = loaded.vertices + record.vertex_start;
+	geometry.resize(record.ring_count);
+	for (uint32_t i = 0; i < record.ring_count; i++)
+	{
+		uint32_t count = loaded.rings[record.ring_start + i];
+		geometry[i].assign(vertex, vertex + count);
+		vertex += count;
+	}
+
+	triangles.assign(loaded.triangles + record.triangle_start, loaded.triangles + record.triangle_start + record.triangle_count);
+
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			tex_matrix[i][j] = record.tex_matrix[(i * 3) + j];
+	}
+	tex_vector = Vector3(record.tex_vector[0], record.tex_vector[1], record.tex_vector[2]);
+	plane.normal = Vector3(record.plane[0], record.plane[1], record.plane[2]);
+	plane.d = record.plane[3];
+
+	used.emplace_back(it->second);
+	restored++;
+	return true;
+}
+
+void GeometrySnapshot::Store(uint64_t key, const std::string &material, const GeometrySet &geometry, const std::vector<Triangle> &triangles, const Matrix3 &tex_matrix, const Vector3 &tex_vector, const Plane &plane)
+{
+	//store the results of a newly created polygon
+
+	if (is_open == false)
+		return;
+
+	Record record;
+	memset(&record, 0, sizeof(record));
+	record.key = key;
+	record.material = AddString(material);
+	record.material_length = (uint32_t)material.size();
+	record.ring_start = (uint32_t)added_rings.size();
+	record.ring_count = (uint32_t)geometry.size();
+	record.vertex_start = (uint32_t)added_vertices.size();
+	record.triangle_start = (uint32_t)added_triangles.size();
+	record.triangle_count = (uint32_t)triangles.size();
+
+	for (size_t i = 0; i < geometry.size(); i++)
+	{
+		added_rings.emplace_back((uint32_t)geometry[i].size());
+		added_vertices.insert(added_vertices.end(), geometry[i].begin(), geometry[i].end());
+	}
+	added_triangles.insert(added_triangles.end(), triangles.begin(), triangles.end());
+
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			record.tex_matrix[(i * 3) + j] = tex_matrix[i][j];
+	}
+	record.tex_vector[0] = tex_vector.x;
+	record.tex_vector[1] = tex_vector.y;
+	record.tex_vector[2] = tex_vector.z;
+	record.plane[0] = plane.normal.x;
+	record.plane[1] = plane.normal.y;
+	record.plane[2] = plane.normal.z;
+	record.plane[3] = plane.d;
+
+	added_records.emplace_back(record);
+}
+
+std::string GeometrySnapshot::GetString(const Table &table, uint32_t offset, uint32_t length)
+{
+	return std::string(table.strings + offset, length);
+}
+
+uint32_t GeometrySnapshot::AddString(const std::string &value)
+{
+	//add a string to the string table of this load, and return its offset
+
+	uint32_t offset = (uint32_t)added_strings.size();
+	added_strings.append(value);
+	return offset;
+}
+
+}
@@ -0,0 +1,135 @@
+/*
+	Scalable Building Simulator - Geometry Snapshot
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_SNAPSHOT_H
+#define _SBS_SNAPSHOT_H
+
+#include <unordered_map>
+#include "polygon.h"
+#include "cachefile.h"
+
+namespace SBS {
+
+//versioned binary snapshot of the polygon geometry created while a building loads
+//records are keyed by a hash of each polygon's inputs, and store the resulting geometry, triangles,
+//material and texture mapping, so that a reload can skip texture mapping and triangulation.
+//the file is a header followed by contiguous arrays, and is read with a single read into one buffer
+class SBSIMPEXP GeometrySnapshot : public ObjectBase
+{
+public:
+
+	struct Header
+	{
+		CacheFileHeader file;
+		uint64_t config; //hash of settings that change polygon geometry and texture mapping
+		uint32_t source_count;
+		uint32_t record_count;
+		uint32_t ring_count;
+		uint32_t vertex_count;
+		uint32_t triangle_count;
+		uint32_t string_size;
+	};
+
+	struct Source
+	{
+		uint64_t hash; //hash of file contents
+		uint32_t name; //offset of filename in string table
+		uint32_t name_length;
+	};
+
+	struct Record
+	{
+		uint64_t key; //hash of the polygon's inputs
+		uint32_t material; //offset of material name in string table
+		uint32_t material_length;
+		uint32_t ring_start; //first entry in ring table (vertex count of each sub-polygon)
+		uint32_t ring_count;
+		uint32_t vertex_start; //first entry in vertex table
+		uint32_t triangle_start; //first entry in triangle table
+		uint32_t triangle_count;
+		uint32_t reserved;
+		Real tex_matrix[9];
+		Real tex_vector[3];
+		Real plane[4];
+	};
+
+	explicit GeometrySnapshot(Object *parent);
+	~GeometrySnapshot();
+	void Open(const std::string &filename, const std::string &source, uint64_t source_hash);
+	void AddSource(const std::string &source, uint64_t source_hash);
+	bool Save();
+	void Close();
+	bool IsOpen() { return is_open; }
+	bool IsReplaying() { return replay; }
+	uint64_t GetKey(Wall *wall, const std::string &name, const std::string &texture, const PolyArray &vertices, Real tw, Real th, bool autosize);
+	uint64_t GetKey(Wall *wall, const std::string &name, const std::string &material, const PolygonSet &vertices, const Matrix3 &tex_matrix, const Vector3 &tex_vector);
+	bool Restore(uint64_t key, const std::string &material, GeometrySet &geometry, std::vector<Triangle> &triangles, Matrix3 &tex_matrix, Vector3 &tex_vector, Plane &plane);
+	void Store(uint64_t key, const std::string &material, const GeometrySet &geometry, const std::vector<Triangle> &triangles, const Matrix3 &tex_matrix, const Vector3 &tex_vector, const Plane &plane);
+	size_t GetRestoredCount() { return restored; }
+	size_t GetRecordedCount() { return added_records.size(); }
+
+private:
+
+	//array views of a loaded snapshot or of newly recorded data
+	struct Table
+	{
+		const Source *sources;
+		const Record *records;
+		const uint32_t *rings;
+		const Geometry *vertices;
+		const Triangle *triangles;
+		const char *strings;
+		uint32_t source_count;
+		uint32_t record_count;
+	};
+
+	bool Load();
+	uint64_t GetConfigHash();
+	void Clear();
+	std::string GetString(const Table &table, uint32_t offset, uint32_t length);
+	uint32_t AddString(const std::string &value);
+
+	std::string filename;
+	bool is_open;
+	bool replay; //true while the loaded snapshot matches the sources loaded so far
+	size_t restored; //number of polygons restored from the snapshot
+	size_t misses; //number of polygons that weren't found in the snapshot
+
+	//loaded snapshot
+	std::vector<char> buffer;
+	Table loaded;
+	std::unordered_map<uint64_t, uint32_t> index; //record index by key
+	std::vector<uint32_t> used; //loaded records used by this load
+
+	//sources of this load, and records added during this load
+	std::vector<Source> added_sources;
+	std::vector<Record> added_records;
+	std::vector<uint32_t> added_rings;
+	std::vector<Geometry> added_vertices;
+	std::vector<Triangle> added_triangles;
+	std::string added_strings;
+};
+
+}
+
+#endif
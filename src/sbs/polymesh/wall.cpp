@@ -32,6 +32,7 @@
 #include "texman.h"
 #include "profiler.h"
 #include "utility.h"
+#include "snapshot.h"
 #include "wall.h"
 
 namespace SBS {
@@ -44,6 +45,9 @@ Wall::Wall(MeshObject* wrapper, const std::string &name) : Object(wrapper)
 	meshwrapper = wrapper;
 	polymesh = sbs->GetPolyMesh();
 	parent_array = 0;
+	bounds_min = Vector3::ZERO;
+	bounds_max = Vector3::ZERO;
+	has_bounds = false;
 
 	if (!meshwrapper)
 		return;
@@ -120,25 +124,41 @@ Polygon* Wall::AddPolygon(const std::string &name, const std::string &texture, P
 	//create polygon
 	Polygon* poly = new Polygon(this, name, meshwrapper);
 
-	if (!polymesh->CreateMesh(meshwrapper, this, poly, name, texture, vertices, tw, th, autosize, tm, tv, geometry, triangles, converted_vertices))
+	bool result;
+	std::string material = sbs->GetTextureManager()->GetTextureMaterial(texture, result, true, name);
+	Plane plane;
+
+	//use the polygon from the geometry snapshot if available, otherwise create it
+	GeometrySnapshot *snapshot = sbs->GetGeometrySnapshot();
+	uint64_t key = 0;
+	if (snapshot)
+		key = snapshot->GetKey(this, name, texture, vertices, tw, th, autosize);
+
+	if (snapshot && snapshot->Restore(key, material, geometry, triangles, tm, tv, plane) == true)
+		polymesh->AddPickGeometry(meshwrapper, this, poly, geometry, triangles);
+	else
 	{
-		ReportError("Error creating wall '" + name + "'");
-		return 0;
-	}
+		if (!polymesh->CreateMesh(meshwrapper, this, poly, name, texture, vertices, tw, th, autosize, tm, tv, geometry, triangles, converted_vertices))
+		{
+			ReportError("Error creating wall '" + name + "'");
+			return 0;
+		}
 
-	if (triangles.size() == 0)
-		return 0;
+		if (triangles.size() == 0)
+			return 0;
 
-	bool result;
-	std::string material = sbs->GetTextureManager()->GetTextureMaterial(texture, result, true, name);
+		//compute plane
+		plane = sbs->GetPolyMesh()->ComputePlane(converted_vertices[0]);
 
-	//compute plane
-	Plane plane = sbs->GetPolyMesh()->ComputePlane(converted_vertices[0]);
+		if (snapshot)
+			snapshot->Store(key, material, geometry, triangles, tm, tv, plane);
+	}
 
 	//store geometry data in polygon
 	poly->Create(geometry, triangles, tm, tv, material, plane);
 
 	polygons.emplace_back(poly);
+	AddBounds(poly);
 	return poly;
 }
 
@@ -173,6 +193,7 @@ Polygon* Wall::AddPolygon(const std::string &name, const std::string &texture, P
 
 	poly->Create(geometry, triangles, tm, tv, material, plane);
 	polygons.emplace_back(poly);
+	AddBounds(poly);
 	return poly;
 }
 
@@ -187,20 +208,39 @@ Polygon* Wall::AddPolygonSet(const std::string &name, const std::string &materia
 	//create polygon
 	Polygon* poly = new Polygon(this, name, meshwrapper);
 
-	if (!polymesh->CreateMesh(meshwrapper, this, poly, name, material, vertices, tex_matrix, tex_vector, geometry, triangles, converted_vertices, 0, 0))
+	Plane plane;
+	Matrix3 tm = tex_matrix;
+	Vector3 tv = tex_vector;
+
+	//use the polygon from the geometry snapshot if available, otherwise create it
+	GeometrySnapshot *snapshot = sbs->GetGeometrySnapshot();
+	uint64_t key = 0;
+	if (snapshot)
+		key = snapshot->GetKey(this, name, material, vertices, tex_matrix, tex_vector);
+
+	if (snapshot && snapshot->Restore(key, material, geometry, triangles, tm, tv, plane) == true)
+		polymesh->AddPickGeometry(meshwrapper, this, poly, geometry, triangles);
+	else
 	{
-		ReportError("Error creating wall '" + name + "'");
-		return 0;
-	}
+		if (!polymesh->CreateMesh(meshwrapper, this, poly, name, material, vertices, tex_matrix, tex_vector, geometry, triangles, converted_vertices, 0, 0))
+		{
+			ReportError("Error creating wall '" + name + "'");
+			return 0;
+		}
 
-	if (triangles.size() == 0)
-		return 0;
+		if (triangles.size() == 0)
+			return 0;
 
-	//compute plane
-	Plane plane = sbs->GetPolyMesh()->ComputePlane(converted_vertices[0]);
+		//compute plane
+		plane = sbs->GetPolyMesh()->ComputePlane(converted_vertices[0]);
+
+		if (snapshot)
+			snapshot->Store(key, material, geometry, triangles, tex_matrix, tex_vector, plane);
+	}
 
 	poly->Create(geometry, triangles, tex_matrix, tex_vector, material, plane);
 	polygons.emplace_back(poly);
+	AddBounds(poly);
 
 	return poly;
 }
@@ -267,6 +307,7 @@ Polygon* Wall::AddPolygonSet(const std::string& name, const std::string& materia
 
 	poly->Create(outGeom, triangles, tm, tv, material, plane);
 	polygons.emplace_back(poly);
+	AddBounds(poly);
 
 	return poly;
 }
@@ -283,6 +324,7 @@ void Wall::DeletePolygons(bool recreate_collider)
 		delete polygons[i];
 	}
 	polygons.clear();
+	has_bounds = false;
 
 	//recreate colliders
 	if (recreate_collider == true)
@@ -305,6 +347,7 @@ void Wall::DeletePolygon(int index, bool recreate_colliders)
 	if (index > -1 && index < (int)polygons.size())
 	{
 		//delete polygon
+		//the wall bounds are left as they are, since a larger box is still valid for culling
 		delete polygons[index];
 		polygons.erase(polygons.begin() + index);
 
@@ -403,6 +446,7 @@ void Wall::Move(const Vector3 &vector, Real speed)
 		if (polygons[i])
 			polygons[i]->Move(vector, speed);
 	}
+	UpdateBounds();
 
 	//prepare mesh
 	if (meshwrapper->UsingDynamicBuffers() == false)
@@ -449,9 +493,11 @@ Vector3 Wall::GetWallExtents(Real altitude, bool get_max)
 			continue;
 
 		PolyArray poly, tmp1, tmp2;
-		for (size_t j = 0; j < polygons[i]->geometry[0].size(); j++)
+		const Vector3 *positions = polygons[i]->GetPositions();
+		size_t count = (polygons[i]->GetRingCount() > 0 ? polygons[i]->GetRingSize(0) : 0);
+		for (size_t j = 0; j < count; j++)
 		{
-			poly.emplace_back(sbs->ToLocal(polygons[i]->geometry[0][j].vertex));
+			poly.emplace_back(sbs->ToLocal(positions[j]));
 		}
 
 		//if given altitude is outside of polygon's range, return 0
@@ -498,6 +544,7 @@ void Wall::ChangeHeight(Real newheight)
 		if (polygons[i])
 			polygons[i]->ChangeHeight(newheight);
 	}
+	UpdateBounds();
 
 	//prepare mesh
 	if (meshwrapper->UsingDynamicBuffers() == false)
@@ -512,7 +559,7 @@ unsigned int Wall::GetVertexCount()
 	for (size_t i = 0; i < polygons.size(); i++)
 	{
 		if (polygons[i])
-			total += polygons[i]->vertex_count;
+			total += polygons[i]->GetVertexCount();
 	}
 	return total;
 }
@@ -523,7 +570,7 @@ unsigned int Wall::GetTriangleCount()
 	for (size_t i = 0; i < polygons.size(); i++)
 	{
 		if (polygons[i])
-			total += polygons[i]->triangles.size();
+			total += polygons[i]->GetTriangleCount();
 	}
 	return total;
 }
@@ -562,4 +609,48 @@ bool Wall::ChangeTexture(const std::string &texture, bool matcheck)
 	return found;
 }
 
+bool Wall::GetBounds(Vector3 &min, Vector3 &max)
+{
+	//get the bounding box of this wall's polygons, in local positioning
+	//the box can be larger than the current polygons, since it isn't shrunk when polygons are removed
+	//returns false if the wall has no polygons
+
+	min = bounds_min;
+	max = bounds_max;
+	return has_bounds;
+}
+
+void Wall::AddBounds(Polygon *polygon)
+{
+	//grow the wall and mesh bounding boxes to include a new polygon
+
+	if (!polygon || polygon->GetVertexCount() == 0)
+		return;
+
+	if (has_bounds == false)
+	{
+		bounds_min = polygon->bounds_min;
+		bounds_max = polygon->bounds_max;
+		has_bounds = true;
+	}
+	else
+	{
+		bounds_min.makeFloor(polygon->bounds_min);
+		bounds_max.makeCeil(polygon->bounds_max);
+	}
+
+	if (meshwrapper)
+		meshwrapper->AddWallBounds(polygon->bounds_min, polygon->bounds_max);
+}
+
+void Wall::UpdateBounds()
+{
+	//recalculate the bounding box after polygons have moved
+
+	has_bounds = false;
+
+	for (size_t i = 0; i < polygons.size(); i++)
+		AddBounds(polygons[i]);
+}
+
 }
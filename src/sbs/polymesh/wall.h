@@ -63,8 +63,12 @@ public:
 	unsigned int GetTriangleCount();
 	bool ReplaceTexture(const std::string &oldtexture, const std::string &newtexture);
 	bool ChangeTexture(const std::string &texture, bool matcheck = true);
+	bool GetBounds(Vector3 &min, Vector3 &max);
 
 private:
+	void AddBounds(Polygon *polygon);
+	void UpdateBounds();
+
 	//mesh wrapper
 	MeshObject* meshwrapper;
 
@@ -76,6 +80,11 @@ private:
 
 	//pointer to parent array
 	std::vector<Wall*> *parent_array;
+
+	//bounding box of the polygons in local positioning, for culling cuts
+	Vector3 bounds_min;
+	Vector3 bounds_max;
+	bool has_bounds;
 };
 
 }
@@ -23,6 +23,7 @@
 
 #include <OgreRoot.h>
 #include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
 #include <OgreFileSystem.h>
 #include <OgreConfigFile.h>
 #include <OgreTimer.h>
@@ -31,6 +32,8 @@
 #include <fmod.hpp>
 #endif
 #include <OgreBulletDynamicsRigidBody.h>
+#include <algorithm>
+#include <filesystem>
 #include "globals.h"
 #include "sbs.h"
 #include "manager.h"
@@ -39,6 +42,7 @@
 #include "floor.h"
 #include "elevator.h"
 #include "elevatorcar.h"
+#include "floorindicator.h"
 #include "shaft.h"
 #include "stairs.h"
 #include "action.h"
@@ -67,6 +71,14 @@
 #include "map.h"
 #include "shape.h"
 #include "reverb.h"
+#include "route.h"
+#include "spatialgrid.h"
+#include "collidercache.h"
+#include "snapshot.h"
+#include "threadpool.h"
+#include "scenenode.h"
+#include "nameindex.h"
+#include "crowd.h"
 
 namespace SBS {
 
@@ -75,6 +87,11 @@ SBS::SBS(Ogre::SceneManager* mSceneManager, FMOD::System *fmodsystem, int instan
 	sbs = this;
 	this->mSceneManager = mSceneManager;
 
+	//create name indexes before objects register
+	object_index = new NameIndex<Object>();
+	mesh_index = new NameIndex<MeshObject>();
+	action_index = new NameIndex<Action>();
+
 	version = "1.1.0." + ToString(GIT_REV);
 	version_state = "Alpha";
 
@@ -117,6 +134,9 @@ SBS::SBS(Ogre::SceneManager* mSceneManager, FMOD::System *fmodsystem, int instan
 	ElevatorNumber = 1;
 	CarNumber = 1;
 	delta = 0.01;
+	FixedStep = 0;
+	fixed_time = 0;
+	timer_sequence = 0;
 	ProcessElevators = GetConfigBool("Skyscraper.SBS.ProcessElevators", true);
 	remaining_delta = 0;
 	start_time = 0;
@@ -167,6 +187,27 @@ SBS::SBS(Ogre::SceneManager* mSceneManager, FMOD::System *fmodsystem, int instan
 	//create polymesh (geometry processor) object
 	polymesh = new PolyMesh(this);
 
+	//create elevator route graph
+	route_graph = new RouteGraph(this);
+
+	//create spatial grids
+	Real cell_size = GetConfigFloat("Skyscraper.SBS.GridCellSize", 20);
+	//triggers without a height are unbounded vertically, so they're indexed by X and Z only
+	trigger_grid = new SpatialGrid(this, cell_size, true);
+	trigger_query = 0;
+	area_grid = new SpatialGrid(this, cell_size);
+
+	//create collider cache
+	collider_cache = 0;
+	collider_cache_loaded = false;
+	if (GetConfigBool("Skyscraper.SBS.ColliderCache", true) == true)
+		collider_cache = new ColliderCache(this);
+
+	//create geometry snapshot
+	geometry_snapshot = 0;
+	if (GetConfigBool("Skyscraper.SBS.GeometrySnapshot", true) == true)
+		geometry_snapshot = new GeometrySnapshot(this);
+
 	//create geometry controller object
 	geometry = new GeometryController(this);
 
@@ -190,6 +231,7 @@ SBS::SBS(Ogre::SceneManager* mSceneManager, FMOD::System *fmodsystem, int instan
 	vehicle_manager = 0;
 	controller_manager = 0;
 	teleporter_manager = 0;
+	crowd = 0;
 
 	//Print SBS banner
 	PrintBanner();
@@ -247,6 +289,9 @@ void SBS::Initialize()
 	controller_manager = new ControllerManager(this);
 	teleporter_manager = new TeleporterManager(this);
 
+	//create crowd simulation
+	crowd = new Crowd(this);
+
 	//create camera object
 	this->camera = new Camera(this);
 
@@ -355,6 +400,14 @@ SBS::~SBS()
 	}
 	camera = 0;
 
+	//delete crowd simulation
+	if (crowd)
+	{
+		crowd->parent_deleting = true;
+		delete crowd;
+	}
+	crowd = 0;
+
 	//delete manager objects
 	if (floor_manager)
 	{
@@ -507,6 +560,26 @@ SBS::~SBS()
 		delete polymesh;
 	polymesh = 0;
 
+	if (route_graph)
+		delete route_graph;
+	route_graph = 0;
+
+	if (trigger_grid)
+		delete trigger_grid;
+	trigger_grid = 0;
+
+	if (area_grid)
+		delete area_grid;
+	area_grid = 0;
+
+	if (collider_cache)
+		delete collider_cache;
+	collider_cache = 0;
+
+	if (geometry_snapshot)
+		delete geometry_snapshot;
+	geometry_snapshot = 0;
+
 	if (geometry)
 		delete geometry;
 	geometry = 0;
@@ -519,6 +592,18 @@ SBS::~SBS()
 		delete configfile;
 	configfile = 0;
 
+	if (object_index)
+		delete object_index;
+	object_index = 0;
+
+	if (mesh_index)
+		delete mesh_index;
+	mesh_index = 0;
+
+	if (action_index)
+		delete action_index;
+	action_index = 0;
+
 	Report("Exiting");
 
 	//clear self reference
@@ -529,6 +614,15 @@ bool SBS::Start()
 {
 	//Post-init startup code goes here, before the runloop
 
+	//save geometry snapshot of the loaded building
+	if (geometry_snapshot && geometry_snapshot->IsOpen() == true)
+	{
+		if (Verbose == true)
+			Report("Restored " + ToString((int)geometry_snapshot->GetRestoredCount()) + " polygons from geometry snapshot");
+		geometry_snapshot->Save();
+		geometry_snapshot->Close();
+	}
+
 	//prepare 3D geometry for use
 	Prepare();
 
@@ -555,6 +649,9 @@ bool SBS::Start()
 	//initialize objects (cascades down through entire object tree)
 	Init();
 
+	//build elevator route graph
+	route_graph->Build();
+
 	//play looping global sounds
 	for (size_t i = 0; i < sounds.size(); i++)
 	{
@@ -664,6 +761,10 @@ bool SBS::Loop(bool loading, bool isready)
 		elapsed = .5;
 
 	ProfileManager::Start_Profile("Simulator Loop");
+
+	//find trigger volumes near the camera
+	QueryTriggers();
+
 	while (elapsed >= delta)
 	{
 		//Determine floor that the camera is on
@@ -1132,35 +1233,100 @@ bool SBS::RegisterTimerCallback(TimerObject *timer)
 	if (!timer)
 		return false;
 
-	for (size_t i = 0; i < timercallbacks.size(); i++)
-	{
-		if (timercallbacks[i] == timer)
-			return false;
-	}
+	//exit if timer is already registered
+	if (timercallbacks.find(timer) != timercallbacks.end())
+		return false;
 
-	//if timer isn't already in the array, add it
-	timercallbacks.emplace_back(timer);
+	TimerEntry entry;
+	entry.due = 0;
+	entry.sequence = 0;
+	entry.timer = timer;
+	timercallbacks[timer] = entry;
 
 	return true;
 }
 
 bool SBS::UnregisterTimerCallback(TimerObject *timer)
 {
+	//unregister a timer object; any queued notification is skipped
+
 	if (!timer)
 		return false;
 
-	return RemoveArrayElement(timercallbacks, timer);
+	return timercallbacks.erase(timer) > 0;
+}
+
+bool SBS::ScheduleTimer(TimerObject *timer, unsigned long due)
+{
+	//schedule the next notification of a registered timer, replacing any previous one
+
+	std::unordered_map<TimerObject*, TimerEntry>::iterator it = timercallbacks.find(timer);
+	if (it == timercallbacks.end())
+		return false;
+
+	TimerEntry &entry = it->second;
+	entry.due = due;
+	entry.sequence = ++timer_sequence;
+	timer_queue.push(entry);
+
+	//rebuild the queue if it's mostly made of skipped entries
+	if (timer_queue.size() > (timercallbacks.size() * 2) + 64)
+	{
+		std::vector<TimerEntry> entries;
+		entries.reserve(timercallbacks.size());
+		for (it = timercallbacks.begin(); it != timercallbacks.end(); ++it)
+		{
+			if (it->second.sequence > 0)
+				entries.emplace_back(it->second);
+		}
+		timer_queue = std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry> >(std::greater<TimerEntry>(), std::move(entries));
+	}
+
+	return true;
+}
+
+bool SBS::IsTimerScheduled(TimerObject *timer)
+{
+	//returns true if the timer has a pending notification
+
+	std::unordered_map<TimerObject*, TimerEntry>::iterator it = timercallbacks.find(timer);
+	if (it == timercallbacks.end())
+		return false;
+	return it->second.sequence > 0;
 }
 
 void SBS::ProcessTimers()
 {
 	SBS_PROFILE("SBS::ProcessTimers");
 
-	//process all registered timers
-	for (size_t i = 0; i < timercallbacks.size(); i++)
+	//process timers that are due, in order of notification time and then schedule order
+	//timers rescheduled during this pass are processed on the next frame
+
+	unsigned long now = GetCurrentTime();
+
+	expired_timers.clear();
+	while (timer_queue.empty() == false && timer_queue.top().due <= now)
+	{
+		TimerEntry entry = timer_queue.top();
+		timer_queue.pop();
+
+		//skip entries for stopped or rescheduled timers
+		std::unordered_map<TimerObject*, TimerEntry>::iterator it = timercallbacks.find(entry.timer);
+		if (it == timercallbacks.end() || it->second.sequence != entry.sequence)
+			continue;
+
+		it->second.sequence = 0;
+		expired_timers.emplace_back(entry.timer);
+	}
+
+	for (size_t i = 0; i < expired_timers.size(); i++)
 	{
-		if (timercallbacks[i])
-			timercallbacks[i]->Loop();
+		//skip timers stopped, deleted or restarted by an earlier notification
+		std::unordered_map<TimerObject*, TimerEntry>::iterator it = timercallbacks.find(expired_timers[i]);
+		if (it == timercallbacks.end() || it->second.sequence != 0)
+			continue;
+
+		expired_timers[i]->Loop();
 	}
 }
 
@@ -1180,6 +1346,8 @@ void SBS::AddFloorAutoArea(Vector3 start, Vector3 end)
 	newarea.inside = false;
 	newarea.camerafloor = 0;
 	FloorAutoArea.emplace_back(newarea);
+
+	area_grid->Add(start, end, (int)FloorAutoArea.size() - 1);
 }
 
 void SBS::CheckAutoAreas()
@@ -1191,8 +1359,20 @@ void SBS::CheckAutoAreas()
 	Vector3 position = camera->GetPosition();
 	int floor = camera->CurrentFloor;
 
-	for (size_t i = 0; i < FloorAutoArea.size(); i++)
+	//only check areas in the camera's grid cell, and areas the camera was inside of
+	autoarea_check.clear();
+	area_grid->Query(position, autoarea_check);
+	for (size_t i = 0; i < autoarea_check.size(); i++)
+		autoarea_check[i] = area_grid->GetData(autoarea_check[i]);
+	autoarea_check.insert(autoarea_check.end(), autoarea_inside.begin(), autoarea_inside.end());
+	std::sort(autoarea_check.begin(), autoarea_check.end());
+	autoarea_check.erase(std::unique(autoarea_check.begin(), autoarea_check.end()), autoarea_check.end());
+	autoarea_inside.clear();
+
+	for (size_t j = 0; j < autoarea_check.size(); j++)
 	{
+		int i = autoarea_check[j];
+
 		//reset inside value if floor changed
 		if (FloorAutoArea[i].camerafloor != floor)
 			FloorAutoArea[i].inside = false;
@@ -1233,6 +1413,9 @@ void SBS::CheckAutoAreas()
 			GetFloor(floor)->Enabled(true);
 			GetFloor(floor)->EnableGroup(true);
 		}
+
+		if (FloorAutoArea[i].inside == true)
+			autoarea_inside.emplace_back(i);
 	}
 }
 
@@ -1394,6 +1577,11 @@ int SBS::RegisterObject(Object *object)
 	//add object to global array
 	ObjectCount++;
 	ObjectArray.emplace_back(object);
+
+	//index object by name, if already named
+	if (object && object->GetName() != "")
+		object_index->Add(GetIndexName(object->GetName(), true), object);
+
 	return (int)ObjectArray.size() - 1;
 }
 
@@ -1411,6 +1599,7 @@ bool SBS::UnregisterObject(int number)
 				std::vector<Object*> objects;
 				objects.emplace_back(ObjectArray[number]);
 				RemoveActionParent(objects);
+				object_index->Remove(GetIndexName(ObjectArray[number]->GetName(), true), ObjectArray[number]);
 				ObjectArray[number] = 0;
 				ObjectCount--;
 				return true;
@@ -1420,6 +1609,33 @@ bool SBS::UnregisterObject(int number)
 	return false;
 }
 
+void SBS::RenameObject(Object *object, const std::string &old_name)
+{
+	//update the name index after a registered object's name changes
+
+	if (!object || !object_index)
+		return;
+
+	if (GetObject(object->GetNumber()) != object)
+		return;
+
+	if (old_name != "")
+		object_index->Remove(GetIndexName(old_name, true), object);
+	if (object->GetName() != "")
+		object_index->Add(GetIndexName(object->GetName(), true), object);
+}
+
+std::string SBS::GetIndexName(const std::string &name, bool lowercase)
+{
+	//get name index key, which has spaces removed, and is optionally lowercase
+
+	std::string key = name;
+	ReplaceAll(key, " ", "");
+	if (lowercase == true)
+		SetCase(key, false);
+	return key;
+}
+
 bool SBS::IsValidFloor(int floor)
 {
 	//determine if a floor is valid
@@ -1800,6 +2016,16 @@ void SBS::Prepare(bool report, bool renderonly)
 
 	SBS_PROFILE_MAIN("Prepare");
 
+	//upload textures decoded in the background, and stop the decoding threads
+	texturemanager->ReleaseTexturePool();
+
+	//create floor indicator atlases, now that all floors exist
+	for (size_t i = 0; i < ObjectArray.size(); i++)
+	{
+		if (ObjectArray[i] && ObjectArray[i]->GetType() == "FloorIndicator")
+			static_cast<FloorIndicator*>(ObjectArray[i])->CreateAtlas();
+	}
+
 	//prepare mesh objects
 	if (report == true)
 		Report("Preparing meshes...");
@@ -1822,13 +2048,65 @@ void SBS::Prepare(bool report, bool renderonly)
 	{
 		if (report == true)
 			Report("Creating colliders...");
+
+		//load collider cache for this building
+		if (collider_cache && collider_cache_loaded == false)
+		{
+			std::string name = std::filesystem::path(BuildingFilename).filename().string();
+			collider_cache->Load("cache/" + name + ".colliders");
+			collider_cache_loaded = true;
+		}
+
+		std::vector<MeshObject*> trimeshes;
+		std::vector<Real> scales;
 		for (size_t i = 0; i < meshes.size(); i++)
 		{
 			if (meshes[i]->tricollider == true && meshes[i]->IsPhysical() == false)
-				meshes[i]->CreateCollider();
+			{
+				if (meshes[i]->CanCreateCollider() == true)
+				{
+					trimeshes.emplace_back(meshes[i]);
+					scales.emplace_back(meshes[i]->GetSceneNode()->GetScale());
+				}
+			}
 			else
 				meshes[i]->CreateBoxCollider();
 		}
+
+		//build triangle collider shapes, on worker threads if there are enough meshes
+		std::vector<OgreBulletCollisions::TriangleMeshCollisionShape*> shapes (trimeshes.size(), 0);
+		int threads = GetConfigInt("Skyscraper.SBS.ColliderThreads", 0);
+
+		if (threads != 1 && trimeshes.size() >= 16)
+		{
+			ThreadPool workers (threads - 1);
+			ColliderCache *cache = collider_cache;
+
+			for (size_t i = 0; i < trimeshes.size(); i++)
+			{
+				workers.Add([&trimeshes, &scales, &shapes, cache, i]()
+				{
+					shapes[i] = trimeshes[i]->CreateColliderShape(scales[i], cache);
+				});
+			}
+			workers.Wait();
+		}
+		else
+		{
+			for (size_t i = 0; i < trimeshes.size(); i++)
+				shapes[i] = trimeshes[i]->CreateColliderShape(scales[i], collider_cache);
+		}
+
+		//add colliders to the physics world
+		for (size_t i = 0; i < trimeshes.size(); i++)
+			trimeshes[i]->CreateCollider(shapes[i]);
+
+		if (collider_cache && report == true)
+		{
+			if (Verbose == true)
+				Report("Loaded " + ToString((int)collider_cache->GetHits()) + " collider shapes from cache");
+			collider_cache->Save();
+		}
 	}
 
 	if (report == true)
@@ -1846,22 +2124,23 @@ Light* SBS::AddLight(const std::string &name, int type)
 
 void SBS::AddMeshHandle(MeshObject* handle)
 {
-	AddArrayElement(meshes, handle);
+	if (AddArrayElement(meshes, handle) == true)
+		mesh_index->Add(handle->name, handle);
 }
 
 void SBS::DeleteMeshHandle(MeshObject* handle)
 {
-	RemoveArrayElement(meshes, handle);
+	if (RemoveArrayElement(meshes, handle) == true)
+		mesh_index->Remove(handle->name, handle);
 }
 
 MeshObject* SBS::FindMeshObject(const std::string &name)
 {
-	//find a mesh object by searching for matching wrapper
-	for (size_t i = 0; i < meshes.size(); i++)
-	{
-		if (meshes[i]->name == name)
-			return meshes[i];
-	}
+	//find a mesh object by name, returning the first registered match
+
+	const std::vector<MeshObject*> *list = mesh_index->Find(name);
+	if (list)
+		return list->front();
 	return 0;
 }
 
@@ -1971,6 +2250,15 @@ void SBS::AdvanceClock()
 
 	unsigned long last = current_time;
 
+	//in fixed-step mode, advance the clock by a constant amount,
+	//starting from the real clock to keep running timers consistent
+	if (FixedStep > 0)
+	{
+		if (fixed_time == 0)
+			fixed_time = timer->getMilliseconds();
+		fixed_time += (unsigned long)((FixedStep * 1000) + 0.5);
+	}
+
 	//get current time
 	current_time = GetCurrentTime();
 	if (last == 0)
@@ -1988,6 +2276,8 @@ void SBS::AdvanceClock()
 unsigned long SBS::GetCurrentTime()
 {
 	//get current time
+	if (FixedStep > 0 && fixed_time > 0)
+		return fixed_time;
 	return timer->getMilliseconds();
 }
 
@@ -2091,6 +2381,7 @@ Action* SBS::AddAction(const std::string &name, std::vector<Object*> &action_par
 
 	Action *action = new Action(this, name, action_parents, command, parameters);
 	ActionArray.emplace_back(action);
+	action_index->Add(GetIndexName(action->GetName(), false), action);
 	return action;
 }
 
@@ -2100,6 +2391,7 @@ Action* SBS::AddAction(const std::string &name, std::vector<Object*> &action_par
 
 	Action *action = new Action(this, name, action_parents, command);
 	ActionArray.emplace_back(action);
+	action_index->Add(GetIndexName(action->GetName(), false), action);
 	return action;
 }
 
@@ -2116,12 +2408,20 @@ std::vector<Action*> SBS::GetAction(std::string name)
 		name2 = name.substr(0, pos - 1) + name.substr(name.find(":", pos));
 
 	std::vector<Action*> actionlist;
-	for (size_t i = 0; i < ActionArray.size(); i++)
+	const std::vector<Action*> *list = action_index->Find(name);
+	if (list)
+		actionlist = *list;
+
+	if (name2 != "" && name2 != name)
 	{
-		std::string actionname = ActionArray[i]->GetName();
-		ReplaceAll(actionname, " ", "");
-		if (actionname == name || actionname == name2)
-			actionlist.emplace_back(ActionArray[i]);
+		list = action_index->Find(name2);
+		if (list)
+		{
+			actionlist.insert(actionlist.end(), list->begin(), list->end());
+
+			//return actions in creation order
+			std::sort(actionlist.begin(), actionlist.end(), [](Action *a, Action *b) { return a->GetNumber() < b->GetNumber(); });
+		}
 	}
 	return actionlist;
 }
@@ -2192,23 +2492,22 @@ bool SBS::RemoveAction(std::string name)
 	//remove action by name
 
 	ReplaceAll(name, " ", "");
-	bool result = false;
-	for (size_t i = 0; i < ActionArray.size(); i++)
+
+	const std::vector<Action*> *list = action_index->Find(name);
+	if (!list)
+		return false;
+
+	//copy list, since the index is modified while removing
+	std::vector<Action*> actionlist = *list;
+
+	for (size_t i = 0; i < actionlist.size(); i++)
 	{
-		if (ActionArray[i])
-		{
-			std::string actionname = ActionArray[i]->GetName();
-			ReplaceAll(actionname, " ", "");
-			if (actionname == name)
-			{
-				delete ActionArray[i];
-				ActionArray.erase(ActionArray.begin() + i);
-				i--;
-				result = true;
-			}
-		}
+		Action *action = actionlist[i];
+		action_index->Remove(name, action);
+		RemoveArrayElement(ActionArray, action);
+		delete action;
 	}
-	return result;
+	return true;
 }
 
 bool SBS::RemoveAction(Action *action)
@@ -2223,6 +2522,7 @@ bool SBS::RemoveAction(Action *action)
 	{
 		if (ActionArray[i] == action)
 		{
+			action_index->Remove(GetIndexName(action->GetName(), false), action);
 			delete ActionArray[i];
 			ActionArray.erase(ActionArray.begin() + i);
 			i--;
@@ -2358,46 +2658,75 @@ Object* SBS::GetObject(std::string name, bool case_sensitive)
 		}
 	}
 
-	for (size_t i = 0; i < ObjectArray.size(); i++)
+	//look up candidates in the name index, using the full name and each part after a ':'
+	//separator as the object's own name, for the "parentname:objectname" forms
+	std::string key = name;
+	if (case_sensitive == true)
+		SetCase(key, false);
+
+	Object *result = 0;
+	size_t pos = 0;
+	while (pos != std::string::npos)
 	{
-		if (ObjectArray[i])
+		const std::vector<Object*> *list = object_index->Find(key.substr(pos));
+		if (list)
 		{
-			std::string tmpname = ObjectArray[i]->GetName();
-			ReplaceAll(tmpname, " ", "");
-			if (case_sensitive == false)
-				SetCase(tmpname, false);
+			for (size_t i = 0; i < list->size(); i++)
+			{
+				//return the first matching object in registration order
+				Object *object = list->at(i);
+				if ((!result || object->GetNumber() < result->GetNumber()) && MatchObjectName(object, name, case_sensitive) == true)
+					result = object;
+			}
+		}
 
-			//get by object name
-			if (tmpname == name)
-				return ObjectArray[i];
+		pos = key.find(":", pos);
+		if (pos != std::string::npos)
+			pos++;
+	}
 
-			if (ObjectArray[i]->GetParent())
-			{
-				std::string parent_name = ObjectArray[i]->GetParent()->GetName();
-				ReplaceAll(parent_name, " ", "");
-				if (case_sensitive == false)
-					SetCase(parent_name, false);
+	return result;
+}
 
-				//get by "parentname:objectname"
-				if (name == parent_name + ":" + tmpname)
-					return ObjectArray[i];
+bool SBS::MatchObjectName(Object *object, const std::string &name, bool case_sensitive)
+{
+	//check if an object matches a name, a "parentname:objectname" or a "grandparentname:parentname:objectname" string
+	//name must have spaces removed, and be lowercase if not case sensitive
 
-				if (ObjectArray[i]->GetParent()->GetParent())
-				{
-					std::string grandparent_name = ObjectArray[i]->GetParent()->GetParent()->GetName();
-					ReplaceAll(grandparent_name, " ", "");
-					if (case_sensitive == false)
-						SetCase(grandparent_name, false);
+	std::string tmpname = object->GetName();
+	ReplaceAll(tmpname, " ", "");
+	if (case_sensitive == false)
+		SetCase(tmpname, false);
 
-					//get by "grandparentname:parentname:objectname"
-					if (name == grandparent_name + ":" + parent_name + ":" + tmpname)
-						return ObjectArray[i];
-				}
-			}
+	//get by object name
+	if (tmpname == name)
+		return true;
+
+	if (object->GetParent())
+	{
+		std::string parent_name = object->GetParent()->GetName();
+		ReplaceAll(parent_name, " ", "");
+		if (case_sensitive == false)
+			SetCase(parent_name, false);
+
+		//get by "parentname:objectname"
+		if (name == parent_name + ":" + tmpname)
+			return true;
+
+		if (object->GetParent()->GetParent())
+		{
+			std::string grandparent_name = object->GetParent()->GetParent()->GetName();
+			ReplaceAll(grandparent_name, " ", "");
+			if (case_sensitive == false)
+				SetCase(grandparent_name, false);
+
+			//get by "grandparentname:parentname:objectname"
+			if (name == grandparent_name + ":" + parent_name + ":" + tmpname)
+				return true;
 		}
 	}
 
-	return 0;
+	return false;
 }
 
 Object* SBS::GetObjectOfParent(std::string parent_name, std::string name, const std::string &type, bool case_sensitive)
@@ -2460,18 +2789,30 @@ std::vector<Object*> SBS::GetObjectRange(const std::string &expression)
 	if (temp == temp2)
 		temp = 0;
 
-	std::string type;
+	std::string type, prefix;
 
 	if (temp > 0 && temp != std::string::npos)
 	{
 		if (expression.substr(0, 6) == "Floors")
+		{
 			type = "floor";
+			prefix = "Floor ";
+		}
 		else if (expression.substr(0, 9) == "Elevators")
+		{
 			type = "elevator";
+			prefix = "Elevator ";
+		}
 		else if (expression.substr(0, 6) == "Shafts")
+		{
 			type = "shaft";
+			prefix = "Shaft ";
+		}
 		else if (expression.substr(0, 10) == "Stairwells")
+		{
 			type = "stairwell";
+			prefix = "Stairwell ";
+		}
 		else
 		{
 			ReportError("GetObjectRange: Invalid object type");
@@ -2489,37 +2830,23 @@ std::vector<Object*> SBS::GetObjectRange(const std::string &expression)
 			return objects;
 		}
 
-		for (size_t i = 0; i < ObjectArray.size(); i++)
+		for (int i = RangeL; i <= RangeH; i++)
 		{
-			if (ObjectArray[i])
+			//find objects with the exact name through the name index
+			std::string objname = prefix + ToString(i);
+			const std::vector<Object*> *list = object_index->Find(GetIndexName(objname, true));
+			if (!list)
+				continue;
+
+			for (size_t j = 0; j < list->size(); j++)
 			{
-				std::string tmpname = ObjectArray[i]->GetName();
-				for (int j = RangeL; j <= RangeH; j++)
-				{
-					std::string number = ToString(j);
-					if (type == "floor")
-					{
-						if (tmpname == "Floor " + number)
-							objects.emplace_back(ObjectArray[i]);
-					}
-					if (type == "elevator")
-					{
-						if (tmpname == "Elevator " + number)
-							objects.emplace_back(ObjectArray[i]);
-					}
-					if (type == "shaft")
-					{
-						if (tmpname == "Shaft " + number)
-							objects.emplace_back(ObjectArray[i]);
-					}
-					if (type == "stairwell")
-					{
-						if (tmpname == "Stairwell " + number)
-							objects.emplace_back(ObjectArray[i]);
-					}
-				}
+				if (list->at(j)->GetName() == objname)
+					objects.emplace_back(list->at(j));
 			}
 		}
+
+		//return objects in registration order
+		std::sort(objects.begin(), objects.end(), [](Object *a, Object *b) { return a->GetNumber() < b->GetNumber(); });
 	}
 	else
 	{
@@ -2709,6 +3036,16 @@ void SBS::EnableRandomActivity(bool value)
 
 	if (value == true)
 	{
+		//if crowd agents are specified, use the crowd simulation instead of person objects
+		int agents = GetConfigInt("Skyscraper.SBS.Crowd.Agents", 0);
+		if (agents > 0)
+		{
+			crowd->AddAgents(agents, Lobby, false);
+			crowd->AddAgents(1, Lobby, true); //service agent
+			RandomActivity = value;
+			return;
+		}
+
 		//create regular people
 		int people = GetConfigInt("Skyscraper.SBS.Person.RandomPeople", 0);
 		people = people == 0 ? GetTotalFloors() : people;
@@ -2728,6 +3065,8 @@ void SBS::EnableRandomActivity(bool value)
 	}
 	else
 	{
+		crowd->Clear();
+
 		for (size_t i = 0; i < PersonArray.size(); i++)
 		{
 			if (PersonArray[i]->IsRandomActivityEnabled() == true)
@@ -3147,6 +3486,11 @@ ControllerManager* SBS::GetControllerManager()
 	return controller_manager;
 }
 
+Crowd* SBS::GetCrowd()
+{
+	return crowd;
+}
+
 TeleporterManager* SBS::GetTeleporterManager()
 {
 	return teleporter_manager;
@@ -3183,6 +3527,71 @@ Utility* SBS::GetUtility()
 	return utility;
 }
 
+RouteGraph* SBS::GetRouteGraph()
+{
+	return route_graph;
+}
+
+SpatialGrid* SBS::GetTriggerGrid()
+{
+	return trigger_grid;
+}
+
+void SBS::QueryTriggers()
+{
+	//mark the trigger volumes in the camera's grid cell, which are the only triggers
+	//that are tested for entry during this frame
+
+	SBS_PROFILE("SBS::QueryTriggers");
+
+	trigger_query++;
+	trigger_check.clear();
+	trigger_grid->Query(camera->GetPosition(), trigger_check);
+
+	for (size_t i = 0; i < trigger_check.size(); i++)
+	{
+		int id = trigger_check[i];
+		if (id >= (int)trigger_nearby.size())
+			trigger_nearby.resize(id + 1, 0);
+		trigger_nearby[id] = trigger_query;
+	}
+}
+
+bool SBS::IsTriggerNearby(int grid_id)
+{
+	//returns true if the specified trigger volume was in the camera's grid cell in the last query
+
+	if (grid_id < 0 || grid_id >= (int)trigger_nearby.size())
+		return false;
+
+	return (trigger_nearby[grid_id] == trigger_query);
+}
+
+GeometrySnapshot* SBS::GetGeometrySnapshot()
+{
+	//returns the geometry snapshot while a building is loading
+
+	if (geometry_snapshot && geometry_snapshot->IsOpen() == true)
+		return geometry_snapshot;
+	return 0;
+}
+
+ColliderCache* SBS::GetColliderCache()
+{
+	return collider_cache;
+}
+
+void SBS::OpenGeometrySnapshot(const std::string &source, uint64_t source_hash)
+{
+	//start the geometry snapshot for this building, from the main building file
+
+	if (!geometry_snapshot)
+		return;
+
+	std::string name = std::filesystem::path(BuildingFilename).filename().string();
+	geometry_snapshot->Open("cache/" + name + ".geometry", source, source_hash);
+}
+
 GeometryController* SBS::GetGeometry()
 {
 	return geometry;
@@ -3194,15 +3603,34 @@ void SBS::MemoryReport()
 	Report("");
 	Report("--- Memory Report ---");
 
-	size_t total = 0;
+	MeshObject::MemoryUsage usage;
 	for (size_t i = 0; i < meshes.size(); i++)
-		total += meshes[i]->GetSize();
+		meshes[i]->GetMemoryUsage(usage);
+
+	size_t total = (meshes.size() * sizeof(MeshObject)) + usage.geometry + usage.pick + usage.bvh;
 
 	//texture memory
 	Report("Textures: " + ToString(texturemanager->GetMemoryUsage() / 1024) + " kb");
 
 	//mesh memory
 	Report("Meshes: " + ToString(total / 1024) + " kb");
+	Report("  " + ToString((int)meshes.size()) + " meshes, " + ToString((int)usage.walls) + " walls, " + ToString((int)usage.polygons) + " polygons, " + ToString((int)usage.vertices) + " vertices, " + ToString((int)usage.triangles) + " triangles");
+	Report("  Geometry: " + ToString(usage.geometry / 1024) + " kb");
+	Report("  Pick buffers: " + ToString(usage.pick / 1024) + " kb");
+	Report("  Pick hierarchies: " + ToString(usage.bvh / 1024) + " kb");
+
+	//paged floors
+	Report("Evicted floors: " + ToString(floor_manager->GetEvictedCount()) + " of " + ToString(floor_manager->GetCount()));
+
+	//crowd simulation
+	if (crowd->GetAgentCount() > 0)
+		Report("Crowd: " + ToString(crowd->GetAgentCount()) + " agents, " + ToString(crowd->GetMemoryUsage() / 1024) + " kb");
+
+	//file lookups
+	size_t lookups, hits, indexed;
+	GetUtility()->GetFileStats(lookups, hits, indexed);
+	int rate = (lookups > 0) ? int(hits * 100 / lookups) : 0;
+	Report("File lookups: " + ToString((int)lookups) + ", " + ToString(rate) + "% cached, " + ToString((int)indexed) + " files indexed");
 
 	Report("");
 }
@@ -26,6 +26,7 @@
 
 #include <deque>
 #include <queue>
+#include <unordered_map>
 #include "OgrePrerequisites.h"
 #include "OgreSharedPtr.h"
 
@@ -42,6 +43,7 @@ namespace OgreBulletDynamics {
 namespace OgreBulletCollisions {
 	class DebugDrawer;
 	class CollisionShape;
+	class TriangleMeshCollisionShape;
 }
 
 namespace Ogre {
@@ -91,12 +93,14 @@ namespace SBS {
 	class Escalator;
 	class Action;
 	class Person;
+	class Crowd;
 	class ButtonPanel;
 	class DirectionalIndicator;
 	class FloorIndicator;
 	class CameraTexture;
 	class Light;
 	struct ElevatorRoute;
+	struct TextureAtlas;
 	class SceneNode;
 	class TimerObject;
 	class RandomGen;
@@ -105,16 +109,25 @@ namespace SBS {
 	class Step;
 	class Vehicle;
 	class DispatchController;
+	class DispatchPolicy;
 	class ControllerManager;
 	class CallStation;
 	class Indicator;
 	class PolyMesh;
+	class TriangleBVH;
+	class GeometryPool;
+	class ColliderCache;
+	class GeometrySnapshot;
 	class Utility;
 	class GeometryController;
 	class CustomObject;
 	class Reverb;
 	class Map;
 	class RouteController;
+	class RouteGraph;
+	class SpatialGrid;
+	class ThreadPool;
+	template <typename T> class NameIndex;
 	class ObjectScript;
 	class Texture;
 	class TextureImage;
@@ -139,6 +152,7 @@ class SBSIMPEXP SBS : public Object
 public:
 
 	Real delta;
+	Real FixedStep; //if greater than 0, advance the clock by this many seconds per frame, instead of by real time
 
 	//OGRE objects
 	Ogre::Root* mRoot;
@@ -235,6 +249,8 @@ public:
 	void EnableFloorRange(int floor, int range, bool value, bool enablegroups, int shaftnumber = 0, int stairsnumber = 0);
 	bool RegisterTimerCallback(TimerObject *timer);
 	bool UnregisterTimerCallback(TimerObject *timer);
+	bool ScheduleTimer(TimerObject *timer, unsigned long due);
+	bool IsTimerScheduled(TimerObject *timer);
 	void ProcessTimers();
 	int GetTimerCallbackCount();
 	void AddFloorAutoArea(Vector3 start, Vector3 end);
@@ -260,6 +276,7 @@ public:
 	std::vector<Object*> GetObjectRange(const std::string &expression);
 	int RegisterObject(Object *object);
 	bool UnregisterObject(int number);
+	void RenameObject(Object *object, const std::string &old_name);
 	bool IsValidFloor(int floor);
 	std::string DumpState();
 	bool DeleteObject(Object *object);
@@ -335,7 +352,13 @@ public:
 	SoundSystem* GetSoundSystem();
 	bool IsObjectValid(Object* object, const std::string &type = "");
 	bool IsActionValid(Action* action);
-	std::vector<ElevatorRoute*> GetRouteToFloor(int StartingFloor, int DestinationFloor, bool service_access = false);
+	std::vector<ElevatorRoute> GetRouteToFloor(int StartingFloor, int DestinationFloor, bool service_access = false);
+	RouteGraph* GetRouteGraph();
+	SpatialGrid* GetTriggerGrid();
+	bool IsTriggerNearby(int grid_id);
+	GeometrySnapshot* GetGeometrySnapshot();
+	ColliderCache* GetColliderCache();
+	void OpenGeometrySnapshot(const std::string &source, uint64_t source_hash);
 	Person* CreatePerson(std::string name = "", int floor = 0, bool service_access = false);
 	void RemovePerson(Person *person);
 	bool AttachCamera(std::vector<Ogre::Camera*> &cameras, bool init_state = true);
@@ -361,6 +384,7 @@ public:
 	DoorManager* GetDoorManager();
 	ControllerManager* GetControllerManager();
 	TeleporterManager* GetTeleporterManager();
+	Crowd* GetCrowd();
 	void RegisterDynamicMesh(DynamicMesh *dynmesh);
 	void UnregisterDynamicMesh(DynamicMesh *dynmesh);
 	TextureManager* GetTextureManager();
@@ -414,10 +438,16 @@ private:
 	int fps_frame_count;
 	int fps_tottime;
 	Real remaining_delta;
+	unsigned long fixed_time; //clock value used when FixedStep is set
 
 	//global object array (only pointers to actual objects)
 	std::vector<Object*> ObjectArray;
 
+	//name indexes, for object, mesh and action lookups
+	NameIndex<Object> *object_index; //keyed by lowercase name without spaces
+	NameIndex<MeshObject> *mesh_index; //keyed by mesh name
+	NameIndex<Action> *action_index; //keyed by name without spaces
+
 	//manager objects
 	FloorManager* floor_manager;
 	ElevatorManager* elevator_manager;
@@ -428,6 +458,9 @@ private:
 	ControllerManager* controller_manager;
 	TeleporterManager* teleporter_manager;
 
+	//crowd simulation
+	Crowd* crowd;
+
 	//dynamic meshes
 	std::vector<DynamicMesh*> dynamic_meshes;
 
@@ -446,13 +479,31 @@ private:
 	//private functions
 	void PrintBanner();
 	void CheckAutoAreas();
+	void QueryTriggers();
 	void CalculateAverageTime();
-	std::vector<ElevatorRoute*> GetIndirectRoute(std::vector<int> &checked_floors, int StartingFloor, int DestinationFloor, bool service_access = false, bool top_level = true);
-	ElevatorRoute* GetDirectRoute(Floor *floor, int DestinationFloor, bool service_access = false);
 	void GenerateBounds(Vector3 &min, Vector3 &max);
+	std::string GetIndexName(const std::string &name, bool lowercase);
+	bool MatchObjectName(Object *object, const std::string &name, bool case_sensitive);
 
-	//timer callback array
-	std::vector<TimerObject*> timercallbacks;
+	//timer scheduler, a min-heap of notification times
+	//entries are skipped when their timer has been stopped or rescheduled since
+	struct TimerEntry
+	{
+		unsigned long due; //time of next notification
+		unsigned long long sequence; //schedule order, to keep timers due at the same time in a fixed order
+		TimerObject *timer;
+
+		bool operator>(const TimerEntry &other) const
+		{
+			if (due != other.due)
+				return due > other.due;
+			return sequence > other.sequence;
+		}
+	};
+	std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<TimerEntry> > timer_queue;
+	std::unordered_map<TimerObject*, TimerEntry> timercallbacks; //registered timers, with their current schedule (sequence 0 if none)
+	std::vector<TimerObject*> expired_timers;
+	unsigned long long timer_sequence;
 
 	//auto area structure
 	struct AutoArea
@@ -465,6 +516,8 @@ private:
 
 	//floor auto area array
 	std::vector<AutoArea> FloorAutoArea;
+	std::vector<int> autoarea_check; //areas to check on this step
+	std::vector<int> autoarea_inside; //areas the camera is inside of
 
 	//global lights
 	std::vector<Light*> lights;
@@ -555,6 +608,23 @@ private:
 	//geometry processor
 	PolyMesh* polymesh;
 
+	//elevator route graph
+	RouteGraph* route_graph;
+
+	//spatial indexes of trigger volumes and floor auto areas
+	SpatialGrid* trigger_grid;
+	SpatialGrid* area_grid;
+	std::vector<int> trigger_check; //trigger volume query results, reused between frames
+	std::vector<unsigned int> trigger_nearby; //query number of the last query that found each trigger volume
+	unsigned int trigger_query; //current trigger query number
+
+	//baked triangle collider cache, or null if disabled
+	ColliderCache* collider_cache;
+	bool collider_cache_loaded;
+
+	//polygon geometry snapshot used while loading, or null if disabled
+	GeometrySnapshot* geometry_snapshot;
+
 	//building power state
 	bool power_state;
 
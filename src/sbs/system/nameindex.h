@@ -0,0 +1,215 @@
+/*
+	Scalable Building Simulator - Name Index
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_NAMEINDEX_H
+#define _SBS_NAMEINDEX_H
+
+#include <functional>
+
+namespace SBS {
+
+//open-addressing hash index from a name key to the values registered under it
+//values with the same key are stored together, in the order they were added
+template <typename T>
+class NameIndex
+{
+public:
+
+	NameIndex()
+	{
+		count = 0;
+		deleted = 0;
+	}
+
+	void Add(const std::string &key, T *value)
+	{
+		//add a value under the specified key
+
+		if (!value)
+			return;
+
+		//grow table if over 75% full, including deleted slots
+		if ((count + deleted + 1) * 4 > slots.size() * 3)
+			Resize();
+
+		size_t hash = std::hash<std::string>()(key);
+		Slot &slot = slots[FindSlot(key, hash)];
+
+		if (slot.state != Used)
+		{
+			if (slot.state == Deleted)
+				deleted--;
+			slot.state = Used;
+			slot.key = key;
+			slot.hash = hash;
+			count++;
+		}
+		slot.values.emplace_back(value);
+	}
+
+	bool Remove(const std::string &key, T *value)
+	{
+		//remove a value from the specified key
+
+		Slot *slot = Get(key);
+		if (!slot)
+			return false;
+
+		for (size_t i = 0; i < slot->values.size(); i++)
+		{
+			if (slot->values[i] == value)
+			{
+				slot->values.erase(slot->values.begin() + i);
+
+				//mark slot as deleted if no values remain
+				if (slot->values.empty())
+				{
+					slot->state = Deleted;
+					slot->key.clear();
+					count--;
+					deleted++;
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const std::vector<T*>* Find(const std::string &key)
+	{
+		//get values registered under the specified key, or 0 if none
+
+		Slot *slot = Get(key);
+		if (slot)
+			return &slot->values;
+		return 0;
+	}
+
+	void Clear()
+	{
+		slots.clear();
+		count = 0;
+		deleted = 0;
+	}
+
+	size_t GetCount() { return count; } //number of keys
+
+private:
+
+	enum SlotState
+	{
+		Empty,
+		Used,
+		Deleted
+	};
+
+	struct Slot
+	{
+		Slot() { state = Empty; hash = 0; }
+		SlotState state;
+		size_t hash;
+		std::string key;
+		std::vector<T*> values;
+	};
+
+	size_t FindSlot(const std::string &key, size_t hash)
+	{
+		//find the slot holding a key, or the slot to insert it into, using linear probing
+
+		size_t mask = slots.size() - 1;
+		size_t index = hash & mask;
+		size_t insert = slots.size();
+
+		while (true)
+		{
+			Slot &slot = slots[index];
+
+			if (slot.state == Empty)
+				return (insert < slots.size()) ? insert : index;
+			if (slot.state == Deleted)
+			{
+				if (insert == slots.size())
+					insert = index;
+			}
+			else if (slot.hash == hash && slot.key == key)
+				return index;
+
+			index = (index + 1) & mask;
+		}
+	}
+
+	Slot* Get(const std::string &key)
+	{
+		//get the slot holding a key
+
+		if (count == 0)
+			return 0;
+
+		size_t hash = std::hash<std::string>()(key);
+		size_t mask = slots.size() - 1;
+		size_t index = hash & mask;
+
+		while (slots[index].state != Empty)
+		{
+			Slot &slot = slots[index];
+			if (slot.state == Used && slot.hash == hash && slot.key == key)
+				return &slot;
+			index = (index + 1) & mask;
+		}
+		return 0;
+	}
+
+	void Resize()
+	{
+		//rebuild table with room for twice the number of keys, dropping deleted slots
+
+		size_t size = 16;
+		while (size * 3 < (count + 1) * 2 * 4)
+			size *= 2;
+
+		std::vector<Slot> old;
+		old.swap(slots);
+		slots.resize(size);
+		deleted = 0;
+
+		for (size_t i = 0; i < old.size(); i++)
+		{
+			if (old[i].state != Used)
+				continue;
+
+			Slot &slot = slots[FindSlot(old[i].key, old[i].hash)];
+			slot.state = Used;
+			slot.hash = old[i].hash;
+			slot.key.swap(old[i].key);
+			slot.values.swap(old[i].values);
+		}
+	}
+
+	std::vector<Slot> slots; //hash table, size is a power of two
+	size_t count; //number of used slots
+	size_t deleted; //number of deleted slots
+};
+
+}
+
+#endif
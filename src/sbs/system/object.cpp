@@ -153,7 +153,7 @@ void Object::SetValues(const std::string &type, const std::string &name, bool is
 	values_set = true;
 	Permanent = is_permanent;
 	Type = type;
-	Name = name;
+	SetName(name);
 
 	//create scene node object
 	if (is_movable == true)
@@ -164,6 +164,17 @@ void Object::SetValues(const std::string &type, const std::string &name, bool is
 		Parent->AddChild(this);
 }
 
+void Object::SetName(const std::string &name)
+{
+	//set object name, and update the engine's name index
+
+	std::string old_name = GetName();
+	ObjectBase::SetName(name);
+
+	if (sbs)
+		sbs->RenameObject(this, old_name);
+}
+
 bool Object::IsPermanent()
 {
 	//return permanent state
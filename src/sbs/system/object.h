@@ -38,7 +38,7 @@ public:
 	virtual ~ObjectBase() {};
 	Object* GetParent();
 	SBS* GetRoot();
-	void SetName(const std::string &name);
+	virtual void SetName(const std::string &name);
 	const std::string& GetName();
 	std::string GetNameBase();
 	virtual void Report(const std::string &message);
@@ -67,6 +67,7 @@ public:
 	explicit Object(Object *parent);
 	virtual ~Object();
 	void SetValues(const std::string &type, const std::string &name, bool is_permanent, bool is_movable = true);
+	void SetName(const std::string &name);
 	bool IsPermanent();
 	bool IsMovable();
 	const std::string& GetType();
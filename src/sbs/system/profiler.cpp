@@ -1,8 +1,15 @@
 #include <OgreBulletDynamicsWorld.h>
 #include <OgrePlatform.h>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
 #include "globals.h"
 #include "sbs.h"
 #include "profiler.h"
+#include "threadpool.h"
 
 static oClock gProfileClock;
 
@@ -228,7 +235,8 @@ unsigned long int			ProfileManager::ResetTime = 0;
  *=============================================================================================*/
 void	ProfileManager::Start_Profile( const char * name )
 {
-	if (enable_profiling == false)
+	//the profile tree is not thread-safe, so only profile the main thread
+	if (enable_profiling == false || ThreadPool::IsMainThread() == false)
 		return;
 
 	if (name != CurrentNode->Get_Name()) {
@@ -244,7 +252,7 @@ void	ProfileManager::Start_Profile( const char * name )
  *=============================================================================================*/
 void	ProfileManager::Stop_Profile( void )
 {
-	if (enable_profiling == false)
+	if (enable_profiling == false || ThreadPool::IsMainThread() == false)
 		return;
 
 	// Return will indicate whether we should back up to our parent (we may
@@ -364,16 +372,449 @@ void ProfileManager::dumpAll(std::string &output)
 	ProfileManager::Release_Iterator(profileIterator);
 }
 
-ProfileSample::ProfileSample( const char * name, bool advanced )
+/***************************************************************************************************
+**
+** ProfileTrace
+**
+***************************************************************************************************/
+
+struct TraceEvent
+{
+	uint64_t time; //nanoseconds since tracing started
+	uint32_t zone; //zone ID
+	uint32_t end; //0 for zone begin, 1 for zone end
+};
+
+struct TraceRing
+{
+	static const uint32_t Size = 16384; //events per ring, a power of two
+
+	TraceEvent events[Size];
+	std::atomic<uint32_t> head; //next write position, only written by the owning thread
+	std::atomic<uint32_t> tail; //next read position, only written by End_Frame
+	std::atomic<uint32_t> dropped; //events dropped because the ring was full
+	std::atomic<bool> in_use; //false once the owning thread has exited
+	int thread; //trace thread number
+	bool main_thread;
+	std::vector<TraceEvent> open; //zones begun but not ended yet, only used by End_Frame
+};
+
+struct TraceZone
+{
+	static const size_t History = 600; //frames of history kept for percentiles
+
+	const char *name;
+	std::vector<float> history; //per-frame zone time in ms
+	size_t position; //next history slot
+	double frame_time; //zone time in the current frame, in ms
+	int frame_calls; //calls in the current frame
+	int64_t total_calls;
+	bool active; //true once the zone has been called
+};
+
+struct TraceCapture
+{
+	uint64_t start;
+	uint64_t duration;
+	uint32_t zone;
+	int thread;
+};
+
+static const size_t CaptureSize = 262144; //completed zones kept for trace export
+
+static std::mutex trace_mutex; //guards zone registration and the ring list
+static std::vector<const char*> trace_names; //zone names by ID
+static std::vector<TraceRing*> trace_rings;
+
+struct TraceRingOwner
+{
+	//releases a thread's ring for reuse when the thread exits
+
+	TraceRing *ring = 0;
+
+	~TraceRingOwner()
+	{
+		if (ring)
+			ring->in_use.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local TraceRingOwner trace_owner;
+static const std::chrono::steady_clock::time_point trace_start = std::chrono::steady_clock::now();
+
+//aggregated data, only used from End_Frame and the reporting functions on the main thread
+static std::vector<TraceZone> trace_zones;
+static std::vector<TraceCapture> trace_capture;
+static size_t capture_position = 0;
+static uint64_t last_frame = 0;
+static unsigned int frame_zone = 0;
+static uint32_t dropped_events = 0;
+
+static inline uint64_t Trace_Get_Time()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace_start).count();
+}
+
+static TraceRing* Trace_Get_Ring()
+{
+	//get this thread's ring buffer on first use
+	//rings of exited threads are reused, since thread pools are created for each building load
+
+	if (trace_owner.ring)
+		return trace_owner.ring;
+
+	std::lock_guard<std::mutex> lock(trace_mutex);
+
+	TraceRing *ring = 0;
+	for (size_t i = 0; i < trace_rings.size(); i++)
+	{
+		if (trace_rings[i]->in_use.load(std::memory_order_acquire) == false)
+		{
+			ring = trace_rings[i];
+			break;
+		}
+	}
+
+	if (!ring)
+	{
+		ring = new TraceRing();
+		ring->head = 0;
+		ring->tail = 0;
+		ring->dropped = 0;
+		ring->thread = (int)trace_rings.size();
+		trace_rings.emplace_back(ring);
+	}
+
+	ring->in_use = true;
+	ring->main_thread = ThreadPool::IsMainThread();
+	trace_owner.ring = ring;
+	return ring;
+}
+
+static inline bool Trace_Record(uint32_t zone, uint32_t end)
+{
+	//write an event to this thread's ring, without locking
+	//if the ring is full, the event is dropped
+
+	TraceRing *ring = Trace_Get_Ring();
+
+	uint32_t head = ring->head.load(std::memory_order_relaxed);
+	if (head - ring->tail.load(std::memory_order_acquire) >= TraceRing::Size)
+	{
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	TraceEvent &event = ring->events[head & (TraceRing::Size - 1)];
+	event.time = Trace_Get_Time();
+	event.zone = zone;
+	event.end = end;
+
+	ring->head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+static void Trace_Add_Time(unsigned int zone, uint64_t start, uint64_t duration, int thread)
+{
+	//add a completed zone to the frame totals and the capture buffer
+
+	if (zone >= trace_zones.size())
+		return;
+
+	TraceZone &stats = trace_zones[zone];
+	stats.frame_time += (double)duration / 1000000.0;
+	stats.frame_calls++;
+	stats.active = true;
+
+	TraceCapture capture;
+	capture.start = start;
+	capture.duration = duration;
+	capture.zone = zone;
+	capture.thread = thread;
+
+	if (trace_capture.size() < CaptureSize)
+		trace_capture.emplace_back(capture);
+	else
+		trace_capture[capture_position] = capture;
+	capture_position = (capture_position + 1) % CaptureSize;
+}
+
+static float Trace_Percentile(std::vector<float> &values, Real percentile)
+{
+	//return a percentile of the given values, reordering them
+
+	if (values.empty())
+		return 0;
+
+	size_t index = (size_t)(percentile * (values.size() - 1) + 0.5);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+ProfileZone::ProfileZone( const char * name )
+{
+	Name = name;
+	ID = ProfileTrace::Register_Zone(name);
+}
+
+unsigned int ProfileTrace::Register_Zone( const char * name )
+{
+	//return the ID of a named zone, registering it if new
+	//zones with the same name share an ID, so their times are combined
+
+	std::lock_guard<std::mutex> lock(trace_mutex);
+
+	for (size_t i = 0; i < trace_names.size(); i++)
+	{
+		if (strcmp(trace_names[i], name) == 0)
+			return (unsigned int)i;
+	}
+
+	trace_names.emplace_back(name);
+	return (unsigned int)trace_names.size() - 1;
+}
+
+bool ProfileTrace::Begin( unsigned int zone )
+{
+	if (enable_profiling == false)
+		return false;
+
+	return Trace_Record(zone, 0);
+}
+
+void ProfileTrace::End( unsigned int zone )
+{
+	Trace_Record(zone, 1);
+}
+
+void ProfileTrace::End_Frame( void )
+{
+	//collect events from all thread rings, and store the zone times of the finished frame
+	//this must be called once per frame from the main thread
+
+	if (enable_profiling == false)
+	{
+		last_frame = 0;
+		return;
+	}
+
+	if (last_frame == 0)
+		frame_zone = Register_Zone("Frame");
+
+	uint64_t now = Trace_Get_Time();
+
+	std::lock_guard<std::mutex> lock(trace_mutex);
+
+	//add new zones
+	while (trace_zones.size() < trace_names.size())
+	{
+		TraceZone stats;
+		stats.name = trace_names[trace_zones.size()];
+		stats.position = 0;
+		stats.frame_time = 0;
+		stats.frame_calls = 0;
+		stats.total_calls = 0;
+		stats.active = false;
+		trace_zones.emplace_back(stats);
+	}
+
+	//match begin and end events in each ring
+	for (size_t i = 0; i < trace_rings.size(); i++)
+	{
+		TraceRing *ring = trace_rings[i];
+
+		uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+		uint32_t head = ring->head.load(std::memory_order_acquire);
+
+		for (; tail != head; tail++)
+		{
+			const TraceEvent &event = ring->events[tail & (TraceRing::Size - 1)];
+
+			if (event.end == 0)
+			{
+				ring->open.emplace_back(event);
+				continue;
+			}
+
+			//discard begin events whose end was dropped
+			while (ring->open.empty() == false && ring->open.back().zone != event.zone)
+				ring->open.pop_back();
+
+			if (ring->open.empty() == true)
+				continue;
+
+			TraceEvent begin = ring->open.back();
+			ring->open.pop_back();
+
+			Trace_Add_Time(event.zone, begin.time, event.time - begin.time, ring->thread);
+		}
+
+		ring->tail.store(tail, std::memory_order_release);
+		dropped_events += ring->dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	//add the frame itself
+	if (last_frame > 0)
+		Trace_Add_Time(frame_zone, last_frame, now - last_frame, 0);
+	last_frame = now;
+
+	//store this frame's time for each zone
+	for (size_t i = 0; i < trace_zones.size(); i++)
+	{
+		TraceZone &stats = trace_zones[i];
+
+		if (stats.active == false)
+			continue;
+
+		if (stats.history.size() < TraceZone::History)
+			stats.history.emplace_back((float)stats.frame_time);
+		else
+			stats.history[stats.position] = (float)stats.frame_time;
+		stats.position = (stats.position + 1) % TraceZone::History;
+
+		stats.total_calls += stats.frame_calls;
+		stats.frame_time = 0;
+		stats.frame_calls = 0;
+	}
+}
+
+void ProfileTrace::Get_Summary( std::string &output )
+{
+	//print frame time percentiles for each zone, slowest first
+
+	struct Row
+	{
+		const char *name;
+		float p50, p95, p99, max;
+		Real calls;
+	};
+
+	std::vector<Row> rows;
+	std::vector<float> values;
+
+	for (size_t i = 0; i < trace_zones.size(); i++)
+	{
+		TraceZone &stats = trace_zones[i];
+
+		if (stats.active == false || stats.history.empty() == true)
+			continue;
+
+		values = stats.history;
+
+		Row row;
+		row.name = stats.name;
+		row.p50 = Trace_Percentile(values, 0.50);
+		row.p95 = Trace_Percentile(values, 0.95);
+		row.p99 = Trace_Percentile(values, 0.99);
+		row.max = *std::max_element(values.begin(), values.end());
+		row.calls = (Real)stats.total_calls;
+		rows.emplace_back(row);
+	}
+
+	std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.p99 > b.p99; });
+
+	char buffer[1000];
+	_snprintf(buffer, 1000, "---------------------------------- Frame percentiles (ms, %d frames) ---\n", (int)TraceZone::History);
+	output.append(buffer);
+	_snprintf(buffer, 1000, "%-40s %9s %9s %9s %9s %12s\n", "Zone", "p50", "p95", "p99", "max", "calls");
+	output.append(buffer);
+
+	for (size_t i = 0; i < rows.size(); i++)
+	{
+		_snprintf(buffer, 1000, "%-40s %9.3f %9.3f %9.3f %9.3f %12.0f\n", rows[i].name, rows[i].p50, rows[i].p95, rows[i].p99, rows[i].max, (double)rows[i].calls);
+		output.append(buffer);
+	}
+
+	if (dropped_events > 0)
+	{
+		_snprintf(buffer, 1000, "(%u events dropped from full thread buffers)\n", dropped_events);
+		output.append(buffer);
+	}
+}
+
+static void Trace_Write_String(std::ofstream &file, const char *text)
+{
+	//write a JSON string
+
+	file << '"';
+	for (const char *c = text; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			file << '\\';
+		file << *c;
+	}
+	file << '"';
+}
+
+bool ProfileTrace::Export( const std::string &filename )
+{
+	//write captured zones as a Chrome trace event file, for chrome://tracing or Perfetto
+
+	std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+
+	if (file.is_open() == false)
+		return false;
+
+	file << "{\"traceEvents\":[\n";
+
+	bool first = true;
+
+	//thread names
+	{
+		std::lock_guard<std::mutex> lock(trace_mutex);
+
+		for (size_t i = 0; i < trace_rings.size(); i++)
+		{
+			if (first == false)
+				file << ",\n";
+			first = false;
+
+			std::string name = trace_rings[i]->main_thread == true ? "Main" : "Worker " + ToString(trace_rings[i]->thread);
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << trace_rings[i]->thread << ",\"args\":{\"name\":";
+			Trace_Write_String(file, name.c_str());
+			file << "}}";
+		}
+	}
+
+	//completed zones, oldest first
+	size_t start = (trace_capture.size() < CaptureSize) ? 0 : capture_position;
+	char buffer[100];
+
+	for (size_t i = 0; i < trace_capture.size(); i++)
+	{
+		const TraceCapture &capture = trace_capture[(start + i) % trace_capture.size()];
+
+		if (first == false)
+			file << ",\n";
+		first = false;
+
+		file << "{\"name\":";
+		Trace_Write_String(file, trace_zones[capture.zone].name);
+		_snprintf(buffer, 100, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", (double)capture.start / 1000.0, (double)capture.duration / 1000.0);
+		file << buffer << ",\"pid\":0,\"tid\":" << capture.thread << "}";
+	}
+
+	file << "\n]}\n";
+	return file.good();
+}
+
+ProfileSample::ProfileSample( const ProfileZone &zone, bool advanced ) : zone(zone)
 {
 	is_advanced = advanced;
+
+	//trace all zones on any thread, since trace events are cheap
+	is_traced = ProfileTrace::Begin(zone.ID);
+
 	if (is_advanced == true && enable_advanced_profiling == false)
 		return;
-	ProfileManager::Start_Profile( name );
+	ProfileManager::Start_Profile( zone.Name );
 }
 
 ProfileSample::~ProfileSample( void )
 {
+	if (is_traced == true)
+		ProfileTrace::End(zone.ID);
+
 	if (is_advanced == true && enable_advanced_profiling == false)
 		return;
 	ProfileManager::Stop_Profile();
@@ -117,21 +117,46 @@ private:
 };
 
 
+///A named profiling zone, registered once per SBS_PROFILE call site
+class SBSIMPEXP ProfileZone {
+public:
+	explicit ProfileZone( const char * name );
+
+	const char *	Name;
+	unsigned int	ID;
+};
+
+///Event tracer with a lock-free ring buffer per thread
+///Zone begin/end events are recorded from any thread while profiling is enabled, and are collected
+///once per frame into per-zone frame time percentiles and a capture buffer for Chrome trace export
+class SBSIMPEXP ProfileTrace {
+public:
+	static	unsigned int			Register_Zone( const char * name );
+	static	bool					Begin( unsigned int zone );
+	static	void					End( unsigned int zone );
+	static	void					End_Frame( void );
+	static	void					Get_Summary( std::string &output );
+	static	bool					Export( const std::string &filename );
+};
+
 ///ProfileSampleClass is a simple way to profile a function's scope
 ///Use the SBS_PROFILE macro at the start of scope to time
 class SBSIMPEXP ProfileSample {
 public:
-	ProfileSample( const char * name, bool advanced = true );
+	ProfileSample( const ProfileZone &zone, bool advanced = true );
 	~ProfileSample( void );
 private:
+	const ProfileZone &zone;
 	bool is_advanced;
+	bool is_traced;
 };
 
 #ifdef ENABLE_PROFILING
-#define	SBS_PROFILE(name)			ProfileSample __profile(name, true)
-#define	SBS_PROFILE_MAIN(name)			ProfileSample __profile(name, false)
+#define	SBS_PROFILE(name)			static const ProfileZone __profile_zone(name); ProfileSample __profile(__profile_zone, true)
+#define	SBS_PROFILE_MAIN(name)			static const ProfileZone __profile_zone(name); ProfileSample __profile(__profile_zone, false)
 #else
 #define	SBS_PROFILE(name)
+#define	SBS_PROFILE_MAIN(name)
 #endif
 
 }
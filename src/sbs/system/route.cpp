@@ -21,6 +21,8 @@
 	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <algorithm>
+#include <queue>
 #include "globals.h"
 #include "sbs.h"
 #include "floor.h"
@@ -37,19 +39,20 @@ ElevatorRoute::ElevatorRoute(ElevatorCar *car, int floor_selection)
 	this->floor_selection = floor_selection;
 }
 
-std::vector<ElevatorRoute*> SBS::GetRouteToFloor(int StartingFloor, int DestinationFloor, bool service_access)
+std::vector<ElevatorRoute> SBS::GetRouteToFloor(int StartingFloor, int DestinationFloor, bool service_access)
 {
 	//get a path from a starting floor to a desination floor, as a list of elevators to ride
 	//if service_access is true, include service elevators in checks
 
-	//these function prioritize service elevators (if specified) and express elevators over local elevators
+	//routes use the fewest elevator transfers, and prioritize service elevators (if specified)
+	//and express elevators over local elevators
 
 	//for pathfinding to work properly, express and service elevators
 	//need to have their Type parameter set properly.
 
 	SBS_PROFILE("SBS::GetRouteToFloor");
 
-	std::vector<ElevatorRoute*> result;
+	std::vector<ElevatorRoute> result;
 
 	Floor *start_floor = GetFloor(StartingFloor);
 	Floor *dest_floor = GetFloor(DestinationFloor);
@@ -57,221 +60,205 @@ std::vector<ElevatorRoute*> SBS::GetRouteToFloor(int StartingFloor, int Destinat
 	if (!start_floor || !dest_floor || start_floor == dest_floor)
 		return result;
 
-	std::vector<int> checked_floors;
+	route_graph->GetRoute(StartingFloor, DestinationFloor, service_access, result);
+	return result;
+}
 
-	//Direct check
-	//check all express and local elevators if they directly serve destination floor
-	{
-		ElevatorRoute *route = GetDirectRoute(start_floor, DestinationFloor, service_access);
+//edge costs; a transfer always costs more than any difference in elevator types,
+//so that routes with fewer transfers are preferred
+static const int TransferCost = 100;
+static const int ServiceCost = 1;
+static const int ExpressCost = 2;
+static const int LocalCost = 3;
 
-		if (route)
-		{
-			result.emplace_back(route);
-			return result;
-		}
+RouteGraph::RouteGraph(Object *parent) : ObjectBase(parent)
+{
+	floor_offset = 0;
+	valid = false;
+}
 
-		checked_floors.emplace_back(StartingFloor);
-	}
+RouteGraph::~RouteGraph()
+{
 
-	//Indirect check
-	std::vector<ElevatorRoute*> route = GetIndirectRoute(checked_floors, StartingFloor, DestinationFloor, service_access);
+}
 
-	if (route.empty() == false)
-		return route;
+void RouteGraph::Invalidate()
+{
+	//mark the graph for a rebuild on the next route request
 
-	//if indirect check fails, get a list of floors that are connected to the destination floor by
-	//the elevators that serve that floor, and check those floors individually to see if they are accessible
-	std::vector<int> connected = dest_floor->GetDirectFloors(false);
+	valid = false;
+}
+
+int RouteGraph::GetIndex(int floor)
+{
+	//get the graph index of a floor number, or -1 if invalid
 
-	for (size_t i = 0; i < connected.size(); i++)
+	int index = floor + floor_offset;
+	if (index < 0 || index >= (int)boardings.size())
+		return -1;
+	return index;
+}
+
+void RouteGraph::Build()
+{
+	//build the transfer graph from the current elevators, serviced floors and call stations
+
+	SBS_PROFILE("RouteGraph::Build");
+
+	cars.clear();
+	boardings.clear();
+	trees[0].clear();
+	trees[1].clear();
+
+	floor_offset = sbs->Basements;
+	int count = sbs->GetTotalFloors();
+	if (count < 0)
+		count = 0;
+	boardings.resize(count);
+	trees[0].resize(count);
+	trees[1].resize(count);
+
+	for (int i = 1; i <= sbs->GetElevatorCount(); i++)
 	{
-		checked_floors.clear();
-		route = GetIndirectRoute(checked_floors, StartingFloor, connected[i], service_access);
+		Elevator *elev = sbs->GetElevator(i);
+		if (!elev)
+			continue;
+
+		//only service, express and local elevators are used for routing
+		std::string type = SetCaseCopy(elev->Type, false);
+		int cost;
+		if (type == "service")
+			cost = ServiceCost;
+		else if (type == "express")
+			cost = ExpressCost;
+		else if (type == "local")
+			cost = LocalCost;
+		else
+			continue;
 
-		if (route.empty() == false)
+		for (int j = 1; j <= elev->GetCarCount(); j++)
 		{
-			//append direct route
-			Floor *floor = GetFloor(connected[i]);
-			ElevatorRoute *endroute = GetDirectRoute(floor, DestinationFloor, service_access);
+			ElevatorCar *car = elev->GetCar(j);
+			if (!car)
+				continue;
 
-			if (endroute)
-				route.emplace_back(endroute);
-			return route;
-		}
-	}
+			CarEntry entry;
+			entry.car = car;
+			entry.cost = cost;
+			entry.service = (type == "service");
 
-	return route;
-}
+			for (int k = 0; k < car->GetServicedFloorCount(); k++)
+			{
+				int number = car->GetServicedFloor(k);
+				int index = GetIndex(number);
+				Floor *floor = sbs->GetFloor(number);
 
-ElevatorRoute* SBS::GetDirectRoute(Floor *floor, int DestinationFloor, bool service_access)
-{
-	if (!floor)
-		return 0;
+				if (index == -1 || !floor)
+					continue;
 
-	SBS_PROFILE("SBS::GetDirectRoute");
+				entry.floors.emplace_back(number);
 
-	ElevatorRoute *route;
+				//the car can only be boarded on floors with a call station for its elevator
+				if (floor->GetCallStationForElevator(elev->Number))
+					boardings[index].emplace_back(cars.size());
+			}
 
-	if (service_access == true)
-	{
-		route = floor->GetDirectRoute(DestinationFloor, "Service");
-		if (route)
-			return route;
+			cars.emplace_back(entry);
+		}
 	}
 
-	route = floor->GetDirectRoute(DestinationFloor, "Express");
-	if (route)
-		return route;
-
-	route = floor->GetDirectRoute(DestinationFloor, "Local");
-	if (route)
-		return route;
+	valid = true;
 
-	return route;
+	if (sbs->Verbose)
+		Report("Route graph built with " + ToString((int)cars.size()) + " elevator cars");
 }
 
-std::vector<ElevatorRoute*> SBS::GetIndirectRoute(std::vector<int> &checked_floors, int StartingFloor, int DestinationFloor, bool service_access, bool top_level)
+void RouteGraph::Search(int start, bool service_access, SourceTree &tree)
 {
-	//get a route to a destination floor, via elevator serviced floors
+	//find the lowest-cost routes from a starting floor index to all floors (Dijkstra's algorithm)
 
-	//this function will find an indirect route to a floor, while prioritizing service and express elevators
+	SBS_PROFILE("RouteGraph::Search");
 
-	SBS_PROFILE("SBS::GetIndirectRoute");
+	size_t count = boardings.size();
+	tree.cost.assign(count, -1);
+	tree.previous.assign(count, -1);
+	tree.car.assign(count, 0);
 
-	std::vector<ElevatorRoute*> result;
+	typedef std::pair<int, int> QueueEntry; //cost, floor index
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > queue;
 
-	Floor *start_floor = GetFloor(StartingFloor);
+	tree.cost[start] = 0;
+	queue.emplace(0, start);
 
-	if (!start_floor)
-		return result;
+	while (queue.empty() == false)
+	{
+		QueueEntry top = queue.top();
+		queue.pop();
 
-	std::vector<int> list, list_express, list_local;
+		int cost = top.first;
+		int index = top.second;
 
-	//get service elevators
-	if (service_access == true)
-		start_floor->GetElevatorList(list, false, false, true);
+		if (cost > tree.cost[index])
+			continue;
 
-	//get express elevators
-	start_floor->GetElevatorList(list_express, false, true, false);
-	list.insert(list.end(), list_express.begin(), list_express.end());
+		for (size_t i = 0; i < boardings[index].size(); i++)
+		{
+			const CarEntry &entry = cars[boardings[index][i]];
 
-	bool locals_checked = false;
-	bool recurse = false;
+			if (entry.service == true && service_access == false)
+				continue;
 
-	while (true)
-	{
-		for (size_t i = 0; i < list.size(); i++)
-		{
-			Elevator *elev = GetElevator(list[i]);
+			int next_cost = cost + TransferCost + entry.cost;
 
-			if (elev)
+			for (size_t j = 0; j < entry.floors.size(); j++)
 			{
-				ElevatorCar *car = elev->GetCarForFloor(StartingFloor);
+				int next = entry.floors[j] + floor_offset;
 
-				if (car)
+				if (next == index)
+					continue;
+
+				if (tree.cost[next] == -1 || next_cost < tree.cost[next])
 				{
-					//floor list needs to be checked in the direction opposite of the travel direction,
-					//if the checked elevator doesn't go beyond the destination floor
-
-					std::vector<int> floor_list;
-					if ((DestinationFloor > StartingFloor && car->GetTopFloor() < DestinationFloor) ||
-							(DestinationFloor < StartingFloor && car->GetBottomFloor() < DestinationFloor))
-					{
-						for (int j = car->GetServicedFloorCount() - 1; j >= 0; j--)
-						{
-							floor_list.emplace_back(car->GetServicedFloor(j));
-						}
-					}
-					else
-					{
-						for (int j = 0; j < car->GetServicedFloorCount(); j++)
-						{
-							floor_list.emplace_back(car->GetServicedFloor(j));
-						}
-					}
-
-					for (size_t j = 0; j < floor_list.size(); j++)
-					{
-						int number = floor_list[j];
-
-						if (number != StartingFloor)
-						{
-							if (recurse == true)
-							{
-								std::vector<ElevatorRoute*> result2 = GetIndirectRoute(checked_floors, number, DestinationFloor, service_access, false);
-
-								if (result2.empty() == false)
-								{
-									ElevatorRoute *first = new ElevatorRoute(car, number);
-									result.emplace_back(first);
-
-									for (size_t i = 0; i < result2.size(); i++)
-									{
-										result.emplace_back(result2[i]);
-									}
-									return result;
-								}
-							}
-							else
-							{
-								Floor *floor = GetFloor(number);
-
-								//see if this floor has already been checked
-								bool checked = false;
-								for (size_t i = 0; i < checked_floors.size(); i++)
-								{
-									if (checked_floors[i] == number)
-									{
-										checked = true;
-										break;
-									}
-								}
-
-								if (floor && checked == false)
-								{
-									ElevatorRoute *result2 = GetDirectRoute(floor, DestinationFloor, service_access);
-
-									if (result2)
-									{
-										ElevatorRoute *first = new ElevatorRoute(car, number);
-										result.emplace_back(first);
-										result.emplace_back(result2);
-										return result;
-									}
-
-									checked_floors.emplace_back(number);
-								}
-							}
-						}
-					}
+					tree.cost[next] = next_cost;
+					tree.previous[next] = index;
+					tree.car[next] = entry.car;
+					queue.emplace(next_cost, next);
 				}
 			}
 		}
+	}
+}
 
-		if (top_level == false)
-			return result;
-		else
-		{
-			if (locals_checked == true && recurse == true)
-				return result;
+bool RouteGraph::GetRoute(int StartingFloor, int DestinationFloor, bool service_access, std::vector<ElevatorRoute> &route)
+{
+	//get a route between two floors, as a list of elevator cars and the floors to select in them
+	//returns false if no route exists
 
-			//if still going, check local elevators
+	route.clear();
 
-			//get local elevators
-			if (locals_checked == false && recurse == true)
-			{
-				list.clear();
-				start_floor->GetElevatorList(list_local, true, false, false);
-				list.insert(list.end(), list_local.begin(), list_local.end());
-				locals_checked = true;
-				recurse = false;
-			}
-			else if (recurse == false)
-				recurse = true;
-		}
-	}
+	if (valid == false)
+		Build();
 
-	return result;
+	int start = GetIndex(StartingFloor);
+	int dest = GetIndex(DestinationFloor);
+
+	if (start == -1 || dest == -1 || start == dest)
+		return false;
+
+	//search from the starting floor, if not already cached
+	SourceTree &tree = trees[service_access == true ? 1 : 0][start];
+	if (tree.cost.empty() == true)
+		Search(start, service_access, tree);
+
+	if (tree.cost[dest] == -1)
+		return false;
+
+	//walk back from the destination floor
+	for (int index = dest; index != start; index = tree.previous[index])
+		route.emplace_back(tree.car[index], index - floor_offset);
+
+	std::reverse(route.begin(), route.end());
+	return true;
 }
 
 }
@@ -28,12 +28,53 @@ namespace SBS {
 
 struct SBSIMPEXP ElevatorRoute
 {
-	ElevatorRoute(ElevatorCar *car, int floor_selection);
+	ElevatorRoute(ElevatorCar *car = 0, int floor_selection = 0);
 	~ElevatorRoute() {}
 	ElevatorCar *car;
 	int floor_selection;
 };
 
+//floor/elevator car transfer graph, used for finding routes between floors
+class SBSIMPEXP RouteGraph : public ObjectBase
+{
+public:
+
+	explicit RouteGraph(Object *parent);
+	~RouteGraph();
+	void Build();
+	void Invalidate();
+	bool IsValid() { return valid; }
+	bool GetRoute(int StartingFloor, int DestinationFloor, bool service_access, std::vector<ElevatorRoute> &route);
+	size_t GetCarCount() { return cars.size(); }
+
+private:
+
+	struct CarEntry
+	{
+		ElevatorCar *car;
+		int cost; //type cost of riding this car
+		bool service; //true if this is a service elevator
+		std::vector<int> floors; //serviced floors
+	};
+
+	//shortest routes from a starting floor to all other floors
+	struct SourceTree
+	{
+		std::vector<int> cost; //total cost to reach each floor, or -1 if unreachable
+		std::vector<int> previous; //floor index the car was boarded at
+		std::vector<ElevatorCar*> car; //car ridden to reach each floor
+	};
+
+	void Search(int start, bool service_access, SourceTree &tree);
+	int GetIndex(int floor);
+
+	std::vector<CarEntry> cars;
+	std::vector<std::vector<size_t>> boardings; //cars that can be called from each floor
+	std::vector<SourceTree> trees[2]; //cached searches per starting floor, without and with service access
+	int floor_offset; //floor index offset (basement count)
+	bool valid;
+};
+
 }
 
 #endif
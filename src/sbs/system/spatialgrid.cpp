@@ -0,0 +1,291 @@
+/*
+	Scalable Building Simulator - Spatial Grid
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cmath>
+#include "globals.h"
+#include "sbs.h"
+#include "spatialgrid.h"
+
+namespace SBS {
+
+static void RemoveID(std::vector<int> &list, int id)
+{
+	//remove an ID from an unordered list
+
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		if (list[i] == id)
+		{
+			list[i] = list.back();
+			list.pop_back();
+			return;
+		}
+	}
+}
+
+SpatialGrid::SpatialGrid(Object *parent, Real cell_size, bool planar) : ObjectBase(parent)
+{
+	if (cell_size <= 0)
+		cell_size = 10;
+
+	this->cell_size = cell_size;
+	this->planar = planar;
+	count = 0;
+}
+
+SpatialGrid::~SpatialGrid()
+{
+
+}
+
+int SpatialGrid::Add(const Vector3 &min, const Vector3 &max, int data)
+{
+	//add a volume to the grid, and return its ID
+
+	int id;
+	if (free_ids.empty() == false)
+	{
+		id = free_ids.back();
+		free_ids.pop_back();
+	}
+	else
+	{
+		id = (int)volumes.size();
+		volumes.emplace_back();
+	}
+
+	Volume &volume = volumes[id];
+	volume.min = min;
+	volume.max = max;
+	volume.data = data;
+	volume.used = true;
+	count++;
+
+	Insert(id);
+	return id;
+}
+
+void SpatialGrid::Update(int id, const Vector3 &min, const Vector3 &max)
+{
+	//change the bounds of a volume
+
+	if (id < 0 || id >= (int)volumes.size())
+		return;
+
+	Volume &volume = volumes[id];
+	if (volume.used == false)
+		return;
+
+	volume.min = min;
+	volume.max = max;
+
+	//only move the volume between cells if its cell range changed
+	int cell_min[3], cell_max[3];
+	GetRange(min, max, cell_min, cell_max);
+
+	bool changed = false;
+	for (int i = 0; i < 3; i++)
+	{
+		if (cell_min[i] != volume.cell_min[i] || cell_max[i] != volume.cell_max[i])
+			changed = true;
+	}
+
+	if (changed == false)
+		return;
+
+	Unlink(id);
+	Insert(id);
+}
+
+void SpatialGrid::Remove(int id)
+{
+	//remove a volume from the grid
+
+	if (id < 0 || id >= (int)volumes.size())
+		return;
+
+	if (volumes[id].used == false)
+		return;
+
+	Unlink(id);
+	volumes[id].used = false;
+	free_ids.emplace_back(id);
+	count--;
+}
+
+void SpatialGrid::Clear()
+{
+	//remove all volumes
+
+	volumes.clear();
+	free_ids.clear();
+	cells.clear();
+	large.clear();
+	count = 0;
+}
+
+bool SpatialGrid::Contains(int id, const Vector3 &point)
+{
+	//return true if the given point is inside the volume's bounds
+
+	if (id < 0 || id >= (int)volumes.size())
+		return false;
+
+	const Volume &volume = volumes[id];
+
+	return (volume.used == true &&
+			point.x >= volume.min.x && point.x <= volume.max.x &&
+			point.y >= volume.min.y && point.y <= volume.max.y &&
+			point.z >= volume.min.z && point.z <= volume.max.z);
+}
+
+void SpatialGrid::Query(const Vector3 &point, std::vector<int> &result)
+{
+	//get the IDs of all volumes that overlap the grid cell containing the given point
+	//results are unordered, and are appended to the list
+
+	int cell[3];
+	GetCell(point, cell);
+
+	std::unordered_map<uint64_t, std::vector<int>>::const_iterator it = cells.find(GetKey(cell[0], cell[1], cell[2]));
+	if (it != cells.end())
+		result.insert(result.end(), it->second.begin(), it->second.end());
+
+	result.insert(result.end(), large.begin(), large.end());
+}
+
+int SpatialGrid::GetData(int id)
+{
+	//get the user value of a volume
+
+	if (id < 0 || id >= (int)volumes.size())
+		return 0;
+
+	return volumes[id].data;
+}
+
+void SpatialGrid::Insert(int id)
+{
+	//store a volume in each cell it overlaps
+
+	Volume &volume = volumes[id];
+
+	GetRange(volume.min, volume.max, volume.cell_min, volume.cell_max);
+
+	int64_t total = 1;
+	for (int i = 0; i < 3; i++)
+		total *= (int64_t)(volume.cell_max[i] - volume.cell_min[i] + 1);
+
+	volume.large = (total > MaxCells);
+
+	if (volume.large == true)
+	{
+		large.emplace_back(id);
+		return;
+	}
+
+	for (int x = volume.cell_min[0]; x <= volume.cell_max[0]; x++)
+	{
+		for (int y = volume.cell_min[1]; y <= volume.cell_max[1]; y++)
+		{
+			for (int z = volume.cell_min[2]; z <= volume.cell_max[2]; z++)
+				cells[GetKey(x, y, z)].emplace_back(id);
+		}
+	}
+}
+
+void SpatialGrid::Unlink(int id)
+{
+	//remove a volume from its cells
+
+	Volume &volume = volumes[id];
+
+	if (volume.large == true)
+	{
+		RemoveID(large, id);
+		return;
+	}
+
+	for (int x = volume.cell_min[0]; x <= volume.cell_max[0]; x++)
+	{
+		for (int y = volume.cell_min[1]; y <= volume.cell_max[1]; y++)
+		{
+			for (int z = volume.cell_min[2]; z <= volume.cell_max[2]; z++)
+			{
+				std::unordered_map<uint64_t, std::vector<int>>::iterator it = cells.find(GetKey(x, y, z));
+				if (it == cells.end())
+					continue;
+
+				RemoveID(it->second, id);
+				if (it->second.empty() == true)
+					cells.erase(it);
+			}
+		}
+	}
+}
+
+void SpatialGrid::GetCell(const Vector3 &point, int cell[3])
+{
+	//get the cell coordinates containing the given point
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (planar == true && i == 1)
+		{
+			cell[i] = 0;
+			continue;
+		}
+
+		Real value = std::floor(point[i] / cell_size);
+
+		if (value > CellLimit)
+			value = CellLimit;
+		if (value < -CellLimit)
+			value = -CellLimit;
+
+		cell[i] = (int)value;
+	}
+}
+
+void SpatialGrid::GetRange(const Vector3 &min, const Vector3 &max, int cell_min[3], int cell_max[3])
+{
+	//get the range of cells overlapped by the given bounds
+
+	Vector3 low = min;
+	Vector3 high = max;
+	low.makeFloor(max);
+	high.makeCeil(min);
+
+	GetCell(low, cell_min);
+	GetCell(high, cell_max);
+}
+
+uint64_t SpatialGrid::GetKey(int x, int y, int z)
+{
+	//pack cell coordinates into a single key
+
+	const uint64_t mask = 0x1FFFFF;
+	return ((uint64_t)(x & mask) << 42) | ((uint64_t)(y & mask) << 21) | (uint64_t)(z & mask);
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+	Scalable Building Simulator - Spatial Grid
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_SPATIALGRID_H
+#define _SBS_SPATIALGRID_H
+
+#include <unordered_map>
+
+namespace SBS {
+
+//uniform grid index of axis-aligned volumes, used for camera containment checks
+//volumes are stored in each cell they overlap, keyed by cell coordinates, and volumes
+//that span too many cells are kept in a separate list that is included in every query
+//planar grids only use X and Z cells, for volumes that can be unbounded in height
+class SBSIMPEXP SpatialGrid : public ObjectBase
+{
+public:
+
+	SpatialGrid(Object *parent, Real cell_size, bool planar = false);
+	~SpatialGrid();
+	int Add(const Vector3 &min, const Vector3 &max, int data = 0);
+	void Update(int id, const Vector3 &min, const Vector3 &max);
+	void Remove(int id);
+	void Clear();
+	bool Contains(int id, const Vector3 &point);
+	void Query(const Vector3 &point, std::vector<int> &result);
+	int GetData(int id);
+	size_t GetCount() { return count; }
+	size_t GetCellCount() { return cells.size(); }
+	Real GetCellSize() { return cell_size; }
+
+private:
+
+	struct Volume
+	{
+		Vector3 min;
+		Vector3 max;
+		int cell_min[3]; //overlapped cell range
+		int cell_max[3];
+		int data; //user value
+		bool large; //true if stored in the large volume list
+		bool used;
+	};
+
+	void Insert(int id);
+	void Unlink(int id);
+	void GetCell(const Vector3 &point, int cell[3]);
+	void GetRange(const Vector3 &min, const Vector3 &max, int cell_min[3], int cell_max[3]);
+	uint64_t GetKey(int x, int y, int z);
+
+	std::vector<Volume> volumes;
+	std::vector<int> free_ids; //unused volume slots
+	std::unordered_map<uint64_t, std::vector<int>> cells; //volume IDs per cell
+	std::vector<int> large; //volumes spanning more than MaxCells cells
+	Real cell_size;
+	bool planar; //true if the Y axis isn't divided into cells
+	size_t count;
+
+	static const int MaxCells = 512;
+	static const int CellLimit = 0xFFFFF; //cell coordinates are packed into 21 bits each
+};
+
+}
+
+#endif
@@ -0,0 +1,131 @@
+/*
+	Scalable Building Simulator - Thread Pool
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "globals.h"
+#include "sbs.h"
+#include "threadpool.h"
+
+namespace SBS {
+
+//the main thread is the one that loads the SBS library
+static const std::thread::id main_thread = std::this_thread::get_id();
+
+ThreadPool::ThreadPool(int threads)
+{
+	running = 0;
+	quit = false;
+
+	//by default, use one worker per hardware thread, minus the calling thread
+	if (threads <= 0)
+		threads = (int)std::thread::hardware_concurrency() - 1;
+
+	for (int i = 0; i < threads; i++)
+		workers.emplace_back(&ThreadPool::Worker, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	//finish any remaining tasks, then stop the workers
+
+	Wait();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	task_available.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+}
+
+void ThreadPool::Add(const std::function<void()> &task)
+{
+	//queue a task to be run on a worker thread
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.emplace_back(task);
+	}
+	task_available.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	//run queued tasks on this thread, and return when all tasks have finished
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (tasks.empty() == false || running > 0)
+	{
+		if (RunTask(lock) == false)
+			task_finished.wait(lock);
+	}
+}
+
+bool ThreadPool::IsMainThread()
+{
+	//returns true if called from the main (rendering) thread
+
+	return (std::this_thread::get_id() == main_thread);
+}
+
+void ThreadPool::Worker()
+{
+	//worker thread loop
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+		if (RunTask(lock) == true)
+			continue;
+
+		if (quit == true)
+			return;
+
+		task_available.wait(lock);
+	}
+}
+
+bool ThreadPool::RunTask(std::unique_lock<std::mutex> &lock)
+{
+	//run the next queued task, if any, with the lock released while it runs
+
+	if (tasks.empty() == true)
+		return false;
+
+	std::function<void()> task = std::move(tasks.front());
+	tasks.pop_front();
+	running++;
+
+	lock.unlock();
+	task();
+	lock.lock();
+
+	running--;
+	task_finished.notify_all();
+	return true;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+	Scalable Building Simulator - Thread Pool
+	The Skyscraper Project - Version 2.1
+	Copyright (C)2004-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef _SBS_THREADPOOL_H
+#define _SBS_THREADPOOL_H
+
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace SBS {
+
+//fixed set of worker threads that run queued tasks
+//the thread that calls Wait() also runs queued tasks until all have finished
+class SBSIMPEXP ThreadPool
+{
+public:
+
+	explicit ThreadPool(int threads = 0);
+	~ThreadPool();
+	void Add(const std::function<void()> &task);
+	void Wait();
+	int GetThreadCount() { return (int)workers.size(); }
+	static bool IsMainThread();
+
+private:
+
+	void Worker();
+	bool RunTask(std::unique_lock<std::mutex> &lock);
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()> > tasks;
+	std::mutex mutex;
+	std::condition_variable task_available; //signaled when a task is added, or on shutdown
+	std::condition_variable task_finished; //signaled when a running task completes
+	size_t running; //number of tasks currently running
+	bool quit;
+};
+
+}
+
+#endif
@@ -58,6 +58,7 @@ void TimerObject::Start(int milliseconds, bool oneshot)
 	LastHit = 0;
 	CurrentTime = 0;
 	sbs->RegisterTimerCallback(this);
+	Schedule();
 
 	if (sbs->Verbose)
 		Report("Start");
@@ -82,6 +83,8 @@ bool TimerObject::IsRunning()
 
 bool TimerObject::Loop()
 {
+	//called by the SBS timer scheduler when this timer is due
+
 	if (Running == false)
 		return true;
 
@@ -96,12 +99,31 @@ bool TimerObject::Loop()
 			Stop();
 
 		Notify();
+
+		//if the timer was restarted by the notification, keep its new schedule
+		if (sbs->IsTimerScheduled(this) == true)
+			return true;
+
 		LastHit = CurrentTime;
 	}
 
+	if (Running == true)
+		Schedule();
+
 	return true;
 }
 
+void TimerObject::Schedule()
+{
+	//schedule the next notification with the SBS timer scheduler
+
+	//a negative interval never notifies
+	if (Interval < 0)
+		return;
+
+	sbs->ScheduleTimer(this, StartTime + LastHit + (unsigned long)Interval);
+}
+
 unsigned long TimerObject::GetCurrentTime()
 {
 	return CurrentTime;
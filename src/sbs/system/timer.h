@@ -41,6 +41,8 @@ public:
 	void Report(const std::string &message);
 
 private:
+	void Schedule();
+
 	int Interval;
 	bool OneShot;
 	unsigned long CurrentTime;
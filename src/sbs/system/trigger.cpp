@@ -33,6 +33,7 @@
 #include "action.h"
 #include "profiler.h"
 #include "manager.h"
+#include "spatialgrid.h"
 #include "trigger.h"
 
 namespace SBS {
@@ -57,6 +58,10 @@ Trigger::Trigger(Object *parent, const std::string &name, bool permanent, const
 	sound = 0;
 	teleporter = false;
 
+	//add trigger area to the trigger grid
+	Ogre::AxisAlignedBox bounds = GetBounds();
+	grid_id = sbs->GetTriggerGrid()->Add(bounds.getMinimum(), bounds.getMaximum());
+
 	//create sound object
 	if (sound_file != "")
 	{
@@ -80,6 +85,9 @@ Trigger::~Trigger()
 		delete area_box;
 	area_box = 0;
 
+	if (sbs->GetTriggerGrid())
+		sbs->GetTriggerGrid()->Remove(grid_id);
+
 	//unregister from parent
 	if (sbs->FastDelete == false)
 	{
@@ -274,11 +282,16 @@ bool Trigger::Loop()
 	if (is_enabled == false)
 		return true;
 
+	//only test the trigger if it's in the camera's grid cell, or if the camera is inside of it
+	if (is_inside == false && sbs->IsTriggerNearby(grid_id) == false)
+		return true;
+
 	SBS_PROFILE("Trigger::Loop");
 
+	//test against the trigger's cached bounds, which are updated when the trigger moves
 	Vector3 cam = sbs->camera->GetPosition();
 	bool changed = false;
-	if (IsInside(cam) == true)
+	if (sbs->GetTriggerGrid()->Contains(grid_id, cam) == true)
 	{
 		if (is_inside == false)
 			changed = true;
@@ -420,6 +433,7 @@ void Trigger::Merge(Ogre::AxisAlignedBox &box)
 {
 	//expand this trigger box to encompass the given box
 	area_box->merge(box);
+	UpdateBounds();
 }
 
 void Trigger::OnEntry()
@@ -434,4 +448,23 @@ void Trigger::OnExit()
 	GetParent()->OnExit();
 }
 
+void Trigger::OnMove(bool parent)
+{
+	UpdateBounds();
+}
+
+void Trigger::OnRotate(bool parent)
+{
+	if (parent == true)
+		UpdateBounds(); //update bounds if parent object has been rotated
+}
+
+void Trigger::UpdateBounds()
+{
+	//update the trigger's volume in the trigger grid
+
+	Ogre::AxisAlignedBox bounds = GetBounds();
+	sbs->GetTriggerGrid()->Update(grid_id, bounds.getMinimum(), bounds.getMaximum());
+}
+
 }
@@ -62,13 +62,18 @@ public:
 	void Merge(Ogre::AxisAlignedBox &box);
 	void OnEntry();
 	void OnExit();
+	void OnMove(bool parent);
+	void OnRotate(bool parent);
 
 private:
+	void UpdateBounds();
+
 	Ogre::AxisAlignedBox *area_box;
 	int current_position; //current trigger position
 	bool is_inside;
 	bool is_enabled;
 	std::vector<std::string> Actions; //trigger actions
+	int grid_id; //volume ID in the trigger grid
 
 	Sound *sound; //sound object
 };
@@ -65,11 +65,14 @@ Utility::Utility(Object *parent) : ObjectBase(parent)
 
 	if (UnitScale <= 0)
 		UnitScale = 1;
+
+	verify_lookups = 0;
+	verify_hits = 0;
 }
 
 Utility::~Utility()
 {
-	verify_results.clear();
+	ClearFileIndex();
 }
 
 Real Utility::MetersToFeet(Real meters)
@@ -135,75 +138,58 @@ std::string Utility::VerifyFile(std::string filename, bool &result, bool skip_ca
 	//check for a cached result
 	if (skip_cache == false)
 	{
-		for (size_t i = 0; i < verify_results.size(); i++)
+		verify_lookups++;
+		std::unordered_map<std::string, std::string>::iterator cached = verify_results.find(filename);
+		if (cached != verify_results.end())
 		{
-			if (verify_results[i].filename == filename)
-				return verify_results[i].result;
+			verify_hits++;
+			return cached->second;
 		}
 	}
 
-	//get filesystem archive
-	Ogre::Archive *filesystem = 0;
-	Ogre::ArchiveManager::ArchiveMapIterator it = Ogre::ArchiveManager::getSingleton().getArchiveIterator();
-	while(it.hasMoreElements())
-	{
-		const std::string& key = it.peekNextKey();
-		filesystem = it.getNext();
-
-		if (!filesystem)
-			return "";
-
-		//check for a mount point
-		Ogre::StringVectorPtr listing;
-		std::string shortname;
-		std::string group = GetMountPath(filename, shortname);
+	//check for a mount point
+	std::string shortname;
+	std::string group = GetMountPath(filename, shortname);
 
-		if (group == "General")
+	if (group != "General")
+	{
+		//for other groups, check the index of the resource mount point
+		std::string check;
+		if (FindFile(GetFileIndex(group, 0), shortname, check) == true)
 		{
-			//for the General group, check the native filesystem
-
-			if (filesystem->exists(filename) == true)
-			{
-				//if exact filename exists, cache and exit
-				CacheFilename(filename, filename);
-				result = true;
-				return filename;
-			}
-
-			//otherwise get listing of files to check
-			if (!filesystem_listing)
-				filesystem_listing = filesystem->list();
-			listing = filesystem_listing;
+			std::string found = group + "/" + check;
+			CacheFilename(filename, found);
+			result = true;
+			return found;
 		}
-		else
+	}
+	else
+	{
+		//for the General group, check the index of each filesystem archive
+		Ogre::ArchiveManager::ArchiveMapIterator it = Ogre::ArchiveManager::getSingleton().getArchiveIterator();
+		while(it.hasMoreElements())
 		{
-			//for other groups, check resource mount points
+			const std::string& key = it.peekNextKey();
+			Ogre::Archive *filesystem = it.getNext();
 
-			if (Ogre::ResourceGroupManager::getSingleton().resourceExists(group, shortname) == true)
-			{
-				//if exact filename exists, cache and exit
-				CacheFilename(filename, filename);
-				result = true;
-				return filename;
-			}
-
-			//otherwise get listing of files to check
-			listing = Ogre::ResourceGroupManager::getSingleton().listResourceNames(group);
-		}
+			if (!filesystem)
+				return "";
 
-		//go through file listing, to find a match with a different case
-		for (size_t i = 0; i < listing->size(); i++)
-		{
-			std::string check = listing->at(i);
-			std::string checkoriginal = SetCaseCopy(check, false);
-			std::string checkfile = SetCaseCopy(filename, false);
-			if (checkoriginal == checkfile)
+			std::string check;
+			if (FindFile(GetFileIndex(key, filesystem), filename, check) == true)
 			{
 				//if match is found, cache and exit
 				CacheFilename(filename, check);
 				result = true;
 				return check;
 			}
+
+			//files created since the archive was indexed are only found on an uncached check
+			if (skip_cache == true && filesystem->exists(filename) == true)
+			{
+				result = true;
+				return filename;
+			}
 		}
 	}
 
@@ -212,6 +198,88 @@ std::string Utility::VerifyFile(std::string filename, bool &result, bool skip_ca
 	return filename;
 }
 
+Utility::FileIndex& Utility::GetFileIndex(const std::string &name, Ogre::Archive *archive)
+{
+	//get the file index of the given archive, or resource group if archive is 0
+	//the index is built from a full file listing on first use
+
+	std::unordered_map<std::string, FileIndex>::iterator it = file_indexes.find(name);
+	if (it != file_indexes.end())
+		return it->second;
+
+	FileIndex &index = file_indexes[name];
+
+	Ogre::StringVectorPtr listing;
+	try
+	{
+		if (archive)
+			listing = archive->list();
+		else
+			listing = Ogre::ResourceGroupManager::getSingleton().listResourceNames(name);
+	}
+	catch (Ogre::Exception &e)
+	{
+		ReportError("Error listing files in " + name + "\n" + e.getDescription());
+		return index;
+	}
+
+	if (!listing)
+		return index;
+
+	index.files.reserve(listing->size());
+	index.folded.reserve(listing->size());
+
+	for (size_t i = 0; i < listing->size(); i++)
+	{
+		const std::string &file = listing->at(i);
+		index.files.insert(file);
+		index.folded.emplace(SetCaseCopy(file, false), file); //keeps the first file of a name
+	}
+
+	return index;
+}
+
+bool Utility::FindFile(FileIndex &index, const std::string &filename, std::string &result)
+{
+	//find a file in an index, by exact name, or by a name with a different case
+
+	if (index.files.find(filename) != index.files.end())
+	{
+		result = filename;
+		return true;
+	}
+
+	std::unordered_map<std::string, std::string>::iterator it = index.folded.find(SetCaseCopy(filename, false));
+	if (it != index.folded.end())
+	{
+		result = it->second;
+		return true;
+	}
+
+	return false;
+}
+
+void Utility::ClearFileIndex()
+{
+	//clear file indexes and cached VerifyFile results, for when the virtual filesystem changes
+
+	verify_results.clear();
+	file_indexes.clear();
+}
+
+void Utility::GetFileStats(size_t &lookups, size_t &hits, size_t &indexed)
+{
+	//get VerifyFile cache statistics, and the number of indexed files
+
+	lookups = verify_lookups;
+	hits = verify_hits;
+	indexed = 0;
+
+	std::unordered_map<std::string, FileIndex>::iterator it = file_indexes.begin();
+	for (; it != file_indexes.end(); ++it)
+		indexed += it->second.files.size();
+}
+
 std::string Utility::GetFilesystemPath(std::string filename)
 {
 	//returns the filesystem path for the specified file
@@ -357,6 +425,9 @@ bool Utility::Mount(const std::string &filename, const std::string &path)
 	{
 		return ReportError("Error mounting file " + file + "\n" + e.getDescription());
 	}
+
+	//the new mount point changes file lookups
+	ClearFileIndex();
 	return true;
 }
 
@@ -396,10 +467,7 @@ std::string Utility::GetMountPath(std::string filename, std::string &newfilename
 void Utility::CacheFilename(const std::string &filename, const std::string &result)
 {
 	//caches filename information for VerifyFile function
-	VerifyResult verify;
-	verify.filename = filename;
-	verify.result = result;
-	verify_results.emplace_back(verify);
+	verify_results[filename] = result;
 }
 
 bool Utility::GetFloorFromID(const std::string &floor, int &result)
@@ -24,6 +24,9 @@
 #ifndef _SBS_UTILITY_H
 #define _SBS_UTILITY_H
 
+#include <unordered_map>
+#include <unordered_set>
+
 namespace SBS {
 
 class SBSIMPEXP Utility : public ObjectBase
@@ -54,6 +57,8 @@ public:
 	std::string GetFilesystemPath(std::string filename);
 	std::string GetMountPath(std::string filename, std::string &newfilename);
 	void CacheFilename(const std::string &filename, const std::string &result);
+	void ClearFileIndex();
+	void GetFileStats(size_t &lookups, size_t &hits, size_t &indexed);
 	bool GetFloorFromID(const std::string &floor, int &result);
 	std::string ProcessFullName(std::string name, int &instance, int &object_number, bool strip_number = false);
 	bool HitBeam(const Ray &ray, Real max_distance, MeshObject *&mesh, Wall *&wall, Polygon *&polygon, Vector3 &hit_position);
@@ -61,15 +66,20 @@ public:
 
 private:
 
-	struct VerifyResult
+	//file index, listing the files of an archive or resource group
+	struct FileIndex
 	{
-		std::string filename;
-		std::string result;
+		std::unordered_set<std::string> files; //exact filenames
+		std::unordered_map<std::string, std::string> folded; //lowercase filename, to the first matching filename
 	};
-	std::vector<VerifyResult> verify_results;
 
-	//file listing cache
-	Ogre::StringVectorPtr filesystem_listing;
+	FileIndex& GetFileIndex(const std::string &name, Ogre::Archive *archive);
+	bool FindFile(FileIndex &index, const std::string &filename, std::string &result);
+
+	std::unordered_map<std::string, std::string> verify_results; //VerifyFile results by filename
+	std::unordered_map<std::string, FileIndex> file_indexes; //by archive name, or resource group name for mount points
+	size_t verify_lookups; //VerifyFile calls using the result cache
+	size_t verify_hits; //cached results found
 };
 
 //EnableArray() function
@@ -325,33 +325,8 @@ int ScriptProcessor::CommandsSection::Run(std::string &LineData)
 		bool equals;
 		std::string value = Calc(GetAfterEquals(LineData, equals));
 
-		//find existing variable by name
-		int index = -1;
-		for (int i = 0; i < (int)parent->variables.size(); i++)
-		{
-			if (parent->variables[i].name == str)
-			{
-				index = i;
-				break;
-			}
-		}
-
-		if (index == -1)
-		{
-			//create new variable
-			VariableMap variable;
-			variable.name = str;
-			variable.value = value;
-			parent->variables.emplace_back(variable);
-			value = variable.value;
-		}
-		else
-		{
-			//set existing variable
-			parent->variables[index].name = str;
-			parent->variables[index].value = value;
-			value = parent->variables[index].value;
-		}
+		//set variable, creating it if needed
+		parent->SetVariable(str, value);
 
 		if (Simcore->Verbose == true)
 			engine->Report("Variable '" + str + "' set to " + value);
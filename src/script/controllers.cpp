@@ -153,6 +153,26 @@ int ScriptProcessor::ControllerSection::Run(std::string &LineData)
 		c->Reprocess = ToBool(value);
 		return sNextLine;
 	}
+	//DispatchPolicy parameter
+	if (StartsWithNoCase(LineData, "dispatchpolicy"))
+	{
+		if (equals == false)
+			return ScriptError("Syntax error");
+
+		if (!c->SetPolicy(value))
+			return ScriptError();
+		return sNextLine;
+	}
+	//ReassignInterval parameter
+	if (StartsWithNoCase(LineData, "reassigninterval"))
+	{
+		if (equals == false)
+			return ScriptError("Syntax error");
+		std::string str = Calc(value);
+		if (!IsNumeric(str, c->ReassignInterval))
+			return ScriptError("Invalid value");
+		return sNextLine;
+	}
 
 	//handle end of controller section
 	if (StartsWithNoCase(LineData, "<endcontroller>") && config->RangeL == config->RangeH)
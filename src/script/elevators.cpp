@@ -82,7 +82,7 @@ int ScriptProcessor::ElevatorSection::Run(std::string &LineData)
 	{
 		if (equals == false)
 			return ScriptError("Syntax error");
-		elev->Type = value;
+		elev->SetType(value);
 		return sNextLine;
 	}
 	//Speed parameter
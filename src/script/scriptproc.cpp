@@ -31,21 +31,205 @@
 #include <OgreArchiveManager.h>
 #include <OgreException.h>
 #include <stdlib.h>
+#include <cstdio>
+#include <cctype>
 #include <cmath>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <string_view>
 #include "vm.h"
 #include "sky.h"
 #include "enginecontext.h"
+#include "hal.h"
 #include "texman.h"
 #include "floor.h"
 #include "camera.h"
 #include "random.h"
+#include "snapshot.h"
 #include "scriptproc.h"
 #include "section.h"
+#include "source.h"
 
 using namespace SBS;
 
 namespace Skyscraper {
 
+//cache of compiled files, keyed by hash and size of the file contents
+struct CompiledEntry
+{
+	size_t size; //size of the file contents
+	uint64_t last_use; //cache use counter value of the last lookup
+	std::shared_ptr<const CompiledFile> file;
+};
+
+static std::unordered_map<size_t, CompiledEntry> compiled_files;
+static size_t compiled_lines = 0; //total lines held by the cache
+static uint64_t compiled_uses = 0;
+static std::mutex compiled_mutex;
+static const size_t MaxCompiledLines = 250000;
+
+//variable name IDs, shared by all script processors since compiled files are shared
+static std::unordered_map<std::string, int> variable_ids;
+static std::mutex variable_mutex;
+
+static int GetVariableID(const std::string &name, bool create)
+{
+	//get the ID of a variable name, or -1 if the name has no ID and create is false
+
+	std::lock_guard<std::mutex> lock(variable_mutex);
+
+	std::unordered_map<std::string, int>::iterator it = variable_ids.find(name);
+	if (it != variable_ids.end())
+		return it->second;
+
+	if (create == false)
+		return -1;
+
+	int id = (int)variable_ids.size();
+	variable_ids[name] = id;
+	return id;
+}
+
+static bool HasFloorReference(const std::string &data)
+{
+	//return true if the text contains a floor object reference ("floor("), in any case
+
+	static const char *search = "floor(";
+
+	for (size_t i = 0; i + 6 <= data.size(); i++)
+	{
+		size_t j = 0;
+		while (j < 6 && tolower((unsigned char)data[i + j]) == search[j])
+			j++;
+		if (j == 6)
+			return true;
+	}
+	return false;
+}
+
+static void ScanLine(const std::string &data, bool &tag, bool &variables, bool &floors)
+{
+	//determine which processing passes a line needs
+
+	tag = (data.size() > 0 && data[0] == '<');
+	variables = (data.find("%") != std::string::npos);
+	floors = HasFloorReference(data);
+}
+
+static void CompileLine(const std::string &data, ScriptProcessor::CompiledLine &result, bool trim)
+{
+	//compile a script line
+
+	result.text = data;
+	if (trim == true)
+		TrimString(result.text);
+
+	//process comment markers
+	size_t marker = result.text.find("#");
+	if (marker != std::string::npos)
+		result.text.erase(marker);
+
+	ScanLine(result.text, result.tag, result.variables, result.floors);
+	result.params = (result.variables == true && result.text.find("%param") != std::string::npos);
+	result.segments.clear();
+
+	if (result.variables == false)
+		return;
+
+	//split the line into literal text and variable references,
+	//pairing markers the same way as ProcessUserVariables()
+	const std::string &text = result.text;
+	size_t literal = 0;
+	while (true)
+	{
+		size_t loc1 = text.find("%", literal);
+		if (loc1 == std::string::npos)
+			break;
+		size_t loc2 = text.find("%", loc1 + 1);
+		if (loc2 == std::string::npos)
+			break;
+
+		std::string name = text.substr(loc1 + 1, loc2 - loc1 - 1);
+		TrimString(name);
+
+		ScriptProcessor::Segment segment;
+		if (loc1 > literal)
+		{
+			segment.start = literal;
+			segment.length = loc1 - literal;
+			segment.variable = -1;
+			result.segments.emplace_back(segment);
+		}
+
+		segment.start = loc1;
+		segment.length = loc2 - loc1 + 1;
+		segment.variable = GetVariableID(name, true);
+		result.segments.emplace_back(segment);
+
+		literal = loc2 + 1;
+	}
+
+	if (literal < text.size())
+	{
+		ScriptProcessor::Segment segment;
+		segment.start = literal;
+		segment.length = text.size() - literal;
+		segment.variable = -1;
+		result.segments.emplace_back(segment);
+	}
+}
+
+static std::shared_ptr<const CompiledFile> GetCompiledFile(size_t hash, size_t size)
+{
+	//get a previously compiled file with the same contents hash and size
+
+	std::lock_guard<std::mutex> lock(compiled_mutex);
+
+	std::unordered_map<size_t, CompiledEntry>::iterator it = compiled_files.find(hash);
+	if (it == compiled_files.end() || it->second.size != size)
+		return 0;
+
+	it->second.last_use = ++compiled_uses;
+	return it->second.file;
+}
+
+static void StoreCompiledFile(size_t hash, size_t size, std::shared_ptr<const CompiledFile> file)
+{
+	//store a compiled file in the cache, and remove the least recently used files
+	//if the cache holds more than MaxCompiledLines lines
+
+	std::lock_guard<std::mutex> lock(compiled_mutex);
+
+	std::unordered_map<size_t, CompiledEntry>::iterator it = compiled_files.find(hash);
+	if (it != compiled_files.end())
+	{
+		compiled_lines -= it->second.file->lines.size();
+		compiled_files.erase(it);
+	}
+
+	CompiledEntry entry;
+	entry.size = size;
+	entry.last_use = ++compiled_uses;
+	entry.file = file;
+	compiled_files[hash] = entry;
+	compiled_lines += file->lines.size();
+
+	while (compiled_lines > MaxCompiledLines && compiled_files.size() > 1)
+	{
+		std::unordered_map<size_t, CompiledEntry>::iterator oldest = compiled_files.end();
+		for (it = compiled_files.begin(); it != compiled_files.end(); ++it)
+		{
+			if (it->first != hash && (oldest == compiled_files.end() || it->second.last_use < oldest->second.last_use))
+				oldest = it;
+		}
+
+		compiled_lines -= oldest->second.file->lines.size();
+		compiled_files.erase(oldest);
+	}
+}
+
 ScriptProcessor::ScriptProcessor(EngineContext *instance)
 {
 	if (!instance)
@@ -69,7 +253,17 @@ ScriptProcessor::ScriptProcessor(EngineContext *instance)
 	controller_section = new ControllerSection(this);
 	callstation_section = new CallStationSection(this);
 
+	//create script source
+	source = new Source();
+
 	NoModels = false;
+
+	//run as many lines per frame as fit in the load budget; headless runs load without a limit
+	HAL *hal = engine->GetVM()->GetHAL();
+	LoadBudget = hal->GetConfigInt(hal->configfile, "Skyscraper.Frontend.LoadBudget", 25);
+	if (engine->GetVM()->Headless == true || LoadBudget < 0)
+		LoadBudget = 0;
+
 	Reset();
 }
 
@@ -97,6 +291,8 @@ ScriptProcessor::~ScriptProcessor()
 		delete controller_section;
 	if (callstation_section)
 		delete callstation_section;
+	if (source)
+		delete source;
 }
 
 void ScriptProcessor::Reset(bool full)
@@ -114,17 +310,18 @@ void ScriptProcessor::Reset(bool full)
 	show_percent = true;
 	IsFinished = false;
 	progress_marker = 0;
+	progress_percent = 0;
+	progress_time = std::chrono::steady_clock::now();
 	functions.clear();
-	includes.clear();
 	variables.clear();
+	variable_slots.clear();
 	in_runloop = false;
 	processed_runloop = false;
 
 	if (full == true)
 	{
-		BuildingData.clear();
+		source->Clear();
 		BuildingDataOrig.clear();
-		BuildingData.reserve(1024);
 		BuildingDataOrig.reserve(1024);
 	}
 
@@ -150,9 +347,45 @@ void ScriptProcessor::Reset(bool full)
 bool ScriptProcessor::Run()
 {
 	//building loader/script interpreter
+	//while a building is loading, lines are run until the per-frame load budget is used up,
+	//otherwise a single line is run per frame
+
+	if (engine->IsLoading() == false || InRunloop() == true)
+		return RunLine();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::milliseconds budget (LoadBudget);
+
+	while (true)
+	{
+		if (RunLine() == false)
+			return false;
+
+		//stop at the end of the script, or if the engine is shutting down
+		if (IsFinished == true || line >= (int)source->GetSize() || engine->GetShutdownState() == true)
+			break;
+
+		//stop if a runloop has started
+		if (InRunloop() == true)
+			break;
+
+		if (LoadBudget > 0 && std::chrono::steady_clock::now() - start >= budget)
+			break;
+	}
+
+	return true;
+}
+
+bool ScriptProcessor::RunLine()
+{
+	//process a single script line
 
 	bool status = false;
 	int returncode = sContinue;
+	bool tag = false;
+	bool variables = false;
+	bool floors = false;
+	const CompiledLine *compiled = 0; //compiled line, while the line text is unchanged from it
 	IsFinished = false;
 
 	if (engine->IsRunning() == true && processed_runloop == false)
@@ -162,28 +395,31 @@ bool ScriptProcessor::Run()
 	if (processed_runloop == true)
 		processed_runloop = false;
 
-	if (line < (int)BuildingData.size() && line >= 0)
+	if (line < (int)source->GetSize() && line >= 0)
 	{
 		if (InRunloop() == false)
 			engine->ResetPrepare(); //reset prepare flag
-		LineData = BuildingData[line];
-		TrimString(LineData);
-
 		if (ReplaceLine == true)
 		{
+			//use replacement line data
 			LineData = ReplaceLineData;
 			ReplaceLine = false;
-		}
 
-		//skip blank lines
-		if (LineData == "")
-			goto Nextline;
+			//process comment markers
+			int marker = LineData.find("#", 0);
+			if (marker > -1)
+				LineData.erase(marker);
 
-		//process comment markers
+			ScanLine(LineData, tag, variables, floors);
+		}
+		else
 		{
-		int marker = LineData.find("#", 0);
-		if (marker > -1)
-			LineData.erase(marker);
+			//get compiled line, already trimmed and with comments removed
+			compiled = &source->GetLine(line);
+			LineData = compiled->text;
+			tag = compiled->tag;
+			variables = compiled->variables;
+			floors = compiled->floors;
 		}
 
 		//skip blank lines
@@ -191,7 +427,7 @@ bool ScriptProcessor::Run()
 			goto Nextline;
 
 		//expand runloop variables
-		if (in_runloop == true)
+		if (in_runloop == true && variables == true)
 		{
 			ReplaceAll(LineData, "%uptime%", ToString((int)Simcore->GetRunTime()));
 			struct tm datetime = engine->GetVM()->GetDateTime();
@@ -208,6 +444,7 @@ bool ScriptProcessor::Run()
 			ReplaceAll(LineData, "%hour%", ToString(hour));
 			ReplaceAll(LineData, "%minute%", ToString(minute));
 			ReplaceAll(LineData, "%second%", ToString(second));
+			compiled = 0;
 		}
 
 		//process function parameters
@@ -217,27 +454,52 @@ bool ScriptProcessor::Run()
 		if (status == false)
 			goto Error;
 
-		//process user variables
-		ProcessUserVariables();
+		if (InFunction > 0 && compiled && compiled->params == true)
+			compiled = 0;
+
+		if (variables == true)
+		{
+			//expand user variables from the compiled line, or process the line text if it was changed
+			if (!compiled || ExpandVariables(*compiled, tag, variables, floors) == false)
+			{
+				if (compiled)
+					LineData = compiled->text;
+
+				ProcessUserVariables();
+
+				//rescan line, since expanded values may contain tags or floor objects
+				ScanLine(LineData, tag, variables, floors);
+			}
+		}
 
 		//process sections
-		returncode = ProcessSections();
-		if (returncode != sContinue)
-			goto handlecodes;
+		if (tag == true)
+		{
+			returncode = ProcessSections();
+			if (returncode != sContinue)
+				goto handlecodes;
+		}
 
 		//process floor object conversions
 checkfloors:
-		returncode = ProcessFloorObjects();
-		if (returncode != sContinue)
-			goto handlecodes;
+		if (floors == true)
+		{
+			returncode = ProcessFloorObjects();
+			if (returncode != sContinue)
+				goto handlecodes;
+		}
 
 		//process extent variables
-		ProcessExtents();
+		if (variables == true)
+			ProcessExtents();
 
 		//process For loops
-		returncode = ProcessForLoops();
-		if (returncode != sContinue)
-			goto handlecodes;
+		if (tag == true)
+		{
+			returncode = ProcessForLoops();
+			if (returncode != sContinue)
+				goto handlecodes;
+		}
 
 		//reset return code
 		returncode = sContinue;
@@ -292,7 +554,10 @@ handlecodes:
 		if (returncode == sError)
 			goto Error;
 		else if (returncode == sCheckFloors)
+		{
+			floors = true;
 			goto checkfloors;
+		}
 		else if (returncode == sBreak)
 		{
 			Breakpoint();
@@ -324,7 +589,7 @@ Nextline:
 		else
 			line++;
 
-		if (line == (int)BuildingData.size())
+		if (line == (int)source->GetSize())
 		{
 			//free text texture memory
 			Simcore->GetTextureManager()->FreeTextureBoxes();
@@ -350,7 +615,7 @@ bool ScriptProcessor::LoadDataFile(const std::string &filename, bool insert, int
 	//if insert location is greater than array size, return with error
 	if (insert == true)
 	{
-		if (location > (int)BuildingData.size() - 1 || location < 0)
+		if (location > (int)source->GetSize() - 1 || location < 0)
 		{
 			ScriptError("Cannot insert file beyond end of script");
 			return false;
@@ -419,47 +684,53 @@ bool ScriptProcessor::LoadDataFile(const std::string &filename, bool insert, int
 		return false;
 	}
 
-	Ogre::DataStreamPtr file(new Ogre::MemoryDataStream(Filename, filedata, true, true));
+	Ogre::MemoryDataStream *memory = new Ogre::MemoryDataStream(Filename, filedata, true, true);
+	Ogre::DataStreamPtr file(memory);
 
-	std::vector<std::string> insert_data;
-	insert_data.reserve(512);
+	//look for a previously compiled copy of this file, by a hash of its contents
+	std::string_view contents((const char*)memory->getPtr(), memory->size());
+	size_t hash = std::hash<std::string_view>()(contents);
+	std::shared_ptr<const CompiledFile> compiled = GetCompiledFile(hash, contents.size());
 
-	while (file->eof() == false)
+	if (!compiled)
 	{
-		//push next line of data onto the tail end of the BuildingData array
-		std::string line = file->getLine(true);
-		if (insert == false)
-		{
-			//append data to building array
-			BuildingData.emplace_back(line);
-			BuildingDataOrig.emplace_back(line);
-		}
-		else
-		{
-			//otherwise add data to new array, and insert into buildings array later
-			insert_data.emplace_back(line);
-		}
+		std::shared_ptr<CompiledFile> newfile = std::make_shared<CompiledFile>();
+		newfile->lines.reserve(512);
+
+		//read file lines
+		while (file->eof() == false)
+			newfile->lines.emplace_back(file->getLine(true));
+
+		//compile lines
+		newfile->compiled.resize(newfile->lines.size());
+		for (size_t i = 0; i < newfile->lines.size(); i++)
+			CompileLine(newfile->lines[i], newfile->compiled[i], true);
+
+		StoreCompiledFile(hash, contents.size(), newfile);
+		compiled = newfile;
 	}
+	else if (Simcore->Verbose)
+		Simcore->Report("Using compiled data for '" + Filename + "'");
 
-	if (insert == true)
-	{
-		//insert new building data into array
-		BuildingData.insert(BuildingData.begin() + location, insert_data.begin(), insert_data.end());
-		location += (int)insert_data.size();
+	//register the file with the geometry snapshot, which is only replayed while all loaded files match
+	if (insert == false)
+		Simcore->OpenGeometrySnapshot(Filename, hash);
+	else if (Simcore->GetGeometrySnapshot())
+		Simcore->GetGeometrySnapshot()->AddSource(Filename, hash);
 
-		int end = location - 1;
-		int lines = end - insert_line;
-		int parent = -1;
+	if (insert == false)
+	{
+		//append data to building source
+		source->Append(compiled);
+		BuildingDataOrig.insert(BuildingDataOrig.end(), compiled->lines.begin(), compiled->lines.end());
+	}
+	else
+	{
+		//replace the line at the insert location with the new building data
+		source->Insert(location, compiled, Filename);
 
-		//adjust include end lines if included within another include
-		for (int i = 0; i < (int)includes.size(); i++)
-		{
-			if (includes[i].start_line < line && includes[i].end_line > line)
-			{
-				includes[i].end_line += lines;
-				parent = i;
-			}
-		}
+		//number of lines added, not counting the replaced line
+		int lines = (int)compiled->lines.size() - 1;
 
 		//adjust function lines
 		for (size_t i = 0; i < functions.size(); i++)
@@ -476,14 +747,6 @@ bool ScriptProcessor::LoadDataFile(const std::string &filename, bool insert, int
 					FunctionStack[i].CallLine += lines;
 			}
 		}
-
-		//store include info in array
-		IncludeInfo info;
-		info.filename = Filename;
-		info.start_line = line;
-		info.end_line = end;
-		info.parent = parent;
-		includes.emplace_back(info);
 	}
 
 	return true;
@@ -496,17 +759,16 @@ bool ScriptProcessor::LoadFromText(const std::string &text)
 	if (text.size() == 0)
 		return false;
 
-	std::vector<std::string> textarray;
-	SplitString(textarray, text, '\n');
+	std::shared_ptr<CompiledFile> file = std::make_shared<CompiledFile>();
+	SplitString(file->lines, text, '\n');
 
-	//feed each line of text into the script array
+	//compile each line of text, and add to the building source
+	file->compiled.resize(file->lines.size());
+	for (size_t i = 0; i < file->lines.size(); i++)
+		CompileLine(file->lines[i], file->compiled[i], true);
 
-	for (size_t i = 0; i < textarray.size(); i++)
-	{
-		//append data to building array
-		BuildingData.emplace_back(textarray[i]);
-		BuildingDataOrig.emplace_back(textarray[i]);
-	}
+	source->Append(file);
+	BuildingDataOrig.insert(BuildingDataOrig.end(), file->lines.begin(), file->lines.end());
 	return true;
 }
 
@@ -553,7 +815,7 @@ int ScriptProcessor::ScriptError(std::string message, bool warning)
 	engine->ReportError(error);
 
 	//show error dialog
-	if (warning == false)
+	if (warning == false && engine->GetVM()->Headless == false)
 	{
 #ifdef USING_WX
 		wxMessageDialog dialog (0, error, "Skyscraper", wxOK | wxICON_ERROR);
@@ -572,108 +834,225 @@ void ScriptProcessor::GetLineInformation(bool CheckFunctionCall, int &LineNumber
 	//if function call line is in an included file, IsIncludeFunction is true, with IncludeFunctionFile as the file
 	//to skip the function call line check, set CheckFunctionCall to false
 
-	int linenum = line;
-	int newlinenum = line;
-	int linenum_start = 0;
-	int function_line = 0;
-	int newfunction_line = 0;
-	int function_line_start = 0;
-	int included_lines = 0;
-	int included_lines_f = 0;
-	int parent = -1;
-	int parent_f = -1;
 	FunctionLine = 0;
-	IsInclude = false;
 	IsIncludeFunction = false;
 	FunctionName = "";
-	IncludeFile = "";
 	IncludeFunctionFile = "";
 
+	//get the file and file line number that the current line was loaded from
+	IsInclude = source->GetOrigin(line, IncludeFile, LineNumber);
+
 	if (InFunction > 0)
 	{
 		FunctionName = FunctionStack[InFunction - 1].Name;
-		function_line = FunctionStack[InFunction - 1].CallLine;
-		newfunction_line = function_line;
+		int function_line = FunctionStack[InFunction - 1].CallLine;
+
+		//get the file and file line number of the function call line
+		if (CheckFunctionCall == true)
+			IsIncludeFunction = source->GetOrigin(function_line, IncludeFunctionFile, FunctionLine);
+		else
+			FunctionLine = function_line + 1;
 	}
+}
+
+int ScriptProcessor::ScriptError()
+{
+	//return automatic error message from contents of the simulator engine's LastError string
 
-	//first see if the current line is from an included file
-	for (int i = 0; i < (int)includes.size(); i++)
+	std::string message = Simcore->LastError;
+	int loc = message.find_last_of(":");
+
+	std::string result = message.substr(loc + 1);
+	TrimString(result);
+	return ScriptError(result);
+}
+
+int ScriptProcessor::ScriptWarning(std::string message)
+{
+	return ScriptError(message, true);
+}
+
+//expression parser used by ScriptProcessor::Evaluate
+//script math has no operator precedence, so all binary operators share one binding power
+//and evaluate left to right, as the string-based calculation always has
+struct CalcParser
+{
+	std::string_view data;
+	size_t pos;
+	int operations;
+
+	char Peek();
+	bool ParseNumber(Real &value);
+	bool ParseOperand(Real &value, Real &raw);
+	bool ParseExpression(int min_power, Real &value, Real &raw);
+};
+
+static int BindingPower(char op)
+{
+	//get binding power of a binary operator, or 0 if not an operator
+
+	if (op == '+' || op == '-' || op == '*' || op == '/' || op == '^')
+		return 1;
+	return 0;
+}
+
+static Real RoundResult(Real value)
+{
+	//round a result the same way as storing it with TruncateNumber(value, 6) and reading it back,
+	//to match the string-based calculation when results are used in further operations
+
+	if ((int)value == value)
+		return value;
+
+	char buffer[512];
+	snprintf(buffer, sizeof(buffer), "%.6f", (double)value);
+	return (Real)atof(buffer);
+}
+
+char CalcParser::Peek()
+{
+	//skip whitespace and return the next character, or 0 at the end
+
+	while (pos < data.size() && data[pos] == ' ')
+		pos++;
+
+	if (pos < data.size())
+		return data[pos];
+	return 0;
+}
+
+bool CalcParser::ParseNumber(Real &value)
+{
+	//parse a decimal number with an optional sign, which must end with a digit
+
+	size_t start = pos;
+	size_t digits = 0;
+
+	if (pos < data.size() && data[pos] == '-')
+		pos++;
+
+	while (pos < data.size() && IsNumeric(data[pos]) == true)
 	{
-		if (linenum < includes[i].start_line)
-			break;
+		pos++;
+		digits++;
+	}
 
-		//line is part of an included file
-		if (linenum >= includes[i].start_line && linenum <= includes[i].end_line)
+	if (pos < data.size() && data[pos] == '.')
+	{
+		pos++;
+		size_t decimals = 0;
+		while (pos < data.size() && IsNumeric(data[pos]) == true)
 		{
-			IsInclude = true;
-			IncludeFile = includes[i].filename;
-			newlinenum = linenum - includes[i].start_line;
-			parent = i;
-			linenum_start = includes[i].start_line;
+			pos++;
+			decimals++;
 		}
+		if (decimals == 0)
+			return false;
+		digits += decimals;
+	}
 
-		//function call line is part of an included file
-		if (CheckFunctionCall == true)
-		{
-			if (function_line >= includes[i].start_line && function_line <= includes[i].end_line)
-			{
-				IsIncludeFunction = true;
-				IncludeFunctionFile = includes[i].filename;
-				newfunction_line = function_line - includes[i].start_line;
-				parent_f = i;
-				function_line_start = includes[i].start_line;
-			}
-		}
+	if (digits == 0)
+		return false;
+
+	//copy number to a terminated buffer for conversion
+	char buffer[64];
+	size_t length = pos - start;
+	if (length >= sizeof(buffer))
+		return false;
+	data.copy(buffer, length, start);
+	buffer[length] = 0;
+
+	value = (Real)atof(buffer);
+	return true;
+}
+
+bool CalcParser::ParseOperand(Real &value, Real &raw)
+{
+	//parse a number or a parenthesized expression
+
+	if (Peek() == '(')
+	{
+		pos++;
+		if (ParseExpression(0, value, raw) == false)
+			return false;
+		if (Peek() != ')')
+			return false;
+		pos++;
+		return true;
 	}
 
-	linenum = newlinenum;
-	function_line = newfunction_line;
+	if (ParseNumber(value) == false)
+		return false;
+	raw = value;
+	return true;
+}
+
+bool CalcParser::ParseExpression(int min_power, Real &value, Real &raw)
+{
+	//parse an operand followed by any binary operations
+	//value receives the result as used in further operations, raw receives the unrounded result
 
-	//calculate number of included lines before the current line
-	for (int i = 0; i < (int)includes.size(); i++)
+	if (ParseOperand(value, raw) == false)
+		return false;
+
+	while (true)
 	{
-		if (includes[i].parent == parent)
-		{
-			if (linenum + linenum_start > includes[i].end_line)
-				included_lines += includes[i].end_line - includes[i].start_line;
-		}
+		char op = Peek();
+		int power = BindingPower(op);
+		if (power == 0 || power <= min_power)
+			break;
+		pos++;
 
-		if (CheckFunctionCall == true)
+		Real second, second_raw;
+		if (ParseExpression(power, second, second_raw) == false)
+			return false;
+
+		Real first = value;
+		if (op == '+')
+			raw = first + second;
+		else if (op == '-')
+			raw = first - second;
+		else if (op == '*')
+			raw = first * second;
+		else if (op == '/')
 		{
-			if (includes[i].parent == parent_f)
-			{
-				if (function_line + function_line_start > includes[i].end_line)
-					included_lines_f += includes[i].end_line - includes[i].start_line;
-			}
+			//leave division by zero to the string-based calculation, which reports it
+			if (second == 0)
+				return false;
+			raw = first / second;
 		}
-	}
+		else
+			raw = powf(first, second);
 
-	//have line numbers start from 1 instead of 0
-	linenum += 1;
-	function_line += 1;
+		if (std::isfinite(raw) == false)
+			return false;
 
-	//return values
-	LineNumber = linenum - included_lines;
+		value = RoundResult(raw);
+		operations++;
+	}
 
-	if (InFunction > 0)
-		FunctionLine = function_line - included_lines_f;
+	return true;
 }
 
-int ScriptProcessor::ScriptError()
+bool ScriptProcessor::Evaluate(const std::string_view &expression, Real &result, Real &raw)
 {
-	//return automatic error message from contents of the simulator engine's LastError string
+	//evaluates a numeric expression without allocating memory
+	//returns false if the expression contains anything other than numbers, operators and parenthesis,
+	//if an error occurs, or if no operations are performed, so the caller can fall back to CalcLegacy()
 
-	std::string message = Simcore->LastError;
-	int loc = message.find_last_of(":");
+	CalcParser parser;
+	parser.data = expression;
+	parser.pos = 0;
+	parser.operations = 0;
 
-	std::string result = message.substr(loc + 1);
-	TrimString(result);
-	return ScriptError(result);
-}
+	if (parser.ParseExpression(0, result, raw) == false)
+		return false;
 
-int ScriptProcessor::ScriptWarning(std::string message)
-{
-	return ScriptError(message, true);
+	//fail if there is remaining data, such as an unmatched parenthesis
+	if (parser.Peek() != 0)
+		return false;
+
+	return parser.operations > 0;
 }
 
 std::string ScriptProcessor::Calc(const std::string &expression)
@@ -683,6 +1062,48 @@ std::string ScriptProcessor::Calc(const std::string &expression)
 	//supports multiple and nested operations (within parenthesis)
 	//^ character is used as a 'power of' operator
 
+	CalcError = false;
+
+	//check for parenthesis or operators, ignoring a leading sign
+	bool math = false;
+	for (size_t i = 0; i < expression.size(); i++)
+	{
+		char character = expression[i];
+		if (character == '(' || (i > 0 && (character == '+' || character == '-' || character == '*' || character == '/' || character == '^')))
+		{
+			math = true;
+			break;
+		}
+	}
+
+	if (math == false)
+	{
+		//return value with whitespace removed, if not a math operation
+		std::string result = expression;
+		result.erase(std::remove(result.begin(), result.end(), ' '), result.end());
+		TrimString(result);
+		return result;
+	}
+
+	//evaluate plain numeric expressions directly
+	Real value, raw;
+	if (Evaluate(expression, value, raw) == true)
+	{
+		//format the same way as TruncateNumber(raw, 6), without a string stream
+		char buffer[512];
+		snprintf(buffer, sizeof(buffer), "%.*f", ((int)raw == raw) ? 0 : 6, (double)raw);
+		return buffer;
+	}
+
+	//otherwise use string-based calculation, which handles text and reports errors
+	return CalcLegacy(expression);
+}
+
+std::string ScriptProcessor::CalcLegacy(const std::string &expression)
+{
+	//performs a calculation operation on a string, by rewriting the string for each operation
+	//this handles expressions that Evaluate() does not, such as mixed text and errors
+
 	int temp1;
 	std::string tmpcalc = expression;
 	std::string one;
@@ -719,7 +1140,7 @@ std::string ScriptProcessor::Calc(const std::string &expression)
 			{
 				//call function recursively
 				std::string newdata;
-				newdata = Calc(tmpcalc.substr(start + 1, end - start - 1));
+				newdata = CalcLegacy(tmpcalc.substr(start + 1, end - start - 1));
 
 				if (CalcError == true)
 					return tmpcalc;
@@ -793,7 +1214,7 @@ std::string ScriptProcessor::Calc(const std::string &expression)
 		if (operators > 1)
 		{
 			std::string newdata;
-			newdata = Calc(tmpcalc.substr(0, end));
+			newdata = CalcLegacy(tmpcalc.substr(0, end));
 
 			if (CalcError == true)
 				return tmpcalc;
@@ -938,8 +1359,7 @@ void ScriptProcessor::StoreCommand(Object *object)
 	object->linenum = LineNumber;
 	object->includefile = IncludeFile;
 
-	TrimString(BuildingData[line]);
-	object->command = BuildingData[line];
+	object->command = TrimStringCopy(source->GetText(line));
 	object->command_processed = LineData;
 	object->context = config->Context;
 	std::string current;
@@ -1025,7 +1445,7 @@ void ScriptProcessor::ProcessRunloop()
 			InFunction += 1;
 
 			FunctionData data;
-			data.CallLine = BuildingData.size();
+			data.CallLine = (int)source->GetSize();
 			data.Name = "runloop";
 
 			in_runloop = true;
@@ -1199,14 +1619,25 @@ bool ScriptProcessor::ProcessFunctionParameters()
 	}
 	else if (show_percent == true)
 	{
-		int percent = ((Real)line / (Real)BuildingData.size()) * 100.0;
+		int percent = ((Real)line / (Real)source->GetSize()) * 100.0;
 		std::string percent_s = ToString(percent);
 		int marker = percent / 10;
 		if (marker > progress_marker)
 		{
 			progress_marker = marker;
 			engine->Report(percent_s + "%");
-			return engine->UpdateProgress(percent);
+		}
+
+		//update the progress bar when the percentage changes, at most every 100 ms
+		if (percent != progress_percent)
+		{
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			if (now - progress_time >= std::chrono::milliseconds(100))
+			{
+				progress_percent = percent;
+				progress_time = now;
+				return engine->UpdateProgress(percent);
+			}
 		}
 	}
 	return true;
@@ -1247,21 +1678,14 @@ void ScriptProcessor::ProcessUserVariables()
 			str = LineData.substr(loc1 + 1, loc2 - loc1 - 1);
 			TrimString(str);
 
-			bool found = false;
-			for (size_t i = 0; i < variables.size(); i++)
+			int index = FindVariable(str);
+			if (index != -1)
 			{
-				if (variables[i].name == str)
-				{
-					found = true;
-
-					//replace all occurrences of the variable with it's value
-					ReplaceAll(LineData, "%" + str + "%", variables[i].value);
-					startpos = loc1;
-					break;
-				}
+				//replace all occurrences of the variable with it's value
+				ReplaceAll(LineData, "%" + str + "%", variables[index].value);
+				startpos = loc1;
 			}
-
-			if (found == false)
+			else
 				startpos = loc2 + 1;
 		}
 		else
@@ -1269,6 +1693,99 @@ void ScriptProcessor::ProcessUserVariables()
 	} while (true);
 }
 
+bool ScriptProcessor::ExpandVariables(const CompiledLine &compiled, bool &tag, bool &markers, bool &floors)
+{
+	//build the line text from a compiled line's segments, looking up each variable reference in the variable slots
+	//unknown variables are left in place, for later passes such as floor and extent variables
+	//returns false if a variable value contains markers, which need a full ProcessUserVariables() pass
+
+	LineData.clear();
+	markers = false;
+	floors = compiled.floors;
+
+	for (size_t i = 0; i < compiled.segments.size(); i++)
+	{
+		const Segment &segment = compiled.segments[i];
+
+		int index = -1;
+		if (segment.variable >= 0 && segment.variable < (int)variable_slots.size())
+			index = variable_slots[segment.variable];
+
+		if (index == -1)
+		{
+			//literal text or unknown variable
+			LineData.append(compiled.text, segment.start, segment.length);
+			if (segment.variable >= 0)
+				markers = true;
+			continue;
+		}
+
+		const std::string &value = variables[index].value;
+		if (value.find("%") != std::string::npos)
+			return false;
+
+		if (floors == false)
+			floors = HasFloorReference(value);
+
+		LineData.append(value);
+	}
+
+	tag = (LineData.size() > 0 && LineData[0] == '<');
+
+	//a floor reference can also be formed from a value and the text around it
+	if (floors == false && compiled.segments.size() > 1)
+		floors = HasFloorReference(LineData);
+
+	return true;
+}
+
+void ScriptProcessor::SetVariable(const std::string &name, const std::string &value)
+{
+	//set a user variable, creating it if needed
+
+	int index = FindVariable(name);
+	if (index >= 0)
+	{
+		variables[index].value = value;
+		return;
+	}
+
+	VariableMap variable;
+	variable.name = name;
+	variable.value = value;
+	variable.id = GetVariableID(name, true);
+	variables.emplace_back(variable);
+
+	if (variable.id >= (int)variable_slots.size())
+		variable_slots.resize(variable.id + 1, -1);
+	variable_slots[variable.id] = (int)variables.size() - 1;
+}
+
+int ScriptProcessor::FindVariable(const std::string &name)
+{
+	//get the index of a user variable, or -1 if not found
+
+	int id = GetVariableID(name, false);
+	if (id < 0 || id >= (int)variable_slots.size())
+		return -1;
+
+	return variable_slots[id];
+}
+
+void ScriptProcessor::RemoveVariable(int index)
+{
+	//remove a user variable, and update the slots of the variables after it
+
+	if (index < 0 || index >= (int)variables.size())
+		return;
+
+	variable_slots[variables[index].id] = -1;
+	variables.erase(variables.begin() + index);
+
+	for (size_t i = index; i < variables.size(); i++)
+		variable_slots[variables[i].id] = (int)i;
+}
+
 int ScriptProcessor::ProcessSections()
 {
 	//////////////////////
@@ -1293,7 +1810,7 @@ int ScriptProcessor::ProcessSections()
 		engine->Report("Exiting building script");
 		IsFinished = true;
 		show_percent = false;
-		line = (int)BuildingData.size(); //jump to end of script
+		line = (int)source->GetSize(); //jump to end of script
 		return sExit; //exit data file parser
 	}
 	if (StartsWithNoCase(LineData, "<break>"))
@@ -1316,10 +1833,7 @@ int ScriptProcessor::ProcessSections()
 		std::string includefile = LineData.substr(9, endloc - 9);
 		TrimString(includefile);
 
-		//delete current line
-		BuildingData.erase(BuildingData.begin() + line);
-
-		//insert file at current line
+		//replace current line with the file
 		std::string filename = Simcore->GetUtility()->VerifyFile(includefile);
 		bool result = LoadDataFile(filename, true, line);
 		if (result == false)
@@ -1368,9 +1882,9 @@ int ScriptProcessor::ProcessSections()
 		}
 
 		//skip to end of function
-		for (int i = line + 1; i < (int)BuildingData.size(); i++)
+		for (int i = line + 1; i < (int)source->GetSize(); i++)
 		{
-			if (SetCaseCopy(BuildingData[i].substr(0, 13), false) == "<endfunction>")
+			if (SetCaseCopy(source->GetText(i).substr(0, 13), false) == "<endfunction>")
 			{
 				line = i;
 				break;
@@ -1970,13 +2484,10 @@ int ScriptProcessor::ProcessForLoops()
 		TrimString(it);
 
 		//check for existence of iterator variable
-		for (int i = 0; i < variables.size(); i++)
+		if (FindVariable(it) != -1)
 		{
-			if (variables[i].name == it)
-			{
-				ScriptError("Iterator variable in use");
-				return sError;
-			}
+			ScriptError("Iterator variable in use");
+			return sError;
 		}
 
 		//get low and high range markers
@@ -1992,10 +2503,7 @@ int ScriptProcessor::ProcessForLoops()
 		}
 
 		//set new iterator variable
-		VariableMap var;
-		var.name = it;
-		var.value = ToString(RangeL);
-		variables.emplace_back(var);
+		SetVariable(it, ToString(RangeL));
 
 		//set up for loop
 		ForInfo info;
@@ -2027,22 +2535,18 @@ int ScriptProcessor::ProcessForLoops()
 				end = true;
 		}
 
-		for (int i = 0; i < variables.size(); i++)
+		int index = FindVariable(info.iterator);
+		if (index != -1)
 		{
-			if (variables[i].name == info.iterator)
+			if (end == false)
 			{
-				if (end == false)
-				{
-					//put iterator into variable
-					variables[i].value = ToString(info.i);
-					break;
-				}
-				else
-				{
-					//remove iterator variable
-					variables.erase(variables.begin() + i);
-					break;
-				}
+				//put iterator into variable
+				variables[index].value = ToString(info.i);
+			}
+			else
+			{
+				//remove iterator variable
+				RemoveVariable(index);
 			}
 		}
 
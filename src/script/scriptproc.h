@@ -23,6 +23,8 @@
 #ifndef SCRIPTPROCESSOR_H
 #define SCRIPTPROCESSOR_H
 
+#include <string_view>
+#include <chrono>
 #include "vm.h"
 
 namespace Skyscraper {
@@ -44,6 +46,7 @@ public:
 	class VehicleSection;
 	class ControllerSection;
 	class CallStationSection;
+	class Source;
 
 	struct FunctionInfo
 	{
@@ -51,6 +54,27 @@ public:
 		int line;
 	};
 
+	//part of a compiled line, either literal text or a user variable reference
+	struct Segment
+	{
+		size_t start; //position in the line text
+		size_t length; //length in the line text, including variable markers
+		int variable; //variable name ID, or -1 for literal text
+	};
+
+	//script line, compiled when loaded
+	//variable references are resolved to name IDs, which are looked up in the processor's variable slots
+	//when the line is run; expressions are still evaluated by the section handlers after expansion
+	struct CompiledLine
+	{
+		std::string text; //trimmed line text, with comments removed
+		bool tag; //true if the line starts with a tag, such as a section or For loop marker
+		bool variables; //true if the line contains variable markers
+		bool floors; //true if the line contains floor object references
+		bool params; //true if the line contains function parameter markers
+		std::vector<Segment> segments; //line text split at variable markers, if the line has any
+	};
+
 	explicit ScriptProcessor(EngineContext *instance);
 	~ScriptProcessor();
 	bool Run();
@@ -70,6 +94,9 @@ public:
 	bool InRunloop() {return in_runloop;}
 	size_t GetFunctionCount();
 	FunctionInfo GetFunctionInfo(size_t index);
+	std::string Calc(const std::string &expression);
+	std::string CalcLegacy(const std::string &expression);
+	static bool Evaluate(const std::string_view &expression, Real &result, Real &raw);
 
 	bool IsFinished;
 
@@ -88,18 +115,26 @@ public:
 	{
 		std::string name;
 		std::string value;
+		int id; //variable name ID
 	};
 
 	std::vector<VariableMap> variables; //named user variables
+	void SetVariable(const std::string &name, const std::string &value);
+	int FindVariable(const std::string &name);
+	void RemoveVariable(int index);
 	std::vector<std::string> nonexistent_files; //missing files list
 
 	bool getfloordata;
 	int line; //line number
 	std::string LineData; //line text
 	bool NoModels; //if true, disable models for DirectX11 support
+	int LoadBudget; //milliseconds of script lines to run per frame while loading, or 0 for no limit
 
 private:
 
+	bool RunLine();
+	bool ExpandVariables(const CompiledLine &compiled, bool &tag, bool &markers, bool &floors);
+
 	::SBS::SBS *Simcore;
 	EngineContext *engine;
 
@@ -125,7 +160,7 @@ private:
 
 	::SBS::Wall *wall;
 	int startpos;
-	std::vector<std::string> BuildingData;
+	Source *source; //loaded script lines, including included files
 	std::vector<std::string> BuildingDataOrig;
 	int InFunction;
 	std::vector<FunctionData> FunctionStack;
@@ -134,13 +169,15 @@ private:
 	bool CalcError;
 	bool show_percent;
 	int progress_marker;
+	int progress_percent; //last percent sent to the progress bar
+	std::chrono::steady_clock::time_point progress_time; //time of the last progress bar update
 	bool in_runloop;
+	std::vector<int> variable_slots; //index of each variable name ID in the variables array, or -1
 	bool processed_runloop;
 
 	int ScriptError(std::string message, bool warning = false);
 	int ScriptError();
 	int ScriptWarning(std::string message);
-	std::string Calc(const std::string &expression);
 	void StoreCommand(::SBS::Object *object);
 	bool FunctionProc();
 	void CheckFile(const std::string &filename);
@@ -156,14 +193,6 @@ private:
 
 	std::vector<FunctionInfo> functions; //stored functions
 
-	struct IncludeInfo
-	{
-		std::string filename;
-		int start_line;
-		int end_line;
-		int parent;
-	};
-
 	struct ForInfo
 	{
 		std::string iterator;
@@ -173,7 +202,6 @@ private:
 		int end;
 	};
 
-	std::vector<IncludeInfo> includes; //stored include mappings
 	std::vector<ForInfo> ForLoops;
 };
 
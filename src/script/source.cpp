@@ -0,0 +1,198 @@
+/*
+	Skyscraper 2.1 - Script Processor - Script Source
+	Copyright (C)2003-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <algorithm>
+#include "globals.h"
+#include "sbs.h"
+#include "vm.h"
+#include "scriptproc.h"
+#include "source.h"
+
+using namespace SBS;
+
+namespace Skyscraper {
+
+ScriptProcessor::Source::Source()
+{
+	size = 0;
+	cursor = 0;
+}
+
+void ScriptProcessor::Source::Clear()
+{
+	//remove all loaded lines
+
+	pieces.clear();
+	starts.clear();
+	includes.clear();
+	size = 0;
+	cursor = 0;
+}
+
+void ScriptProcessor::Source::Append(std::shared_ptr<const CompiledFile> file)
+{
+	//add the lines of a file to the end of the main script
+
+	if (!file || file->lines.empty())
+		return;
+
+	Piece piece;
+	piece.file = file;
+	piece.first = 0;
+	piece.count = file->lines.size();
+	piece.include = -1;
+
+	pieces.emplace_back(piece);
+	starts.emplace_back(size);
+	size += piece.count;
+}
+
+bool ScriptProcessor::Source::Insert(size_t line, std::shared_ptr<const CompiledFile> file, const std::string &filename)
+{
+	//replace a script line, such as an include tag, with the lines of an included file.
+	//only the piece containing the line is split, so the cost doesn't depend on the number of lines
+
+	if (!file || line >= size)
+		return false;
+
+	size_t index = FindPiece(line);
+	Piece piece = pieces[index];
+	size_t offset = line - starts[index];
+
+	std::vector<Piece> split;
+
+	//lines before the replaced line
+	if (offset > 0)
+	{
+		Piece before = piece;
+		before.count = offset;
+		split.emplace_back(before);
+	}
+
+	//included lines
+	if (file->lines.empty() == false)
+	{
+		Piece inserted;
+		inserted.file = file;
+		inserted.first = 0;
+		inserted.count = file->lines.size();
+		inserted.include = (int)includes.size();
+		split.emplace_back(inserted);
+	}
+
+	//lines after the replaced line
+	if (offset + 1 < piece.count)
+	{
+		Piece after = piece;
+		after.first += offset + 1;
+		after.count -= offset + 1;
+		split.emplace_back(after);
+	}
+
+	includes.emplace_back(filename);
+
+	pieces.erase(pieces.begin() + index);
+	pieces.insert(pieces.begin() + index, split.begin(), split.end());
+	size = size - 1 + file->lines.size();
+
+	UpdateStarts(index);
+	cursor = 0;
+	return true;
+}
+
+const ScriptProcessor::CompiledLine& ScriptProcessor::Source::GetLine(size_t line)
+{
+	//get a precompiled script line; line must be less than GetSize()
+
+	size_t index = FindPiece(line);
+	const Piece &piece = pieces[index];
+	return piece.file->compiled[piece.first + line - starts[index]];
+}
+
+const std::string& ScriptProcessor::Source::GetText(size_t line)
+{
+	//get the original text of a script line; line must be less than GetSize()
+
+	size_t index = FindPiece(line);
+	const Piece &piece = pieces[index];
+	return piece.file->lines[piece.first + line - starts[index]];
+}
+
+bool ScriptProcessor::Source::GetOrigin(int line, std::string &filename, int &file_line)
+{
+	//get the file and line number (starting from 1) that a script line was loaded from
+	//returns true if the line is from an included file, with the included filename
+
+	filename = "";
+	file_line = line + 1;
+
+	if (line < 0 || pieces.empty())
+		return false;
+
+	//lines past the end, such as the runloop return line, follow the last piece
+	size_t index = pieces.size() - 1;
+	if ((size_t)line < size)
+		index = FindPiece(line);
+
+	const Piece &piece = pieces[index];
+	file_line = int(piece.first + (line - starts[index])) + 1;
+
+	if (piece.include < 0)
+		return false;
+
+	filename = includes[piece.include];
+	return true;
+}
+
+size_t ScriptProcessor::Source::FindPiece(size_t line)
+{
+	//find the piece containing a script line
+
+	//lines are mostly read in order, so check the last piece found and the one after it first
+	if (cursor < pieces.size() && line >= starts[cursor])
+	{
+		if (line < starts[cursor] + pieces[cursor].count)
+			return cursor;
+		if (cursor + 1 < pieces.size() && line < starts[cursor + 1] + pieces[cursor + 1].count)
+			return ++cursor;
+	}
+
+	cursor = std::upper_bound(starts.begin(), starts.end(), line) - starts.begin() - 1;
+	return cursor;
+}
+
+void ScriptProcessor::Source::UpdateStarts(size_t index)
+{
+	//recalculate piece start lines, from the specified piece on
+
+	starts.resize(pieces.size());
+
+	for (size_t i = index; i < pieces.size(); i++)
+	{
+		if (i == 0)
+			starts[i] = 0;
+		else
+			starts[i] = starts[i - 1] + pieces[i - 1].count;
+	}
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+	Skyscraper 2.1 - Script Processor - Script Source
+	Copyright (C)2003-2025 Ryan Thoryk
+	https://www.skyscrapersim.net
+	https://sourceforge.net/projects/skyscraper/
+	Contact - ryan@skyscrapersim.net
+
+	This program is free software; you can redistribute it and/or
+	modify it under the terms of the GNU General Public License
+	as published by the Free Software Foundation; either version 2
+	of the License, or (at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with this program; if not, write to the Free Software
+	Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#ifndef SCRIPTSOURCE_H
+#define SCRIPTSOURCE_H
+
+#include <memory>
+
+namespace Skyscraper {
+
+//compiled building file, shared between loads of the same file contents
+struct CompiledFile
+{
+	std::vector<std::string> lines; //original file lines
+	std::vector<ScriptProcessor::CompiledLine> compiled; //compiled lines
+};
+
+//loaded script source, stored as a table of pieces that reference ranges of compiled files,
+//so that included files are spliced in without copying or moving the lines around them
+class ScriptProcessor::Source
+{
+public:
+	Source();
+	void Clear();
+	size_t GetSize() { return size; }
+	void Append(std::shared_ptr<const CompiledFile> file);
+	bool Insert(size_t line, std::shared_ptr<const CompiledFile> file, const std::string &filename);
+	const CompiledLine& GetLine(size_t line);
+	const std::string& GetText(size_t line);
+	bool GetOrigin(int line, std::string &filename, int &file_line);
+	size_t GetPieceCount() { return pieces.size(); }
+
+private:
+
+	struct Piece
+	{
+		std::shared_ptr<const CompiledFile> file;
+		size_t first; //first line in the file
+		size_t count; //number of lines
+		int include; //index of the included filename, or -1 for the main script
+	};
+
+	size_t FindPiece(size_t line);
+	void UpdateStarts(size_t index);
+
+	std::vector<Piece> pieces;
+	std::vector<size_t> starts; //script line of the start of each piece
+	std::vector<std::string> includes; //included filenames
+	size_t size; //total number of lines
+	size_t cursor; //last piece found, for sequential access
+};
+
+}
+
+#endif
@@ -429,7 +429,7 @@ void EngineContext::StartSim(const Vector3 &position, const Vector3 &rotation)
 		Simcore->Verbose = true;
 
 	//Pause for 2 seconds, if first instance
-	if (instance == 0)
+	if (instance == 0 && vm->Headless == false)
 	{
 		vm->Pause = true; //briefly pause frontend to prevent debug panel calls to engine
 #ifdef USING_WX
@@ -458,7 +458,8 @@ void EngineContext::UnloadSim()
 #ifndef DISABLE_SOUND
 	//reset fmod reverb
 	FMOD_REVERB_PROPERTIES prop = FMOD_PRESET_GENERIC;
-	fmodsystem->setReverbProperties(0, &prop);
+	if (fmodsystem)
+		fmodsystem->setReverbProperties(0, &prop);
 #endif
 
 	//unload script processor
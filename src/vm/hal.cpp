@@ -30,6 +30,7 @@
 #include <OgreBitesConfigDialog.h>
 #include <OgreSGTechniqueResolverListener.h>
 #include <OgreOverlaySystem.h>
+#include <OgreDefaultHardwareBufferManager.h>
 
 #ifndef DISABLE_SOUND
 	//FMOD
@@ -73,6 +74,8 @@ HAL::HAL(VM *vm)
 	mRoot = 0;
 	mRenderWindow = 0;
 	mSceneMgr = 0;
+	mBufferManager = 0;
+	mTextureManager = 0;
 	sound = 0;
 	channel = 0;
 	soundsys = 0;
@@ -119,6 +122,15 @@ HAL::~HAL()
 	delete mRoot;
 #endif
 
+	//delete headless resource managers
+	if (mTextureManager)
+		delete mTextureManager;
+	mTextureManager = 0;
+
+	if (mBufferManager)
+		delete mBufferManager;
+	mBufferManager = 0;
+
 	delete logger;
 }
 
@@ -408,6 +420,10 @@ bool HAL::Initialize(const std::string &data_path, Ogre::Root *root, Ogre::Overl
 		return ReportFatalError("Error creating overlay system\nDetails: " + e.getDescription());
 	}
 
+	//in headless mode, skip render system setup
+	if (vm->Headless == true)
+		return InitializeHeadless();
+
 	//configure render system
 	try
 	{
@@ -471,24 +487,57 @@ bool HAL::Initialize(const std::string &data_path, Ogre::Root *root, Ogre::Overl
 	return true;
 }
 
+bool HAL::InitializeHeadless()
+{
+	//initialize OGRE without a render system, for simulation-only runs
+
+	try
+	{
+		Report("");
+		Report("Initializing OGRE in headless mode...");
+
+		//use system memory buffers and placeholder textures, since no render system will create them
+		mBufferManager = new Ogre::DefaultHardwareBufferManager();
+		mTextureManager = new Ogre::DefaultTextureManager();
+
+		//normally performed by Root::initialise()
+		Ogre::MaterialManager::getSingleton().initialise();
+	}
+	catch (Ogre::Exception &e)
+	{
+		return ReportFatalError("Error initializing headless mode\nDetails: " + e.getDescription());
+	}
+
+	return true;
+}
+
 bool HAL::LoadSystem(const std::string &data_path, Ogre::RenderWindow *renderwindow)
 {
 	//load HAL system resources
 
-	if (!renderwindow)
+	//a render window is only optional in headless mode
+	if (!renderwindow && vm->Headless == false)
 		return false;
 
 	mRenderWindow = renderwindow;
 
-	//get renderer info
-	Renderer = mRoot->getRenderSystem()->getCapabilities()->getRenderSystemName();
+	if (vm->Headless == false)
+	{
+		//get renderer info
+		Renderer = mRoot->getRenderSystem()->getCapabilities()->getRenderSystemName();
 
-	//shorten name
-	size_t loc = Renderer.find("Rendering Subsystem");
-	Renderer = Renderer.substr(0, loc - 1);
+		//shorten name
+		size_t loc = Renderer.find("Rendering Subsystem");
+		Renderer = Renderer.substr(0, loc - 1);
 
-	//get graphics card device information
-	GPUDevice = mRoot->getRenderSystem()->getCapabilities()->getDeviceName();
+		//get graphics card device information
+		GPUDevice = mRoot->getRenderSystem()->getCapabilities()->getDeviceName();
+	}
+	else
+	{
+		Renderer = "None";
+		GPUDevice = "None";
+	}
 
 	//load resource configuration
 	Ogre::ConfigFile cf;
@@ -562,9 +611,11 @@ bool HAL::LoadSystem(const std::string &data_path, Ogre::RenderWindow *renderwin
 		}
 	}
 
-	std::string renderer = mRoot->getRenderSystem()->getName();
+	std::string renderer;
+	if (mRoot->getRenderSystem())
+		renderer = mRoot->getRenderSystem()->getName();
 
-	if (renderer != "Direct3D9 Rendering Subsystem" && renderer != "OpenGL Rendering Subsystem" && renderer != "Metal Rendering Subsystem")
+	if (vm->Headless == false && renderer != "Direct3D9 Rendering Subsystem" && renderer != "OpenGL Rendering Subsystem" && renderer != "Metal Rendering Subsystem")
 		RTSS = true;
 
 	if (RTSS == true)
@@ -644,6 +695,8 @@ bool HAL::LoadSystem(const std::string &data_path, Ogre::RenderWindow *renderwin
 #ifndef DISABLE_SOUND
 	//initialize FMOD (sound)
 	DisableSound = GetConfigBool(configfile, "Skyscraper.Frontend.DisableSound", false);
+	if (vm->Headless == true)
+		DisableSound = true;
 	if (DisableSound == false)
 	{
 		Report("");
@@ -689,22 +742,26 @@ bool HAL::LoadSystem(const std::string &data_path, Ogre::RenderWindow *renderwin
 #endif
 		Report("Sound Disabled");
 
-	try
-	{
-		mTrayMgr = new OgreBites::TrayManager("InterfaceName", mRenderWindow);
-	}
-	catch (Ogre::Exception &e)
+	if (mRenderWindow)
 	{
-		ReportFatalError("Error starting tray manager:\nDetails: " + e.getDescription());
-	}
+		try
+		{
+			mTrayMgr = new OgreBites::TrayManager("InterfaceName", mRenderWindow);
+		}
+		catch (Ogre::Exception &e)
+		{
+			ReportFatalError("Error starting tray manager:\nDetails: " + e.getDescription());
+		}
 
-	if (mTrayMgr)
-	{
-		mTrayMgr->hideCursor();
+		if (mTrayMgr)
+		{
+			mTrayMgr->hideCursor();
+		}
 	}
 
 	//initialize editor
-	vm->GetEditor()->Initialize();
+	if (vm->Headless == false)
+		vm->GetEditor()->Initialize();
 
 	//report hardware concurrency
 	int c = std::thread::hardware_concurrency();
@@ -39,6 +39,8 @@ namespace Ogre {
 	class ConfigFile;
 	class OverlaySystem;
 	class ImGuiOverlay;
+	class DefaultHardwareBufferManager;
+	class DefaultTextureManager;
 }
 
 namespace FMOD {
@@ -107,6 +109,10 @@ private:
 	Ogre::SceneManager* mSceneMgr;
 	Ogre::OverlaySystem* mOverlaySystem;
 
+	//software resource managers, used in headless mode
+	Ogre::DefaultHardwareBufferManager* mBufferManager;
+	Ogre::DefaultTextureManager* mTextureManager;
+
     //OGRE log manager
 	Ogre::LogManager* logger;
 	Ogre::Log* log;
@@ -121,6 +127,7 @@ private:
 	bool ReportError(const std::string &message);
 	bool ReportFatalError(const std::string &message);
 	Ogre::ConfigFile* ConfigLoad(const std::string &filename, bool delete_after_use = false);
+	bool InitializeHeadless();
 	void messageLogged(const std::string &message, Ogre::LogMessageLevel lml, bool maskDebug, const std::string &logName, bool &skipThisMessage);
 
     //stats
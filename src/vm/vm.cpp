@@ -72,6 +72,7 @@ VM::VM()
 	CutFloors = false;
 	first_run = true;
 	Verbose = false;
+	Headless = false;
 	showconsole = false;
 	vmconsole = 0;
 	loadstart = false;
@@ -772,16 +773,19 @@ VMStatus VM::Run(std::vector<EngineContext*> &newengines)
 	//update running state;
 	running = true;
 
-	//update Caelum
-	skysystem->UpdateSky();
+	if (Headless == false)
+	{
+		//update Caelum
+		skysystem->UpdateSky();
 
-	//update OpenXR
-	hal->UpdateOpenXR();
+		//update OpenXR
+		hal->UpdateOpenXR();
 
-	//render graphics
-	result = hal->Render();
-	if (!result)
-		return VMSTATUS_FATAL;
+		//render graphics
+		result = hal->Render();
+		if (!result)
+			return VMSTATUS_FATAL;
+	}
 
 	//handle a building reload
 	HandleReload();
@@ -919,7 +923,8 @@ EngineContext* VM::Initialize(bool clear, EngineContext *parent, const Vector3 &
 	//clear screen
 	try
 	{
-		hal->GetRenderWindow()->update();
+		if (hal->GetRenderWindow())
+			hal->GetRenderWindow()->update();
 	}
 	catch (...)
 	{
@@ -1108,7 +1113,7 @@ bool VM::ReportMissingFiles(std::vector<std::string> &missing_files)
 {
 	//report missing files
 #ifdef USING_WX
-	if (gui)
+	if (gui && Headless == false)
 		return gui->ReportMissingFiles(missing_files);
 #endif
 	return true;
@@ -148,6 +148,7 @@ public:
 	bool Pause; //pause simulator
 	bool CutLandscape, CutBuildings, CutExternal, CutFloors;
 	bool Verbose; //verbose mode
+	bool Headless; //run without a render window, GUI or sound (benchmark mode)
 	bool showconsole;
 	bool loadstart; //true if starting an engine load
 	bool unloaded;
@@ -602,8 +602,27 @@ bool VMConsole::ProcessCommand(const std::string &command, Ogre::StringVector &p
 			if (params[0] == "-a")
 				SBS::enable_advanced_profiling = true;
 		}
+
+		//export captured zones as a Chrome trace file
+		if (params.size() == 1 && params[0].substr(0, 3) == "-e ")
+		{
+			std::string filename = params[0].substr(3);
+			SBS::TrimString(filename);
+
+			if (SBS::ProfileTrace::Export(filename) == true)
+				Report("Trace written to " + filename);
+			else
+				ReportError("Error writing trace to " + filename);
+
+			consoleresult.ready = false;
+			consoleresult.threadwait = false;
+			return true;
+		}
+
 		std::string output;
 		SBS::ProfileManager::dumpAll(output);
+		output.append("\n");
+		SBS::ProfileTrace::Get_Summary(output);
 		Report(output, "green");
 		consoleresult.ready = false;
 		consoleresult.threadwait = false;
@@ -815,6 +834,7 @@ bool VMConsole::ProcessCommand(const std::string &command, Ogre::StringVector &p
 			Report("uptime [engine_number] - show the SBS engine uptime in seconds");
 			Report("vmuptime - show uptime of VM in seconds");
 			Report("profile [-a] - shows function-level profiling statistics");
+			Report("profile -e <filename> - exports recent profiling zones as a Chrome trace file");
 			Report("vminit - create and initialize a simulator engine");
 			Report("boot [engine_number] - start a simulator engine");
 			Report("pause [engine_number] - pause a simulator engine");